@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+/// Buffer size for for_each_dir_entry(); one getdents64 call returns thousands of entries
+constexpr size_t DIR_ENTRIES_BUFFER_SIZE = 256 * 1024;
+
+/**
+ * @brief Record layout returned by getdents64 (glibc has no wrapper before 2.30)
+ */
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+/**
+ * @brief Call on_entry(name, d_type) for every entry of an open directory, skipping "." and ".."
+ *
+ * Entries are read with raw getdents64 calls into the caller's buffer, so a
+ * large directory costs a handful of syscalls. on_batch() runs after each
+ * buffer has been handed out, which lets callers flush or process entries
+ * in groups while the directory is still being read.
+ *
+ * @param dirfd Directory opened with O_RDONLY | O_DIRECTORY
+ * @param buffer Scratch buffer, typically DIR_ENTRIES_BUFFER_SIZE bytes
+ * @param on_entry Called as on_entry(const char* name, unsigned char d_type)
+ * @param on_batch Called with no arguments after each getdents64 batch
+ * @return 0 on success, otherwise the errno of the failing getdents64 call
+ */
+template <typename OnEntry, typename OnBatch>
+int for_each_dir_entry(int dirfd, std::vector<char>& buffer, OnEntry&& on_entry, OnBatch&& on_batch) {
+    while (true) {
+        long n = ::syscall(SYS_getdents64, dirfd, buffer.data(), buffer.size());
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        if (n == 0) {
+            return 0;
+        }
+        for (long pos = 0; pos < n;) {
+            const auto* entry = reinterpret_cast<const LinuxDirent64*>(buffer.data() + pos);
+            pos += entry->d_reclen;
+            const char* name = entry->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+            on_entry(name, entry->d_type);
+        }
+        on_batch();
+    }
+}
+
+/**
+ * @brief for_each_dir_entry() without a per-batch callback
+ */
+template <typename OnEntry>
+int for_each_dir_entry(int dirfd, std::vector<char>& buffer, OnEntry&& on_entry) {
+    return for_each_dir_entry(dirfd, buffer, on_entry, [] {});
+}
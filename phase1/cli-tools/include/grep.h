@@ -1,5 +1,7 @@
 #pragma once
 
+#include "multi_matcher.h"
+#include <cstddef>
 #include <filesystem>
 #include <iosfwd>
 #include <string>
@@ -30,3 +32,100 @@ bool grep_file(const std::string& pattern, const std::filesystem::path& filepath
  */
 bool grep_text(const std::string& pattern, const std::string& text, 
                std::ostream& out, bool show_line_numbers = false);
+
+/**
+ * @brief Search for matching lines in an in-memory buffer
+ *
+ * The whole buffer is scanned with the vectorized substring kernel and line
+ * boundaries are only located around the matches, so non-matching lines are
+ * never copied. Output is identical to grep_text() on the same bytes.
+ *
+ * @param pattern Search pattern
+ * @param data Start of the buffer
+ * @param size Length of the buffer in bytes
+ * @param out Output stream
+ * @param show_line_numbers Whether to show line numbers
+ * @return true Search successful
+ * @return false Search failed
+ */
+bool grep_buffer(const std::string& pattern, const char* data, size_t size,
+                 std::ostream& out, bool show_line_numbers = false);
+
+/**
+ * @brief Search for matching lines in a file using a memory mapping
+ *
+ * Same output as grep_file(), but the file is mapped with mmap and searched
+ * by grep_buffer() instead of being read line by line. Inputs that cannot be
+ * mapped (pipes, FIFOs such as <(cmd), character devices) are read in
+ * blocks and searched with the same kernels.
+ *
+ * @param pattern Search pattern
+ * @param filepath File path
+ * @param out Output stream
+ * @param show_line_numbers Whether to show line numbers
+ * @return true Search successful
+ * @return false Search failed (e.g., file does not exist)
+ */
+bool grep_file_mmap(const std::string& pattern, const std::filesystem::path& filepath,
+                    std::ostream& out, bool show_line_numbers = false);
+
+/**
+ * @brief Default size of the newline-aligned chunks used by grep_files_parallel
+ */
+constexpr size_t DEFAULT_GREP_CHUNK_SIZE = 8 * 1024 * 1024;
+
+/**
+ * @brief Search several files in parallel
+ *
+ * Every file is memory-mapped (inputs that cannot be mapped, such as pipes,
+ * are read into memory) and split into newline-aligned chunks of about
+ * chunk_size bytes; the chunks of all files are searched on a worker pool.
+ * Results are written in input order (file by file, chunk by chunk), and line
+ * numbers are recovered from the newline count of the preceding chunks, so
+ * for a single file the output is identical to grep_file().
+ *
+ * When more than one file is given, every output line is prefixed with the
+ * file path followed by ':' (as grep does). A file that cannot be opened
+ * produces an error message at its position in the output and does not stop
+ * the search of the remaining files.
+ *
+ * @param pattern Search pattern
+ * @param files Files to search, in output order
+ * @param out Output stream
+ * @param show_line_numbers Whether to show line numbers
+ * @param num_threads Number of worker threads (0 = hardware concurrency)
+ * @param chunk_size Target chunk size in bytes
+ * @return true All files searched successfully
+ * @return false At least one file could not be searched
+ */
+bool grep_files_parallel(const std::string& pattern,
+                         const std::vector<std::filesystem::path>& files,
+                         std::ostream& out, bool show_line_numbers = false,
+                         size_t num_threads = 0,
+                         size_t chunk_size = DEFAULT_GREP_CHUNK_SIZE);
+
+/**
+ * @brief grep_buffer() for a compiled set of patterns
+ *
+ * A line is printed if any pattern of the matcher matches it; the buffer is
+ * scanned once regardless of the number of patterns.
+ */
+bool grep_buffer(const MultiPatternMatcher& matcher, const char* data, size_t size,
+                 std::ostream& out, bool show_line_numbers = false);
+
+/**
+ * @brief grep_file_mmap() for a compiled set of patterns
+ */
+bool grep_file_mmap(const MultiPatternMatcher& matcher, const std::filesystem::path& filepath,
+                    std::ostream& out, bool show_line_numbers = false);
+
+/**
+ * @brief grep_files_parallel() for a compiled set of patterns
+ *
+ * The matcher is built once by the caller and shared read-only by all workers.
+ */
+bool grep_files_parallel(const MultiPatternMatcher& matcher,
+                         const std::vector<std::filesystem::path>& files,
+                         std::ostream& out, bool show_line_numbers = false,
+                         size_t num_threads = 0,
+                         size_t chunk_size = DEFAULT_GREP_CHUNK_SIZE);
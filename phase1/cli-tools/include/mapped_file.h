@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * The mapping is released when the object is destroyed. An empty file is
+ * opened successfully but has no mapping: data() returns nullptr and size()
+ * returns 0.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Map a file into memory
+     *
+     * @param filepath File path
+     * @param error Set to a human readable reason when mapping fails
+     * @return true Mapping successful
+     * @return false Mapping failed (e.g., file cannot be opened)
+     */
+    bool open(const std::filesystem::path& filepath, std::string& error);
+
+    /**
+     * @brief Unmap the file, if mapped
+     */
+    void close();
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Compiled matcher for a set of patterns, scanned in a single pass
+ *
+ * The patterns are compiled once into a deterministic automaton with a dense,
+ * byte-class compressed transition table. Literal sets are compiled with the
+ * Aho-Corasick construction; regular expressions go through a Thompson NFA and
+ * subset construction. Either way, a search costs one table lookup per input
+ * byte no matter how many patterns there are, and the same matcher can be
+ * reused for any number of buffers and files (it is immutable after
+ * construction and safe to share between threads).
+ *
+ * Supported regex syntax (POSIX ERE subset, byte oriented):
+ *   - literals, '.' (any byte but newline), '\\' escapes of metacharacters
+ *   - bracket expressions "[abc]", "[a-z]", "[^0-9]"
+ *   - shorthand classes \\d \\D \\w \\W \\s \\S
+ *   - grouping "( )", alternation '|', quantifiers '*', '+', '?'
+ *   - anchors '^' (start of line) and '$' (end of line)
+ */
+class MultiPatternMatcher {
+public:
+    /**
+     * @brief Construct a matcher with no patterns; it matches no line
+     */
+    MultiPatternMatcher() = default;
+
+    /**
+     * @brief Compile a set of fixed strings (Aho-Corasick)
+     *
+     * A line matches if it contains any of the patterns. An empty pattern
+     * matches every line; patterns containing '\n' never match.
+     *
+     * @param patterns Literal patterns
+     * @return The compiled matcher
+     */
+    static MultiPatternMatcher from_literals(const std::vector<std::string>& patterns);
+
+    /**
+     * @brief Compile a set of regular expressions into one DFA
+     *
+     * A line matches if any of the expressions matches somewhere in it.
+     *
+     * @param patterns Regular expressions
+     * @return The compiled matcher
+     * @throws std::invalid_argument on a syntax error, or if the DFA would
+     *         exceed MAX_DFA_STATES states
+     */
+    static MultiPatternMatcher from_regex(const std::vector<std::string>& patterns);
+
+    /**
+     * @brief Find the first matching line in a buffer
+     *
+     * @param begin Start of the buffer; must be the start of a line
+     * @param end End of the buffer
+     * @param line_start Set to the start of the matching line
+     * @param line_end Set to the end of the matching line (its '\n' or end)
+     * @return true A matching line was found
+     * @return false No line in the buffer matches
+     */
+    bool find_line(const char* begin, const char* end,
+                   const char*& line_start, const char*& line_end) const;
+
+    /**
+     * @brief Check whether a single line (without '\n') matches
+     */
+    bool matches(std::string_view line) const;
+
+    /**
+     * @brief Number of automaton states
+     */
+    size_t state_count() const { return state_count_; }
+
+    /// Upper bound on DFA states produced by from_regex()
+    static constexpr size_t MAX_DFA_STATES = 10000;
+
+private:
+    /**
+     * @brief Build the scanning table from a DFA over byte classes
+     *
+     * States are renumbered so that every state that ends the per-byte fast
+     * path (accepting states and the two newline pseudo-states) has an index
+     * of at least first_special_, and are stored premultiplied by the row
+     * width, so the hot loop is one load and one compare per byte.
+     */
+    void finalize(const std::array<uint16_t, 256>& byte_class, size_t num_classes,
+                  const std::vector<uint32_t>& transitions, const std::vector<uint8_t>& accepting,
+                  const std::vector<uint8_t>& accepts_at_eol, uint32_t line_start_state);
+
+    std::array<uint16_t, 256> byte_class_{};  ///< Input byte -> column; '\n' has its own column
+    size_t num_columns_ = 1;                  ///< Columns per row of table_
+    size_t newline_column_ = 0;               ///< Column of '\n'
+    std::vector<uint32_t> table_{0};          ///< Row offset + column -> next row offset
+    uint32_t first_special_ = UINT32_MAX;     ///< Row offsets >= this leave the fast path
+    uint32_t line_start_ = 0;                 ///< Row offset at the start of every line
+    uint32_t newline_reset_ = UINT32_MAX;     ///< Pseudo-state: line ended without a match
+    uint32_t newline_accept_ = UINT32_MAX;    ///< Pseudo-state: line ended with a match
+    bool line_start_accepts_ = false;         ///< Every line matches (e.g. empty pattern)
+    size_t state_count_ = 1;                  ///< Number of real DFA states
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Find the first occurrence of a substring in a buffer
+ *
+ * Uses a vectorized first-byte/last-byte filter (SSE2, or AVX2 when the CPU
+ * supports it) and only verifies the candidate positions with memcmp.
+ *
+ * @param haystack Start of the buffer to search
+ * @param haystack_len Length of the buffer in bytes
+ * @param needle Substring to look for
+ * @return Pointer to the first match, or nullptr if there is none.
+ *         An empty needle matches at the start of the buffer.
+ */
+const char* find_substring(const char* haystack, size_t haystack_len, std::string_view needle);
+
+/**
+ * @brief Count the '\n' bytes in a buffer
+ *
+ * @param data Start of the buffer
+ * @param len Length of the buffer in bytes
+ * @return Number of newline bytes
+ */
+size_t count_newlines(const char* data, size_t len);
+
+/**
+ * @brief Line and word counts of a buffer, as produced by count_lines_and_words()
+ */
+struct LineWordCounts {
+    uint64_t newlines = 0;     ///< Number of '\n' bytes
+    uint64_t word_starts = 0;  ///< Non-whitespace bytes that follow whitespace
+};
+
+/**
+ * @brief Count newlines and word starts in a buffer in a single pass
+ *
+ * Whitespace is the "C" locale isspace() set (' ', '\t', '\n', '\v', '\f',
+ * '\r'), so the number of word starts equals the number of words that
+ * operator>> would extract. Buffers can be processed piecewise by passing
+ * whether the byte preceding each piece was whitespace.
+ *
+ * @param data Start of the buffer
+ * @param len Length of the buffer in bytes
+ * @param prev_is_space Whether the byte before data was whitespace (true at
+ *        the start of the input)
+ * @return Newline and word start counts
+ */
+LineWordCounts count_lines_and_words(const char* data, size_t len, bool prev_is_space);
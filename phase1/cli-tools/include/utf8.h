@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Decoder state carried between pieces of a UTF-8 stream
+ *
+ * Follows the WHATWG UTF-8 decoder: a sequence that is cut short or contains
+ * an unexpected byte is one error (its "maximal subpart"), and decoding
+ * resumes at the offending byte.
+ */
+struct Utf8State {
+    uint8_t bytes_needed = 0;  ///< Continuation bytes still expected
+    uint8_t bytes_seen = 0;    ///< Continuation bytes consumed so far
+    uint8_t lower = 0x80;      ///< Lowest acceptable next continuation byte
+    uint8_t upper = 0xBF;      ///< Highest acceptable next continuation byte
+};
+
+/**
+ * @brief Code point and error counts of a UTF-8 buffer
+ */
+struct Utf8Counts {
+    uint64_t code_points = 0;  ///< Correctly encoded code points
+    uint64_t invalid = 0;      ///< Invalid or truncated sequences
+};
+
+/**
+ * @brief Validate a piece of UTF-8 text and count its code points
+ *
+ * Runs of input are validated 32 bytes at a time with the lookup-table
+ * algorithm of Keiser and Lemire (AVX2, when the CPU supports it) and their
+ * code points are counted as the non-continuation bytes; all-ASCII blocks
+ * take a shortcut. Only runs that fail validation, and the few bytes around
+ * piece boundaries, go through the scalar decoder, which gives the exact
+ * error count. The result is the same for any split of the input.
+ *
+ * @param data Start of the piece
+ * @param len Length of the piece in bytes
+ * @param state Decoder state, updated for the next piece
+ * @return Counts for the code points completed within this piece
+ */
+Utf8Counts count_utf8(const char* data, size_t len, Utf8State& state);
+
+/**
+ * @brief Finish decoding: count a sequence left open at the end of the input
+ *
+ * @param state Decoder state after the last piece; reset on return
+ * @return Counts with invalid = 1 if a sequence was truncated, else zero
+ */
+Utf8Counts finish_utf8(Utf8State& state);
@@ -1,16 +1,102 @@
 #pragma once
 
+#include "utf8.h"
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <iosfwd>
+#include <string>
+#include <vector>
 
 /**
  * @brief Structure to hold the results of word count operations
+ *
+ * A result also describes the boundary of the input it was computed from,
+ * which makes results of adjacent pieces of one input mergeable with
+ * wc_merge(): a word cut in two by the split is counted once, and so is a
+ * line. The empty result (all zeros, success) is the identity.
+ *
+ * characters counts bytes. code_points and invalid_utf8 are only filled in
+ * when code point counting is requested (wc -m).
  */
 struct WcResult {
-    int lines = 0;
-    int words = 0;
-    int characters = 0;
+    uint64_t lines = 0;
+    uint64_t words = 0;
+    uint64_t characters = 0;
     bool success = true;  // Indicates if the operation was successful
+    bool starts_in_word = false;     // First byte is not whitespace
+    bool ends_in_word = false;       // Last byte is not whitespace
+    bool ends_with_newline = false;  // Last byte is '\n'
+    uint64_t code_points = 0;        // Correctly encoded UTF-8 code points
+    uint64_t invalid_utf8 = 0;       // Invalid or truncated UTF-8 sequences
+};
+
+/**
+ * @brief Combine the results of two adjacent pieces of the same input
+ *
+ * The operation is associative, so pieces can be merged in any grouping as
+ * long as their order is kept. The counts are identical to counting the
+ * concatenated input in one go. Code point counts are exact as long as the
+ * split does not fall inside a UTF-8 sequence.
+ *
+ * @param front Result for the earlier piece
+ * @param back Result for the piece that immediately follows it
+ * @return WcResult Result for front followed by back
+ */
+WcResult wc_merge(const WcResult& front, const WcResult& back);
+
+/**
+ * @brief Default number of bytes per chunk for wc_parallel()
+ */
+constexpr size_t DEFAULT_WC_CHUNK_SIZE = 16 * 1024 * 1024;
+
+/**
+ * @brief Size of the read buffer used when counting files and streams
+ */
+constexpr size_t WC_BUFFER_SIZE = 256 * 1024;
+
+/**
+ * @brief Incremental line/word/byte counter
+ *
+ * Feed the input in pieces of any size with update(); the counts are the same
+ * as for the concatenated input. Uses the vectorized count_lines_and_words()
+ * kernel, one pass per piece, plus the count_utf8() validator when code
+ * points are counted.
+ */
+class WcCounter {
+public:
+    /**
+     * @brief Create a counter
+     *
+     * @param count_code_points Also validate the input as UTF-8 and count
+     *        its code points
+     */
+    explicit WcCounter(bool count_code_points = false) : count_code_points_(count_code_points) {}
+
+    /**
+     * @brief Count the next piece of the input
+     *
+     * @param data Start of the piece
+     * @param size Length of the piece in bytes
+     */
+    void update(const char* data, size_t size);
+
+    /**
+     * @brief Counts for everything passed to update() so far
+     */
+    WcResult result() const;
+
+private:
+    uint64_t bytes_ = 0;
+    uint64_t newlines_ = 0;
+    uint64_t words_ = 0;
+    bool prev_is_space_ = true;   // Whitespace state of the last byte seen
+    bool starts_in_word_ = false;
+    bool ends_with_newline_ = false;
+    bool count_code_points_ = false;
+    uint64_t code_points_ = 0;
+    uint64_t invalid_utf8_ = 0;
+    Utf8State utf8_state_;
 };
 
 /**
@@ -18,14 +104,54 @@ struct WcResult {
  * 
  * @param filepath Path to the file to count
  * @param out Output stream for error messages
+ * @param count_code_points Also count UTF-8 code points and invalid sequences
  * @return WcResult Structure containing the counts, or zeros if an error occurred
  */
-WcResult wc_file(const std::filesystem::path& filepath, std::ostream& out);
+WcResult wc_file(const std::filesystem::path& filepath, std::ostream& out,
+                 bool count_code_points = false);
+
+/**
+ * @brief Count lines, words, and characters read from a file descriptor
+ *
+ * Reads through a fixed WC_BUFFER_SIZE buffer, so memory use does not depend
+ * on the input size. The descriptor is not closed.
+ *
+ * @param fd File descriptor to read until end of file
+ * @param out Output stream for error messages
+ * @param count_code_points Also count UTF-8 code points and invalid sequences
+ * @return WcResult Structure containing the counts, or zeros if a read failed
+ */
+WcResult wc_fd(int fd, std::ostream& out, bool count_code_points = false);
 
 /**
  * @brief Count lines, words, and characters in text
  * 
  * @param text Input text to count
+ * @param count_code_points Also count UTF-8 code points and invalid sequences
  * @return WcResult Structure containing the counts
  */
-WcResult wc_text(const std::string& text);
+WcResult wc_text(const std::string& text, bool count_code_points = false);
+
+/**
+ * @brief Count several files concurrently, splitting large files into chunks
+ *
+ * Every regular file is cut into chunks of chunk_size bytes that are counted
+ * on a pool of worker threads with pread() into a fixed buffer, and the
+ * partial results are combined with wc_merge(). Chunk boundaries are moved
+ * past continuation bytes so no UTF-8 sequence is split. Files that cannot be split
+ * (pipes, character devices) are counted by one worker. A file is opened
+ * by the worker counting one of its chunks and closed when that chunk is
+ * done, so at most one descriptor per worker is open at any time. The
+ * results are identical to wc_file().
+ *
+ * @param files Files to count
+ * @param out Output stream for error messages, written in input order
+ * @param num_threads Number of worker threads (0 = hardware concurrency)
+ * @param chunk_size Bytes per chunk (0 = DEFAULT_WC_CHUNK_SIZE)
+ * @param count_code_points Also count UTF-8 code points and invalid sequences
+ * @return One WcResult per file, in input order; failed files have
+ *         success == false and zero counts
+ */
+std::vector<WcResult> wc_parallel(const std::vector<std::filesystem::path>& files, std::ostream& out,
+                                  size_t num_threads = 0, size_t chunk_size = DEFAULT_WC_CHUNK_SIZE,
+                                  bool count_code_points = false);
@@ -0,0 +1,183 @@
+/*
+ * grep_bench: Throughput benchmark for the grep search paths.
+ *
+ * Generates a synthetic log file (1 GB by default) and times the line-by-line
+ * grep_file(), grep_text() on the file loaded into memory, the mmap +
+ * vectorized grep_file_mmap() and the chunked grep_files_parallel(). Output
+ * is discarded into a checksumming sink so that all paths can be checked for
+ * identical results.
+ *
+ * How to Compile without Docker (from project root):
+ *   1. cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+ *   2. cmake --build build --target grep_bench -- -j
+ *
+ * How to Run without Docker:
+ *   ./build/phase1/cli-tools/grep_bench [size_mb] [pattern]
+ *
+ * Usage Examples:
+ *   - Default run (1024 MB log, pattern "connection reset"):
+ *     ./build/phase1/cli-tools/grep_bench
+ *
+ *   - Smaller log and a custom pattern:
+ *     ./build/phase1/cli-tools/grep_bench 256 "status=503"
+ *
+ * The generated log is kept in the system temp directory and reused by later
+ * runs of the same size.
+ */
+
+#include "grep.h"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+namespace {
+
+// Stream buffer that discards output but keeps a byte count and FNV-1a checksum
+class ChecksumBuf : public std::streambuf {
+public:
+    uint64_t bytes = 0;
+    uint64_t hash = 14695981039346656037ull;
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (ch != traits_type::eof()) {
+            mix(static_cast<char>(ch));
+        }
+        return ch;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        for (std::streamsize i = 0; i < n; ++i) {
+            mix(s[i]);
+        }
+        return n;
+    }
+
+private:
+    void mix(char c) {
+        ++bytes;
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+};
+
+// Write a synthetic log of roughly target_bytes; about one line in 1000 is an error
+void generate_log(const std::filesystem::path& path, uint64_t target_bytes) {
+    static const char* const levels[] = {"INFO", "DEBUG", "INFO", "WARN"};
+    static const char* const paths[] = {"/api/v1/users", "/api/v1/orders", "/healthz", "/static/app.js"};
+
+    std::ofstream file(path, std::ios::binary);
+    std::string line;
+    uint64_t written = 0;
+    uint64_t seq = 0;
+    while (written < target_bytes) {
+        line.clear();
+        line += "2024-05-01T12:";
+        line += std::to_string(10 + seq % 50);
+        line += ":00.000Z ";
+        if (seq % 1000 == 999) {
+            line += "ERROR [worker-";
+            line += std::to_string(seq % 16);
+            line += "] upstream connection reset by peer request_id=";
+        } else {
+            line += levels[seq % 4];
+            line += " [worker-";
+            line += std::to_string(seq % 16);
+            line += "] GET ";
+            line += paths[seq % 4];
+            line += " status=200 latency_ms=";
+            line += std::to_string(seq % 97);
+            line += " request_id=";
+        }
+        line += std::to_string(seq * 2654435761u);
+        line += '\n';
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+        written += line.size();
+        ++seq;
+    }
+}
+
+struct BenchResult {
+    double seconds;
+    uint64_t bytes;
+    uint64_t hash;
+};
+
+BenchResult run(const std::function<bool(std::ostream&)>& search) {
+    ChecksumBuf buf;
+    std::ostream sink(&buf);
+    auto start = std::chrono::steady_clock::now();
+    search(sink);
+    auto end = std::chrono::steady_clock::now();
+    return {std::chrono::duration<double>(end - start).count(), buf.bytes, buf.hash};
+}
+
+void report(const std::string& name, const BenchResult& result, uint64_t input_bytes,
+            const BenchResult& baseline) {
+    double mb = static_cast<double>(input_bytes) / (1024.0 * 1024.0);
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(10) << result.seconds << " s"
+              << std::setprecision(1) << std::setw(10) << mb / result.seconds << " MB/s"
+              << std::setw(8) << baseline.seconds / result.seconds << "x"
+              << "  output=" << result.bytes << " bytes"
+              << (result.hash == baseline.hash ? "" : "  [OUTPUT MISMATCH]") << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t size_mb = 1024;
+    std::string pattern = "connection reset";
+    if (argc > 1) {
+        size_mb = std::stoull(argv[1]);
+    }
+    if (argc > 2) {
+        pattern = argv[2];
+    }
+
+    const uint64_t target_bytes = size_mb * 1024 * 1024;
+    const std::filesystem::path log_path =
+        std::filesystem::temp_directory_path() / ("grep_bench_" + std::to_string(size_mb) + "mb.log");
+
+    if (!std::filesystem::exists(log_path) || std::filesystem::file_size(log_path) < target_bytes) {
+        std::cout << "Generating " << size_mb << " MB synthetic log at " << log_path << " ..." << std::endl;
+        generate_log(log_path, target_bytes);
+    }
+    const uint64_t input_bytes = std::filesystem::file_size(log_path);
+
+    std::cout << "Pattern: \"" << pattern << "\", input: " << input_bytes << " bytes" << std::endl;
+
+    BenchResult baseline = run([&](std::ostream& out) {
+        return grep_file(pattern, log_path, out, true);
+    });
+    report("grep_file (getline)", baseline, input_bytes, baseline);
+
+    {
+        // grep_text needs the whole file in a std::string; loading it is not timed
+        std::ifstream file(log_path, std::ios::binary);
+        std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        BenchResult text_result = run([&](std::ostream& out) {
+            return grep_text(pattern, text, out, true);
+        });
+        report("grep_text (in memory)", text_result, input_bytes, baseline);
+    }
+
+    BenchResult mmap_result = run([&](std::ostream& out) {
+        return grep_file_mmap(pattern, log_path, out, true);
+    });
+    report("grep_file_mmap (simd)", mmap_result, input_bytes, baseline);
+
+    BenchResult parallel_result = run([&](std::ostream& out) {
+        return grep_files_parallel(pattern, {log_path}, out, true);
+    });
+    report("grep_files_parallel", parallel_result, input_bytes, baseline);
+
+    return 0;
+}
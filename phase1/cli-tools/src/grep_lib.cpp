@@ -22,12 +22,146 @@
  */
 
 #include "grep.h"
+#include "mapped_file.h"
+#include "simd_search.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <future>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <vector>
 #include <sstream>
 
+namespace {
+
+/**
+ * @brief Invoke on_match(line_start, line_end, line_index) for every matching
+ * line of the buffer
+ *
+ * find_line(scan, end, line_start, line_end) locates the next matching line
+ * at or after scan, which is always the start of a line. line_index is the
+ * 0-based index of the line within the buffer and is only maintained when
+ * track_lines is set.
+ *
+ * @return Number of '\n' bytes in the buffer when track_lines is set, else 0
+ */
+template <typename FindLine, typename OnMatch>
+size_t for_each_matching_line(const char* data, size_t size, bool track_lines,
+                              FindLine&& find_line, OnMatch&& on_match) {
+    if (size == 0) {
+        return 0;
+    }
+
+    const char* const end = data + size;
+    const char* scan = data;          // Always positioned at the start of a line
+    const char* counted_to = data;    // Newlines before this point are in line_index
+    size_t line_index = 0;
+
+    const char* line_start;
+    const char* line_end;
+    while (scan < end && find_line(scan, end, line_start, line_end)) {
+        if (track_lines) {
+            line_index += count_newlines(counted_to, line_start - counted_to);
+            counted_to = line_start;
+        }
+        on_match(line_start, line_end, line_index);
+
+        scan = line_end + 1;
+    }
+
+    if (track_lines) {
+        line_index += count_newlines(counted_to, end - counted_to);
+    }
+    return track_lines ? line_index : 0;
+}
+
+/**
+ * @brief Line finder for a single fixed string
+ *
+ * The buffer is scanned with find_substring() and line boundaries are only
+ * located around the hits.
+ */
+class LiteralLineFinder {
+public:
+    explicit LiteralLineFinder(const std::string& pattern)
+        : pattern_(pattern),
+          // Lines never contain '\n', so such a pattern cannot match any line
+          can_match_(pattern.find('\n') == std::string::npos) {}
+
+    bool operator()(const char* scan, const char* end,
+                    const char*& line_start, const char*& line_end) const {
+        if (!can_match_) {
+            return false;
+        }
+        const char* hit = find_substring(scan, end - scan, pattern_);
+        if (!hit) {
+            return false;
+        }
+
+        // Locate the boundaries of the line containing the match
+        line_start = static_cast<const char*>(memrchr(scan, '\n', hit - scan));
+        line_start = line_start ? line_start + 1 : scan;
+        line_end = static_cast<const char*>(std::memchr(hit, '\n', end - hit));
+        if (!line_end) {
+            line_end = end;
+        }
+        return true;
+    }
+
+private:
+    const std::string& pattern_;
+    bool can_match_;
+};
+
+/**
+ * @brief Line finder backed by a compiled MultiPatternMatcher
+ */
+class MatcherLineFinder {
+public:
+    explicit MatcherLineFinder(const MultiPatternMatcher& matcher) : matcher_(matcher) {}
+
+    bool operator()(const char* scan, const char* end,
+                    const char*& line_start, const char*& line_end) const {
+        return matcher_.find_line(scan, end, line_start, line_end);
+    }
+
+private:
+    const MultiPatternMatcher& matcher_;
+};
+
+/**
+ * @brief A matching line found by a chunk task
+ */
+struct ChunkMatch {
+    size_t line_index;   ///< 0-based line index relative to the chunk start
+    const char* begin;   ///< Start of the line inside the mapping
+    size_t length;       ///< Line length without the trailing newline
+};
+
+/**
+ * @brief Result of searching one newline-aligned chunk
+ */
+struct ChunkResult {
+    std::vector<ChunkMatch> matches;
+    size_t newlines = 0;  ///< Newlines in the chunk, used to rebase later chunks
+};
+
+/**
+ * @brief A mapped input file together with its chunk results
+ */
+struct FileJob {
+    std::filesystem::path path;
+    MappedFile file;
+    std::string contents;  ///< Whole input of a file that cannot be mapped (pipe, FIFO, ...)
+    std::string error;
+    bool missing = false;
+    std::vector<std::future<ChunkResult>> chunks;
+};
+
+} // anonymous namespace
+
 bool grep_file(const std::string& pattern, const std::filesystem::path& filepath, 
                std::ostream& out, bool show_line_numbers) {
     // Check if file exists
@@ -55,7 +189,7 @@ bool grep_file(const std::string& pattern, const std::filesystem::path& filepath
             if (show_line_numbers) {
                 out << line_number << ":";
             }
-            out << line << std::endl;
+            out << line << '\n';
         }
     }
 
@@ -81,9 +215,246 @@ bool grep_text(const std::string& pattern, const std::string& text,
             if (show_line_numbers) {
                 out << line_number << ":";
             }
-            out << line << std::endl;
+            out << line << '\n';
         }
     }
 
     return true;
 }
+
+namespace {
+
+template <typename FindLine>
+bool grep_buffer_with(const FindLine& find_line, const char* data, size_t size,
+                      std::ostream& out, bool show_line_numbers) {
+    for_each_matching_line(data, size, show_line_numbers, find_line,
+                           [&](const char* line_start, const char* line_end, size_t line_index) {
+        if (show_line_numbers) {
+            out << line_index + 1 << ":";
+        }
+        out.write(line_start, line_end - line_start);
+        out.put('\n');
+    });
+
+    return true;
+}
+
+/**
+ * @brief Whether a path names something that can be read but not mapped
+ *
+ * Pipes, FIFOs (e.g. from process substitution), sockets and character
+ * devices have no size to map; they are read as a stream instead.
+ */
+bool is_stream_file(const std::filesystem::path& filepath) {
+    std::error_code ec;
+    const std::filesystem::file_status status = std::filesystem::status(filepath, ec);
+    return !ec && (std::filesystem::is_fifo(status) || std::filesystem::is_character_file(status) ||
+                   std::filesystem::is_socket(status));
+}
+
+/**
+ * @brief Search an input stream block by block
+ *
+ * Complete lines of every block are searched with the same kernels as a
+ * mapping; a partial last line is carried over to the next block.
+ */
+template <typename FindLine>
+bool grep_stream_with(const FindLine& find_line, std::istream& in,
+                      std::ostream& out, bool show_line_numbers) {
+    constexpr size_t kBlockSize = 64 * 1024;
+    std::vector<char> block(kBlockSize);
+    std::string pending;
+    size_t line_base = 0;
+
+    auto search = [&](const char* data, size_t size) {
+        line_base += for_each_matching_line(data, size, show_line_numbers, find_line,
+                                            [&](const char* line_start, const char* line_end, size_t line_index) {
+            if (show_line_numbers) {
+                out << line_base + line_index + 1 << ":";
+            }
+            out.write(line_start, line_end - line_start);
+            out.put('\n');
+        });
+    };
+
+    while (in.read(block.data(), block.size()) || in.gcount() > 0) {
+        pending.append(block.data(), static_cast<size_t>(in.gcount()));
+        const size_t last_newline = pending.rfind('\n');
+        if (last_newline == std::string::npos) {
+            continue;
+        }
+        search(pending.data(), last_newline + 1);
+        pending.erase(0, last_newline + 1);
+    }
+    search(pending.data(), pending.size());
+
+    return !in.bad();
+}
+
+template <typename FindLine>
+bool grep_file_mmap_with(const FindLine& find_line, const std::filesystem::path& filepath,
+                         std::ostream& out, bool show_line_numbers) {
+    // Check if file exists
+    if (!std::filesystem::exists(filepath)) {
+        out << "Error: File does not exist: " << filepath << std::endl;
+        return false;
+    }
+
+    if (is_stream_file(filepath)) {
+        std::ifstream stream(filepath, std::ios::binary);
+        if (!stream.is_open()) {
+            out << "Error: Could not open file: " << filepath << std::endl;
+            return false;
+        }
+        return grep_stream_with(find_line, stream, out, show_line_numbers);
+    }
+
+    MappedFile file;
+    std::string error;
+    if (!file.open(filepath, error)) {
+        out << "Error: Could not open file: " << filepath << " (" << error << ")" << std::endl;
+        return false;
+    }
+
+    return grep_buffer_with(find_line, file.data(), file.size(), out, show_line_numbers);
+}
+
+template <typename FindLine>
+bool grep_files_parallel_with(const FindLine& find_line,
+                              const std::vector<std::filesystem::path>& files,
+                              std::ostream& out, bool show_line_numbers,
+                              size_t num_threads, size_t chunk_size) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (chunk_size == 0) {
+        chunk_size = DEFAULT_GREP_CHUNK_SIZE;
+    }
+
+    std::vector<FileJob> jobs(files.size());
+    cli_tools::ThreadPool pool(num_threads);
+
+    // Map every file and enqueue its chunks; the pool starts working while
+    // later files are still being mapped
+    for (size_t i = 0; i < files.size(); ++i) {
+        FileJob& job = jobs[i];
+        job.path = files[i];
+        if (!std::filesystem::exists(job.path)) {
+            job.missing = true;
+            continue;
+        }
+        const char* data;
+        size_t size;
+        if (is_stream_file(job.path)) {
+            std::ifstream stream(job.path, std::ios::binary);
+            if (!stream.is_open()) {
+                job.error = "Could not read stream";
+                continue;
+            }
+            std::ostringstream contents;
+            contents << stream.rdbuf();
+            job.contents = std::move(contents).str();
+            data = job.contents.data();
+            size = job.contents.size();
+        } else {
+            if (!job.file.open(job.path, job.error)) {
+                continue;
+            }
+            data = job.file.data();
+            size = job.file.size();
+        }
+        size_t pos = 0;
+        while (pos < size) {
+            // Extend the chunk to the end of the line it stops in
+            size_t chunk_end = std::min(pos + chunk_size, size);
+            if (chunk_end < size) {
+                const void* nl = std::memchr(data + chunk_end - 1, '\n', size - chunk_end + 1);
+                chunk_end = nl ? static_cast<const char*>(nl) - data + 1 : size;
+            }
+
+            job.chunks.push_back(pool.Enqueue([&find_line, show_line_numbers, chunk = data + pos,
+                                               len = chunk_end - pos]() {
+                ChunkResult result;
+                result.newlines = for_each_matching_line(
+                    chunk, len, show_line_numbers, find_line,
+                    [&](const char* line_start, const char* line_end, size_t line_index) {
+                        result.matches.push_back({line_index, line_start,
+                                                  static_cast<size_t>(line_end - line_start)});
+                    });
+                return result;
+            }));
+            pos = chunk_end;
+        }
+    }
+
+    // Write results in input order as the chunks complete
+    const bool show_file_names = files.size() > 1;
+    bool success = true;
+    for (FileJob& job : jobs) {
+        if (job.missing) {
+            out << "Error: File does not exist: " << job.path << std::endl;
+            success = false;
+            continue;
+        }
+        if (!job.error.empty()) {
+            out << "Error: Could not open file: " << job.path << " (" << job.error << ")" << std::endl;
+            success = false;
+            continue;
+        }
+
+        const std::string prefix = show_file_names ? job.path.string() + ":" : std::string();
+        size_t line_base = 0;
+        for (auto& chunk : job.chunks) {
+            ChunkResult result = chunk.get();
+            for (const ChunkMatch& match : result.matches) {
+                out << prefix;
+                if (show_line_numbers) {
+                    out << line_base + match.line_index + 1 << ":";
+                }
+                out.write(match.begin, match.length);
+                out.put('\n');
+            }
+            line_base += result.newlines;
+        }
+    }
+
+    return success;
+}
+
+} // anonymous namespace
+
+bool grep_buffer(const std::string& pattern, const char* data, size_t size,
+                 std::ostream& out, bool show_line_numbers) {
+    return grep_buffer_with(LiteralLineFinder(pattern), data, size, out, show_line_numbers);
+}
+
+bool grep_buffer(const MultiPatternMatcher& matcher, const char* data, size_t size,
+                 std::ostream& out, bool show_line_numbers) {
+    return grep_buffer_with(MatcherLineFinder(matcher), data, size, out, show_line_numbers);
+}
+
+bool grep_file_mmap(const std::string& pattern, const std::filesystem::path& filepath,
+                    std::ostream& out, bool show_line_numbers) {
+    return grep_file_mmap_with(LiteralLineFinder(pattern), filepath, out, show_line_numbers);
+}
+
+bool grep_file_mmap(const MultiPatternMatcher& matcher, const std::filesystem::path& filepath,
+                    std::ostream& out, bool show_line_numbers) {
+    return grep_file_mmap_with(MatcherLineFinder(matcher), filepath, out, show_line_numbers);
+}
+
+bool grep_files_parallel(const std::string& pattern,
+                         const std::vector<std::filesystem::path>& files,
+                         std::ostream& out, bool show_line_numbers,
+                         size_t num_threads, size_t chunk_size) {
+    return grep_files_parallel_with(LiteralLineFinder(pattern), files, out, show_line_numbers,
+                                    num_threads, chunk_size);
+}
+
+bool grep_files_parallel(const MultiPatternMatcher& matcher,
+                         const std::vector<std::filesystem::path>& files,
+                         std::ostream& out, bool show_line_numbers,
+                         size_t num_threads, size_t chunk_size) {
+    return grep_files_parallel_with(MatcherLineFinder(matcher), files, out, show_line_numbers,
+                                    num_threads, chunk_size);
+}
@@ -2,7 +2,7 @@
  * my_grep: A simplified version of the 'grep' command.
  *
  * How to Run with Docker (builds and runs automatically):
- *   ./scripts/docker-dev.sh run-grep [-n] pattern file
+ *   ./scripts/docker-dev.sh run-grep [-n] [-E] [-j N] pattern file...
  *
  * How to Compile and Run manually in Docker:
  *   1. Enter the Docker container:
@@ -12,14 +12,14 @@
  *      cmake ..
  *      make
  *   3. Run the executable:
- *      ./phase1/cli-tools/my_grep [-n] pattern file
+ *      ./phase1/cli-tools/my_grep [-n] [-E] [-j N] pattern file...
  *
  * How to Compile without Docker (from project root):
  *   1. cmake -S . -B build
  *   2. cmake --build build -- -j
  *
  * How to Run without Docker:
- *   ./build/phase1/cli-tools/my_grep [-n] pattern file
+ *   ./build/phase1/cli-tools/my_grep [-n] [-E] [-j N] pattern file...
  *
  * Usage Examples:
  *   - Search for a pattern in a file:
@@ -27,6 +27,15 @@
  *
  *   - Search for a pattern in a file with line numbers:
  *     ./build/phase1/cli-tools/my_grep -n "pattern" file.txt
+ *
+ *   - Search many rotated logs on 8 threads (output stays in file order):
+ *     ./build/phase1/cli-tools/my_grep -j 8 -n "ERROR" app.log.*
+ *
+ *   - Search for a whole list of error signatures in one pass:
+ *     ./build/phase1/cli-tools/my_grep -f signatures.txt app.log
+ *
+ *   - Search with regular expressions:
+ *     ./build/phase1/cli-tools/my_grep -E -e "status=5[0-9][0-9]" -e "^FATAL" app.log
  * 
  * Debugging with VS Code Dev Container + CMake Tools:
  *   1. Install the "Dev Containers" and "CMake Tools" extensions in VS Code.
@@ -37,44 +46,119 @@
  */
 
 #include "grep.h"
+#include "multi_matcher.h"
+#include "output_writer.h"
 #include <iostream>
 #include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
 
 void print_usage(const char* program_name) {
-    std::cout << "Usage: " << program_name << " [-n] pattern file\n"
+    std::cout << "Usage: " << program_name << " [-n] [-E] [-j N] pattern file...\n"
+              << "       " << program_name << " [-n] [-E] [-j N] (-e pattern | -f patterns_file)... file...\n"
               << "  -n\tShow line numbers\n"
+              << "  -E\tTreat patterns as regular expressions\n"
+              << "  -e P\tAdd a pattern (may be repeated)\n"
+              << "  -f F\tAdd one pattern per line of file F\n"
+              << "  -j N\tSearch with N worker threads (0 = all cores)\n"
               << "  -h\tDisplay this help message\n";
 }
 
 int main(int argc, char* argv[]) {
     bool show_line_numbers = false;
-    int pattern_arg_index = 1;
-    int file_arg_index = 2;
+    bool use_regex = false;
+    size_t num_threads = 1;
+    std::vector<std::string> patterns;
+    std::vector<std::string> positional;
 
     // Parse command line arguments
-    if (argc > 1) {
-        std::string arg1 = argv[1];
-        if (arg1 == "-n") {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (!positional.empty()) {
+            // Everything after the first positional argument is a file name
+            positional.push_back(arg);
+        } else if (arg == "-n") {
             show_line_numbers = true;
-            pattern_arg_index = 2;
-            file_arg_index = 3;
-        } else if (arg1 == "-h" || arg1 == "--help") {
+        } else if (arg == "-E") {
+            use_regex = true;
+        } else if (arg == "-e" && i + 1 < argc) {
+            patterns.push_back(argv[++i]);
+        } else if (arg == "-f" && i + 1 < argc) {
+            std::ifstream pattern_file(argv[++i]);
+            if (!pattern_file.is_open()) {
+                std::cerr << "Error: Could not open pattern file: " << argv[i] << std::endl;
+                return 1;
+            }
+            std::string line;
+            while (std::getline(pattern_file, line)) {
+                patterns.push_back(line);
+            }
+        } else if (arg == "-j" && i + 1 < argc) {
+            try {
+                num_threads = std::stoul(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid thread count: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "-h" || arg == "--help") {
             print_usage(argv[0]);
             return 0;
+        } else {
+            positional.push_back(arg);
         }
     }
 
+    // Without -e/-f the first positional argument is the pattern
+    const bool patterns_from_options = !patterns.empty();
+    if (!patterns_from_options && !positional.empty()) {
+        patterns.push_back(positional.front());
+        positional.erase(positional.begin());
+    }
+
     // Check argument count
-    if (argc < (file_arg_index + 1)) {
-        std::cerr << "Usage: " << argv[0] << " [-n] pattern file" << std::endl;
+    if (patterns.empty() || positional.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [-n] [-E] [-j N] pattern file..." << std::endl;
         return 1;
     }
 
-    std::string pattern = argv[pattern_arg_index];
-    std::filesystem::path filepath = argv[file_arg_index];
+    std::vector<std::filesystem::path> files(positional.begin(), positional.end());
+
+    // Batch matches into large writes to stdout; flush per line only on a terminal
+    OutputWriter writer(STDOUT_FILENO, OutputWriter::default_policy_for(STDOUT_FILENO));
+    std::ostream& out = writer.stream();
 
-    // Call grep function
-    bool success = grep_file(pattern, filepath, std::cout, show_line_numbers);
+    bool success;
+    if (patterns.size() == 1 && !use_regex) {
+        if (files.size() == 1 && num_threads == 1) {
+            // Call grep function (memory-mapped, vectorized search path)
+            success = grep_file_mmap(patterns[0], files[0], out, show_line_numbers);
+        } else {
+            // Split files into chunks and search them on a worker pool
+            success = grep_files_parallel(patterns[0], files, out, show_line_numbers, num_threads);
+        }
+    } else {
+        // Compile all patterns once into a single automaton shared by every file
+        MultiPatternMatcher matcher;
+        try {
+            matcher = use_regex ? MultiPatternMatcher::from_regex(patterns)
+                                : MultiPatternMatcher::from_literals(patterns);
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 2;
+        }
+
+        if (files.size() == 1 && num_threads == 1) {
+            success = grep_file_mmap(matcher, files[0], out, show_line_numbers);
+        } else {
+            success = grep_files_parallel(matcher, files, out, show_line_numbers, num_threads);
+        }
+    }
 
+    if (!writer.flush()) {
+        return 2;
+    }
     return success ? 0 : 1;
 }
@@ -0,0 +1,194 @@
+/*
+ * grep_multi_bench: Throughput benchmark for multi-pattern grep.
+ *
+ * Builds an in-memory synthetic log and a set of N error signatures, then
+ * compares:
+ *   - N separate passes of the single-pattern SIMD search (one per signature)
+ *   - one pass of the Aho-Corasick matcher over all signatures
+ *   - one pass of the regex DFA built from the same signatures
+ *   - one pass of a regex DFA with character classes and anchors
+ * Matcher construction time is reported separately from scan time.
+ *
+ * How to Compile without Docker (from project root):
+ *   1. cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+ *   2. cmake --build build --target grep_multi_bench -- -j
+ *
+ * How to Run without Docker:
+ *   ./build/phase1/cli-tools/grep_multi_bench [size_mb] [num_patterns]
+ *
+ * Usage Examples:
+ *   - Default run (256 MB of log text, 32 signatures):
+ *     ./build/phase1/cli-tools/grep_multi_bench
+ *
+ *   - 1 GB of text and 100 signatures:
+ *     ./build/phase1/cli-tools/grep_multi_bench 1024 100
+ */
+
+#include "grep.h"
+#include "multi_matcher.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Stream buffer that discards output and counts lines written
+class LineCountBuf : public std::streambuf {
+public:
+    uint64_t lines = 0;
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (ch == '\n') {
+            ++lines;
+        }
+        return ch;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        for (std::streamsize i = 0; i < n; ++i) {
+            lines += s[i] == '\n';
+        }
+        return n;
+    }
+};
+
+std::string make_signature(size_t k) {
+    static const char* const kinds[] = {"timeout", "refused", "reset", "overflow", "denied"};
+    return "E" + std::to_string(1000 + k * 7) + "_" + kinds[k % 5];
+}
+
+// Synthetic log where roughly one line in 500 carries one of the signatures
+std::string generate_log(uint64_t target_bytes, size_t num_patterns) {
+    std::string text;
+    text.reserve(target_bytes + 256);
+    uint64_t seq = 0;
+    while (text.size() < target_bytes) {
+        text += "2024-05-01T12:00:00.000Z ";
+        if (seq % 500 == 499) {
+            text += "ERROR code=";
+            text += make_signature((seq / 500) % (num_patterns * 2));
+        } else {
+            text += "INFO GET /api/v1/items status=";
+            text += seq % 97 == 0 ? "503" : "200";
+            text += " latency_ms=";
+            text += std::to_string(seq % 89);
+        }
+        text += " request_id=";
+        text += std::to_string(seq * 2654435761u);
+        text += '\n';
+        ++seq;
+    }
+    return text;
+}
+
+// Escape regex metacharacters so a literal can be used as an expression
+std::string regex_escape(const std::string& literal) {
+    std::string escaped;
+    for (char c : literal) {
+        if (std::string("\\.^$|()[]*+?").find(c) != std::string::npos) {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+double time_seconds(const std::function<void()>& work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& name, double seconds, uint64_t input_bytes, uint64_t lines,
+            double baseline_seconds) {
+    double mb = static_cast<double>(input_bytes) / (1024.0 * 1024.0);
+    std::cout << std::left << std::setw(30) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(9) << seconds << " s"
+              << std::setprecision(1) << std::setw(10) << mb / seconds << " MB/s"
+              << std::setw(8) << baseline_seconds / seconds << "x"
+              << "  lines=" << lines << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t size_mb = 256;
+    size_t num_patterns = 32;
+    if (argc > 1) {
+        size_mb = std::stoull(argv[1]);
+    }
+    if (argc > 2) {
+        num_patterns = std::stoul(argv[2]);
+    }
+
+    std::vector<std::string> signatures;
+    for (size_t k = 0; k < num_patterns; ++k) {
+        signatures.push_back(make_signature(k));
+    }
+    std::vector<std::string> escaped;
+    for (const auto& signature : signatures) {
+        escaped.push_back(regex_escape(signature));
+    }
+
+    std::cout << "Generating " << size_mb << " MB of log text..." << std::endl;
+    const std::string text = generate_log(size_mb * 1024 * 1024, num_patterns);
+    std::cout << "Input: " << text.size() << " bytes, " << num_patterns << " patterns" << std::endl;
+
+    // N passes, one per signature
+    LineCountBuf naive_buf;
+    std::ostream naive_out(&naive_buf);
+    double naive_seconds = time_seconds([&] {
+        for (const auto& signature : signatures) {
+            grep_buffer(signature, text.data(), text.size(), naive_out);
+        }
+    });
+    report("N x single-pattern SIMD", naive_seconds, text.size(), naive_buf.lines, naive_seconds);
+
+    // Aho-Corasick over all signatures
+    MultiPatternMatcher literal_matcher;
+    double build_ac = time_seconds([&] { literal_matcher = MultiPatternMatcher::from_literals(signatures); });
+    LineCountBuf ac_buf;
+    std::ostream ac_out(&ac_buf);
+    double ac_seconds = time_seconds([&] {
+        grep_buffer(literal_matcher, text.data(), text.size(), ac_out);
+    });
+    report("Aho-Corasick (1 pass)", ac_seconds, text.size(), ac_buf.lines, naive_seconds);
+
+    // Regex DFA from the same signatures
+    MultiPatternMatcher regex_matcher;
+    double build_dfa = time_seconds([&] { regex_matcher = MultiPatternMatcher::from_regex(escaped); });
+    LineCountBuf dfa_buf;
+    std::ostream dfa_out(&dfa_buf);
+    double dfa_seconds = time_seconds([&] {
+        grep_buffer(regex_matcher, text.data(), text.size(), dfa_out);
+    });
+    report("Regex DFA, literals (1 pass)", dfa_seconds, text.size(), dfa_buf.lines, naive_seconds);
+
+    // Regex DFA with classes and anchors
+    MultiPatternMatcher class_matcher = MultiPatternMatcher::from_regex(
+        {"status=5[0-9][0-9]", "^[0-9-]+T[0-9:.]+Z ERROR code=E1[0-9]+_(timeout|reset)"});
+    LineCountBuf class_buf;
+    std::ostream class_out(&class_buf);
+    double class_seconds = time_seconds([&] {
+        grep_buffer(class_matcher, text.data(), text.size(), class_out);
+    });
+    report("Regex DFA, classes (1 pass)", class_seconds, text.size(), class_buf.lines, naive_seconds);
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "Build: Aho-Corasick " << build_ac * 1000 << " ms (" << literal_matcher.state_count()
+              << " states), regex DFA " << build_dfa * 1000 << " ms (" << regex_matcher.state_count()
+              << " states)" << std::endl;
+    if (ac_buf.lines != dfa_buf.lines) {
+        std::cout << "[RESULT MISMATCH] Aho-Corasick and regex DFA matched different line counts" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -28,7 +28,7 @@
 #include <algorithm>
 #include <stdexcept>
 
-bool list_directory(const std::filesystem::path& path, std::ostream& out) {
+bool list_directory(const std::filesystem::path& path, std::ostream& out, bool sorted) {
     try {
         if (!std::filesystem::exists(path)) {
             out << "Error: Path does not exist." << std::endl;
@@ -37,7 +37,7 @@ bool list_directory(const std::filesystem::path& path, std::ostream& out) {
 
         if (!std::filesystem::is_directory(path)) {
             // If it's a file, just print its name
-            out << path.filename().string() << std::endl;
+            out << path.filename().string() << '\n';
             return true;
         }
 
@@ -46,10 +46,12 @@ bool list_directory(const std::filesystem::path& path, std::ostream& out) {
             entries.push_back(entry.path().filename().string());
         }
 
-        std::sort(entries.begin(), entries.end());
+        if (sorted) {
+            std::sort(entries.begin(), entries.end());
+        }
 
         for (const auto& entry_name : entries) {
-            out << entry_name << std::endl;
+            out << entry_name << '\n';
         }
 
         return true;
@@ -2,7 +2,7 @@
  * my_ls: A simplified version of the 'ls' command.
  *
  * How to Run with Docker (builds and runs automatically):
- *   ./scripts/docker-dev.sh run-ls [path]
+ *   ./scripts/docker-dev.sh run-ls [options] [path]
  *
  * How to Compile and Run manually in Docker:
  *   1. Enter the Docker container:
@@ -12,14 +12,14 @@
  *      cmake ..
  *      make
  *   3. Run the executable:
- *      ./phase1/cli-tools/my_ls [path]
+ *      ./phase1/cli-tools/my_ls [options] [path]
  *
  * How to Compile without Docker (from project root):
  *   1. cmake -S . -B build
  *   2. cmake --build build -- -j
  *
  * How to Run without Docker:
- *   ./build/phase1/cli-tools/my_ls [path]
+ *   ./build/phase1/cli-tools/my_ls [options] [path]
  *
  * Usage Examples:
  *   - List contents of the current directory:
@@ -27,6 +27,12 @@
  *
  *   - List contents of a specific directory (e.g., 'phase1'):
  *     ./build/phase1/cli-tools/my_ls phase1
+ *
+ *   - List a whole tree on 8 threads, unsorted (streams as it walks):
+ *     ./build/phase1/cli-tools/my_ls -R -U -j 8 /usr
+ *
+ *   - Long format, largest files first, stat'ing on 4 threads:
+ *     ./build/phase1/cli-tools/my_ls -l -S -j 4 /usr/bin
  * 
  * Debugging with VS Code Dev Container + CMake Tools:
  *   1. Install the "Dev Containers" and "CMake Tools" extensions in VS Code.
@@ -37,22 +43,88 @@
  */
 
 #include "ls.h"
+#include "output_writer.h"
 #include <iostream>
 #include <filesystem>
+#include <string>
+#include <unistd.h>
+
+void print_usage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [-l] [-S | -t | -U] [-R] [-j N] [path]\n"
+              << "  -l\tLong format: mode, links, owner, group, size and modification time\n"
+              << "  -S\tSort by size, largest first\n"
+              << "  -t\tSort by modification time, newest first\n"
+              << "  -R\tList subdirectories recursively, one path per line (not with -l, -S, -t)\n"
+              << "  -U\tDo not sort; print entries as they are read\n"
+              << "  -j N\tUse N worker threads to walk (-R) or stat (-l, -S, -t) (0 = all cores)\n"
+              << "  -h\tDisplay this help message\n";
+}
 
 int main(int argc, char* argv[]) {
-    if (argc > 2) {
-        std::cerr << "Usage: " << argv[0] << " [path]" << std::endl;
+    bool recursive = false;
+    WalkOptions options;
+    ListOptions list_options;
+    std::filesystem::path current_path = ".";
+    bool have_path = false;
+
+    // Parse command line arguments
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-R") {
+            recursive = true;
+        } else if (arg == "-l") {
+            list_options.long_format = true;
+        } else if (arg == "-S") {
+            list_options.sort = SortOrder::Size;
+        } else if (arg == "-t") {
+            list_options.sort = SortOrder::Mtime;
+        } else if (arg == "-U") {
+            options.sorted = false;
+            list_options.sort = SortOrder::None;
+        } else if (arg == "-j" && i + 1 < argc) {
+            try {
+                options.num_threads = std::stoul(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid thread count: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!have_path) {
+            current_path = arg;
+            have_path = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [-l] [-S | -t | -U] [-R] [-j N] [path]" << std::endl;
+            return 1;
+        }
+    }
+
+    list_options.num_threads = options.num_threads;
+    // Plain listings need no metadata; -l, -S and -t stat every entry
+    const bool detailed = list_options.long_format || list_options.sort == SortOrder::Size ||
+                          list_options.sort == SortOrder::Mtime;
+    if (recursive && detailed) {
+        // The recursive walker prints paths only; refuse rather than silently drop -l/-S/-t
+        std::cerr << argv[0] << ": -R cannot be combined with -l, -S or -t" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " [-l] [-S | -t | -U] [-R] [-j N] [path]" << std::endl;
         return 1;
     }
 
-    std::filesystem::path current_path = ".";
-    if (argc == 2) {
-        current_path = argv[1];
+    // Batch entries into large writes to stdout; flush per line only on a terminal
+    OutputWriter writer(STDOUT_FILENO, OutputWriter::default_policy_for(STDOUT_FILENO));
+    bool success;
+    if (recursive) {
+        success = walk_directory_tree(current_path, writer.stream(), options);
+    } else if (detailed) {
+        success = list_directory_detailed(current_path, writer.stream(), list_options);
+    } else {
+        success = list_directory(current_path, writer.stream(), options.sorted);
+    }
+    if (!writer.flush()) {
+        return 1;
     }
 
-    bool success = list_directory(current_path, std::cout);
-    
     // Return appropriate exit code based on success
     return success ? 0 : 1;
 }
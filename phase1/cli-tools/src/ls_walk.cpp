@@ -0,0 +1,276 @@
+/*
+ * ls_walk.cpp - Recursive, parallel directory walker for my_ls -R
+ *
+ * Each directory is read with raw getdents64 calls into a large buffer, so a
+ * directory with thousands of entries costs a handful of syscalls, and the
+ * entry type comes from d_type without a stat per entry (fstatat is only
+ * used on file systems that report DT_UNKNOWN).
+ *
+ * Directories are distributed over the workers with work stealing. A worker
+ * pushes the subdirectories it discovers onto its own deque and pops from
+ * the back (depth first, which keeps the queues short); idle workers steal
+ * from the front of another worker's deque, which hands out the largest
+ * untouched subtrees first. A shared counter of queued and in-progress
+ * directories tells the workers when the walk is complete. A worker that
+ * finds nothing to steal sleeps on an atomic work epoch, which is bumped
+ * whenever a directory is queued and when the walk completes.
+ *
+ * How to Run without Docker (from project root):
+ *   1. cmake -S . -B build
+ *   2. cmake --build build -- -j
+ *   3. ./build/phase1/cli-tools/my_ls -R [-U] [-j N] [path]
+ */
+
+#include "ls.h"
+#include "dir_entries.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr size_t OUTPUT_BATCH_SIZE = 64 * 1024;    // Unsorted output is written in batches
+
+// A worker's deque of directories still to be read
+struct alignas(64) WorkQueue {
+    std::mutex mutex;
+    std::deque<std::string> dirs;
+};
+
+// Output collected by one worker
+struct WorkerOutput {
+    std::string text;                                   // Paths, '\n' terminated
+    std::vector<std::pair<size_t, size_t>> paths;       // (offset, length) into text when sorting
+    WalkStats stats;
+};
+
+class TreeWalker {
+public:
+    TreeWalker(std::ostream& out, const WalkOptions& options, size_t num_threads)
+        : out_(out), sorted_(options.sorted), queues_(num_threads), outputs_(num_threads) {}
+
+    void run(const std::string& root) {
+        pending_.store(1);
+        queues_[0].dirs.push_back(root);
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < queues_.size(); ++i) {
+            threads.emplace_back(&TreeWalker::work, this, i);
+        }
+        work(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Write sorted output and errors; sum the per-worker statistics
+    WalkStats finish() {
+        WalkStats total;
+        if (sorted_) {
+            std::vector<std::string_view> all;
+            for (const WorkerOutput& output : outputs_) {
+                for (const auto& [offset, length] : output.paths) {
+                    all.emplace_back(output.text.data() + offset, length);
+                }
+            }
+            std::sort(all.begin(), all.end());
+            for (std::string_view path : all) {
+                out_.write(path.data(), static_cast<std::streamsize>(path.size()));
+                out_.put('\n');
+            }
+        }
+        for (const std::string& error : errors_) {
+            out_ << error << '\n';
+        }
+        for (const WorkerOutput& output : outputs_) {
+            total.entries += output.stats.entries;
+            total.directories += output.stats.directories;
+            total.errors += output.stats.errors;
+        }
+        return total;
+    }
+
+private:
+    std::ostream& out_;
+    bool sorted_;
+    std::vector<WorkQueue> queues_;
+    std::vector<WorkerOutput> outputs_;
+    std::atomic<size_t> pending_{0};   // Directories queued or being read
+    std::atomic<uint32_t> epoch_{0};   // Bumped on every push and at completion; idle workers wait on it
+    std::mutex out_mutex_;
+    std::mutex errors_mutex_;
+    std::vector<std::string> errors_;
+
+    bool pop_own(size_t self, std::string& dir) {
+        WorkQueue& queue = queues_[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.dirs.empty()) {
+            return false;
+        }
+        dir = std::move(queue.dirs.back());
+        queue.dirs.pop_back();
+        return true;
+    }
+
+    bool steal(size_t self, std::string& dir) {
+        for (size_t k = 1; k < queues_.size(); ++k) {
+            WorkQueue& victim = queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.dirs.empty()) {
+                dir = std::move(victim.dirs.front());
+                victim.dirs.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void push_own(size_t self, std::string dir) {
+        pending_.fetch_add(1);
+        WorkQueue& queue = queues_[self];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.dirs.push_back(std::move(dir));
+        }
+        epoch_.fetch_add(1);
+        epoch_.notify_one();
+    }
+
+    void flush_output(WorkerOutput& output) {
+        if (output.text.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(out_mutex_);
+        out_.write(output.text.data(), static_cast<std::streamsize>(output.text.size()));
+        output.text.clear();
+    }
+
+    void work(size_t self) {
+        std::vector<char> buffer(DIR_ENTRIES_BUFFER_SIZE);
+        WorkerOutput& output = outputs_[self];
+        std::string dir;
+        while (true) {
+            // Read the epoch before looking for work: a push after this
+            // point changes it, so the wait below cannot miss that push
+            const uint32_t epoch = epoch_.load();
+            if (!pop_own(self, dir) && !steal(self, dir)) {
+                if (pending_.load() == 0) {
+                    break;
+                }
+                epoch_.wait(epoch);
+                continue;
+            }
+            read_directory(self, dir, buffer, output);
+            if (pending_.fetch_sub(1) == 1) {
+                // Last directory done: wake every sleeping worker so it can exit
+                epoch_.fetch_add(1);
+                epoch_.notify_all();
+            }
+        }
+        if (!sorted_) {
+            flush_output(output);
+        }
+    }
+
+    void read_directory(size_t self, const std::string& dir, std::vector<char>& buffer,
+                        WorkerOutput& output) {
+        int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            record_error(dir, errno, output);
+            return;
+        }
+        ++output.stats.directories;
+
+        // "/" must not become "//name"
+        const bool needs_slash = dir.empty() || dir.back() != '/';
+        auto on_entry = [&](const char* name, unsigned char d_type) {
+            const size_t offset = output.text.size();
+            output.text += dir;
+            if (needs_slash) {
+                output.text += '/';
+            }
+            output.text += name;
+            const size_t length = output.text.size() - offset;
+            output.text += '\n';
+            if (sorted_) {
+                output.paths.emplace_back(offset, length);
+            }
+            ++output.stats.entries;
+
+            bool is_dir = d_type == DT_DIR;
+            if (d_type == DT_UNKNOWN) {
+                struct stat st;
+                is_dir = ::fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode);
+            }
+            if (is_dir) {
+                push_own(self, output.text.substr(offset, length));
+            }
+        };
+        auto on_batch = [&] {
+            if (!sorted_ && output.text.size() >= OUTPUT_BATCH_SIZE) {
+                flush_output(output);
+            }
+        };
+        if (int error = for_each_dir_entry(fd, buffer, on_entry, on_batch)) {
+            record_error(dir, error, output);
+        }
+        ::close(fd);
+    }
+
+    void record_error(const std::string& dir, int error, WorkerOutput& output) {
+        ++output.stats.errors;
+        std::lock_guard<std::mutex> lock(errors_mutex_);
+        errors_.push_back("Error: Could not read directory: " + dir + " (" + std::strerror(error) + ")");
+    }
+};
+
+} // anonymous namespace
+
+bool walk_directory_tree(const std::filesystem::path& root, std::ostream& out,
+                         const WalkOptions& options, WalkStats* stats) {
+    std::error_code ec;
+    if (!std::filesystem::exists(root, ec)) {
+        out << "Error: Path does not exist." << '\n';
+        return false;
+    }
+    if (!std::filesystem::is_directory(root, ec)) {
+        // Like list_directory: a file lists as itself
+        out << root.string() << '\n';
+        if (stats) {
+            *stats = WalkStats{1, 0, 0};
+        }
+        return true;
+    }
+
+    size_t num_threads = options.num_threads;
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Drop trailing slashes so paths read "root/name"; keep "/" itself
+    std::string root_path = root.string();
+    while (root_path.size() > 1 && root_path.back() == '/') {
+        root_path.pop_back();
+    }
+
+    TreeWalker walker(out, options, num_threads);
+    walker.run(root_path);
+    WalkStats total = walker.finish();
+    if (stats) {
+        *stats = total;
+    }
+    return total.errors == 0;
+}
@@ -0,0 +1,167 @@
+/*
+ * ls_walk_bench: Benchmark for the recursive directory walker.
+ *
+ * Generates a directory tree in the system temp directory and lists it with:
+ *   - std::filesystem::recursive_directory_iterator, collecting and sorting
+ *     full paths (the straightforward implementation)
+ *   - walk_directory_tree on one thread, sorted and unsorted
+ *   - walk_directory_tree on N threads, sorted and unsorted
+ * Output goes to a sink that only counts lines. The tree is removed at exit.
+ * All runs are warm-cache; the first walk is repeated untimed beforehand.
+ *
+ * How to Compile without Docker (from project root):
+ *   1. cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+ *   2. cmake --build build --target ls_walk_bench -- -j
+ *
+ * How to Run without Docker:
+ *   ./build/phase1/cli-tools/ls_walk_bench [fanout] [depth] [files_per_dir] [threads]
+ *
+ * Usage Examples:
+ *   - Default tree (fanout 10, depth 3, 100 files per directory: ~111k entries):
+ *     ./build/phase1/cli-tools/ls_walk_bench
+ *
+ *   - About a million entries on 16 threads:
+ *     ./build/phase1/cli-tools/ls_walk_bench 10 4 90 16
+ */
+
+#include "ls.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fcntl.h>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// Stream buffer that discards output and counts lines written
+class LineCountBuf : public std::streambuf {
+public:
+    uint64_t lines = 0;
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (ch == '\n') {
+            ++lines;
+        }
+        return ch;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        for (std::streamsize i = 0; i < n; ++i) {
+            lines += s[i] == '\n';
+        }
+        return n;
+    }
+};
+
+// Create fanout subdirectories per level down to depth, each with files_per_dir files
+uint64_t generate_tree(const std::string& dir, int fanout, int depth, int files_per_dir) {
+    uint64_t entries = 0;
+    for (int f = 0; f < files_per_dir; ++f) {
+        std::string file = dir + "/file_" + std::to_string(f) + ".log";
+        int fd = ::open(file.c_str(), O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+        if (fd >= 0) {
+            ::close(fd);
+            ++entries;
+        }
+    }
+    if (depth == 0) {
+        return entries;
+    }
+    for (int d = 0; d < fanout; ++d) {
+        std::string sub = dir + "/dir_" + std::to_string(d);
+        std::filesystem::create_directory(sub);
+        entries += 1 + generate_tree(sub, fanout, depth - 1, files_per_dir);
+    }
+    return entries;
+}
+
+double time_seconds(const std::function<void()>& work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& name, double seconds, uint64_t lines, double baseline_seconds) {
+    std::cout << std::left << std::setw(36) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(8) << seconds << " s"
+              << std::setprecision(0) << std::setw(12) << lines / seconds << " entries/s"
+              << std::setprecision(2) << std::setw(8) << baseline_seconds / seconds << "x"
+              << "  lines=" << lines << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    int fanout = argc > 1 ? std::stoi(argv[1]) : 10;
+    int depth = argc > 2 ? std::stoi(argv[2]) : 3;
+    int files_per_dir = argc > 3 ? std::stoi(argv[3]) : 100;
+    size_t threads = argc > 4 ? std::stoul(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "ls_walk_bench_tree";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directory(root);
+    std::cout << "Generating tree (fanout " << fanout << ", depth " << depth << ", "
+              << files_per_dir << " files per directory)..." << std::endl;
+    const uint64_t expected = generate_tree(root.string(), fanout, depth, files_per_dir);
+    std::cout << "Entries: " << expected << ", threads: " << threads << std::endl;
+
+    // Warm the dentry and inode caches
+    {
+        LineCountBuf warm_buf;
+        std::ostream warm_out(&warm_buf);
+        walk_directory_tree(root, warm_out, WalkOptions{threads, false});
+    }
+
+    LineCountBuf fs_buf;
+    std::ostream fs_out(&fs_buf);
+    double fs_seconds = time_seconds([&] {
+        std::vector<std::string> paths;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+            paths.push_back(entry.path().string());
+        }
+        std::sort(paths.begin(), paths.end());
+        for (const auto& path : paths) {
+            fs_out << path << '\n';
+        }
+    });
+    report("recursive_directory_iterator+sort", fs_seconds, fs_buf.lines, fs_seconds);
+
+    bool all_match = fs_buf.lines == expected;
+    const struct {
+        const char* name;
+        size_t threads;
+        bool sorted;
+    } runs[] = {
+        {"walker, 1 thread, sorted", 1, true},
+        {"walker, 1 thread, unsorted", 1, false},
+        {"walker, N threads, sorted", threads, true},
+        {"walker, N threads, unsorted", threads, false},
+    };
+    for (const auto& run : runs) {
+        LineCountBuf buf;
+        std::ostream out(&buf);
+        double seconds = time_seconds([&] {
+            walk_directory_tree(root, out, WalkOptions{run.threads, run.sorted});
+        });
+        report(run.name, seconds, buf.lines, fs_seconds);
+        all_match = all_match && buf.lines == expected;
+    }
+
+    std::filesystem::remove_all(root);
+    if (!all_match) {
+        std::cout << "[RESULT MISMATCH] some walk did not list " << expected << " entries" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,664 @@
+/*
+ * multi_matcher.cpp - Multi-pattern line matcher used by my_grep
+ *
+ * Both construction paths end in the same representation: a dense DFA whose
+ * columns are byte equivalence classes, plus the state entered at the start
+ * of a line and whether each state accepts when the line ends. finalize()
+ * turns that into the scanning table, and find_line() walks the buffer once,
+ * one table lookup per byte, restarting the automaton at every newline.
+ *
+ *  - from_literals(): Aho-Corasick. A byte trie with failure links is turned
+ *    into a complete goto function, so there is no failure-link chasing while
+ *    scanning.
+ *  - from_regex(): every expression is parsed into a Thompson NFA fragment,
+ *    the fragments are joined under an unanchored ".*" prefix loop, and the
+ *    NFA is determinized with the subset construction. '^' and '$' are
+ *    modelled as two virtual input symbols (begin/end of line) that are fed to
+ *    the automaton before the first and after the last byte of every line.
+ */
+
+#include "multi_matcher.h"
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Input alphabet of the regex NFA: 256 bytes plus the two line anchors
+constexpr size_t BOL_SYMBOL = 256;
+constexpr size_t EOL_SYMBOL = 257;
+constexpr size_t NUM_SYMBOLS = 258;
+
+using SymbolSet = std::bitset<NUM_SYMBOLS>;
+
+/**
+ * @brief A Thompson NFA state
+ *
+ * Symbol states consume one symbol from `symbols` and move to `out`.
+ * Split states are epsilon moves to `out` and (if set) `out1`.
+ */
+struct NfaState {
+    enum class Kind { Symbol, Split, Match };
+
+    Kind kind;
+    SymbolSet symbols;
+    int out = -1;
+    int out1 = -1;
+};
+
+/**
+ * @brief Recursive descent parser producing Thompson NFA fragments
+ */
+class RegexCompiler {
+public:
+    explicit RegexCompiler(std::vector<NfaState>& states) : states_(states) {}
+
+    /**
+     * @brief Parse one expression and return its start state
+     *
+     * All dangling exits of the expression are connected to match_state.
+     */
+    int compile(const std::string& pattern, int match_state) {
+        pattern_ = &pattern;
+        pos_ = 0;
+        Fragment fragment = parse_alternation();
+        if (pos_ < pattern.size()) {
+            fail("unmatched ')'");
+        }
+        patch(fragment.exits, match_state);
+        return fragment.start;
+    }
+
+private:
+    // A dangling exit: which field of which state still needs a target
+    struct Exit {
+        int state;
+        bool second;
+    };
+
+    struct Fragment {
+        int start;
+        std::vector<Exit> exits;
+    };
+
+    std::vector<NfaState>& states_;
+    const std::string* pattern_ = nullptr;
+    size_t pos_ = 0;
+
+    [[noreturn]] void fail(const std::string& reason) const {
+        throw std::invalid_argument("Invalid regex \"" + *pattern_ + "\": " + reason);
+    }
+
+    bool at_end() const { return pos_ >= pattern_->size(); }
+    char peek() const { return (*pattern_)[pos_]; }
+
+    int add_state(NfaState::Kind kind, const SymbolSet& symbols = {}) {
+        NfaState state;
+        state.kind = kind;
+        state.symbols = symbols;
+        states_.push_back(state);
+        return static_cast<int>(states_.size() - 1);
+    }
+
+    void patch(const std::vector<Exit>& exits, int target) {
+        for (const Exit& exit : exits) {
+            (exit.second ? states_[exit.state].out1 : states_[exit.state].out) = target;
+        }
+    }
+
+    Fragment symbol_fragment(const SymbolSet& symbols) {
+        int s = add_state(NfaState::Kind::Symbol, symbols);
+        return {s, {{s, false}}};
+    }
+
+    Fragment parse_alternation() {
+        Fragment left = parse_concatenation();
+        while (!at_end() && peek() == '|') {
+            ++pos_;
+            Fragment right = parse_concatenation();
+            int split = add_state(NfaState::Kind::Split);
+            states_[split].out = left.start;
+            states_[split].out1 = right.start;
+            left.start = split;
+            left.exits.insert(left.exits.end(), right.exits.begin(), right.exits.end());
+        }
+        return left;
+    }
+
+    Fragment parse_concatenation() {
+        // An empty branch is a single epsilon move
+        int empty = add_state(NfaState::Kind::Split);
+        Fragment result{empty, {{empty, false}}};
+        while (!at_end() && peek() != '|' && peek() != ')') {
+            Fragment next = parse_repetition();
+            patch(result.exits, next.start);
+            result.exits = std::move(next.exits);
+        }
+        return result;
+    }
+
+    Fragment parse_repetition() {
+        Fragment atom = parse_atom();
+        while (!at_end() && (peek() == '*' || peek() == '+' || peek() == '?')) {
+            char op = (*pattern_)[pos_++];
+            int split = add_state(NfaState::Kind::Split);
+            states_[split].out = atom.start;
+            if (op == '*') {
+                // split -> atom -> split, exit through split.out1
+                patch(atom.exits, split);
+                atom = {split, {{split, true}}};
+            } else if (op == '+') {
+                // atom -> split -> atom, exit through split.out1
+                patch(atom.exits, split);
+                atom.exits = {{split, true}};
+            } else {
+                // split -> atom or skip it
+                atom.exits.push_back({split, true});
+                atom.start = split;
+            }
+        }
+        return atom;
+    }
+
+    Fragment parse_atom() {
+        if (at_end()) {
+            fail("unexpected end of pattern");
+        }
+        char c = (*pattern_)[pos_++];
+        switch (c) {
+            case '(': {
+                Fragment inner = parse_alternation();
+                if (at_end() || peek() != ')') {
+                    fail("missing ')'");
+                }
+                ++pos_;
+                return inner;
+            }
+            case '[':
+                return symbol_fragment(parse_bracket());
+            case '.': {
+                SymbolSet any;
+                for (size_t b = 0; b < 256; ++b) {
+                    any.set(b);
+                }
+                any.reset('\n');
+                return symbol_fragment(any);
+            }
+            case '^':
+                return symbol_fragment(SymbolSet().set(BOL_SYMBOL));
+            case '$':
+                return symbol_fragment(SymbolSet().set(EOL_SYMBOL));
+            case '\\':
+                return symbol_fragment(parse_escape());
+            case '*':
+            case '+':
+            case '?':
+                fail(std::string("nothing to repeat before '") + c + "'");
+            default:
+                return symbol_fragment(SymbolSet().set(static_cast<unsigned char>(c)));
+        }
+    }
+
+    // Shorthand classes shared by escapes and bracket expressions
+    static bool shorthand_class(char c, SymbolSet& set) {
+        SymbolSet base;
+        switch (std::tolower(static_cast<unsigned char>(c))) {
+            case 'd':
+                for (int b = '0'; b <= '9'; ++b) base.set(b);
+                break;
+            case 'w':
+                for (int b = 0; b < 256; ++b) {
+                    if (std::isalnum(b) || b == '_') base.set(b);
+                }
+                break;
+            case 's':
+                for (char b : {' ', '\t', '\n', '\r', '\f', '\v'}) base.set(static_cast<unsigned char>(b));
+                break;
+            default:
+                return false;
+        }
+        if (std::isupper(static_cast<unsigned char>(c))) {
+            // Negated shorthand, restricted to bytes
+            for (size_t b = 0; b < 256; ++b) {
+                base.flip(b);
+            }
+        }
+        set |= base;
+        return true;
+    }
+
+    static unsigned char escaped_byte(char c) {
+        switch (c) {
+            case 'n': return '\n';
+            case 't': return '\t';
+            case 'r': return '\r';
+            case 'f': return '\f';
+            case 'v': return '\v';
+            default:  return static_cast<unsigned char>(c);
+        }
+    }
+
+    SymbolSet parse_escape() {
+        if (at_end()) {
+            fail("trailing backslash");
+        }
+        char c = (*pattern_)[pos_++];
+        SymbolSet set;
+        if (!shorthand_class(c, set)) {
+            set.set(escaped_byte(c));
+        }
+        return set;
+    }
+
+    SymbolSet parse_bracket() {
+        SymbolSet set;
+        bool negate = false;
+        if (!at_end() && peek() == '^') {
+            negate = true;
+            ++pos_;
+        }
+        bool first = true;
+        while (true) {
+            if (at_end()) {
+                fail("missing ']'");
+            }
+            char c = (*pattern_)[pos_++];
+            // A ']' right after '[' or '[^' is a literal
+            if (c == ']' && !first) {
+                break;
+            }
+            first = false;
+
+            unsigned char low;
+            if (c == '\\') {
+                if (at_end()) {
+                    fail("trailing backslash");
+                }
+                char e = (*pattern_)[pos_++];
+                if (shorthand_class(e, set)) {
+                    continue;
+                }
+                low = escaped_byte(e);
+            } else {
+                low = static_cast<unsigned char>(c);
+            }
+
+            // Range "a-z" (a '-' before ']' is a literal)
+            if (pos_ + 1 < pattern_->size() && peek() == '-' && (*pattern_)[pos_ + 1] != ']') {
+                ++pos_;
+                char h = (*pattern_)[pos_++];
+                unsigned char high = static_cast<unsigned char>(h);
+                if (h == '\\') {
+                    if (at_end()) {
+                        fail("trailing backslash");
+                    }
+                    high = escaped_byte((*pattern_)[pos_++]);
+                }
+                if (high < low) {
+                    fail("invalid range in bracket expression");
+                }
+                for (unsigned b = low; b <= high; ++b) {
+                    set.set(b);
+                }
+            } else {
+                set.set(low);
+            }
+        }
+        if (negate) {
+            for (size_t b = 0; b < 256; ++b) {
+                set.flip(b);
+            }
+            set.reset('\n');
+        }
+        return set;
+    }
+};
+
+/**
+ * @brief Assign every symbol to an equivalence class
+ *
+ * Two symbols end up in the same class if every symbol set contains either
+ * both or neither of them, so the automaton cannot tell them apart.
+ *
+ * @return Class id of every symbol; num_classes receives the class count
+ */
+std::vector<uint16_t> compute_symbol_classes(const std::vector<const SymbolSet*>& sets,
+                                             size_t num_symbols, size_t& num_classes) {
+    std::map<std::vector<bool>, uint16_t> class_of_signature;
+    std::vector<uint16_t> classes(num_symbols);
+    for (size_t symbol = 0; symbol < num_symbols; ++symbol) {
+        std::vector<bool> signature(sets.size());
+        for (size_t i = 0; i < sets.size(); ++i) {
+            signature[i] = sets[i]->test(symbol);
+        }
+        auto it = class_of_signature.emplace(signature, static_cast<uint16_t>(class_of_signature.size())).first;
+        classes[symbol] = it->second;
+    }
+    num_classes = class_of_signature.size();
+    return classes;
+}
+
+} // anonymous namespace
+
+MultiPatternMatcher MultiPatternMatcher::from_literals(const std::vector<std::string>& patterns) {
+    // Build the trie; node 0 is the root
+    std::vector<std::array<int32_t, 256>> next(1);
+    next[0].fill(-1);
+    std::vector<uint8_t> output(1, 0);
+    std::bitset<256> used_bytes;
+
+    for (const std::string& pattern : patterns) {
+        // A line never contains '\n', so such a pattern can never match
+        if (pattern.find('\n') != std::string::npos) {
+            continue;
+        }
+        int32_t node = 0;
+        for (char ch : pattern) {
+            unsigned char c = static_cast<unsigned char>(ch);
+            used_bytes.set(c);
+            if (next[node][c] < 0) {
+                next[node][c] = static_cast<int32_t>(next.size());
+                next.emplace_back().fill(-1);
+                output.push_back(0);
+            }
+            node = next[node][c];
+        }
+        output[node] = 1;
+    }
+
+    // Breadth-first pass: compute failure links and complete the goto function
+    std::vector<int32_t> fail(next.size(), 0);
+    std::queue<int32_t> queue;
+    for (int c = 0; c < 256; ++c) {
+        if (next[0][c] < 0) {
+            next[0][c] = 0;
+        } else {
+            queue.push(next[0][c]);
+        }
+    }
+    while (!queue.empty()) {
+        int32_t node = queue.front();
+        queue.pop();
+        output[node] |= output[fail[node]];
+        for (int c = 0; c < 256; ++c) {
+            int32_t child = next[node][c];
+            if (child < 0) {
+                next[node][c] = next[fail[node]][c];
+            } else {
+                fail[child] = next[fail[node]][c];
+                queue.push(child);
+            }
+        }
+    }
+
+    // Bytes that occur in no pattern all behave like each other: class 0
+    std::array<uint16_t, 256> byte_class{};
+    std::vector<unsigned char> representative = {0};
+    for (int c = 0; c < 256; ++c) {
+        if (used_bytes.test(c)) {
+            byte_class[c] = static_cast<uint16_t>(representative.size());
+            representative.push_back(static_cast<unsigned char>(c));
+        }
+    }
+    if (used_bytes.count() == 256) {
+        representative.erase(representative.begin());
+        for (auto& cls : byte_class) {
+            --cls;
+        }
+    } else {
+        // Pick an unused byte as the representative of class 0
+        for (int c = 0; c < 256; ++c) {
+            if (!used_bytes.test(c)) {
+                representative[0] = static_cast<unsigned char>(c);
+                break;
+            }
+        }
+    }
+
+    const size_t num_classes = representative.size();
+    std::vector<uint32_t> transitions(next.size() * num_classes);
+    for (size_t node = 0; node < next.size(); ++node) {
+        for (size_t cls = 0; cls < num_classes; ++cls) {
+            transitions[node * num_classes + cls] = static_cast<uint32_t>(next[node][representative[cls]]);
+        }
+    }
+    // Every match is reported as soon as its last byte is read
+    std::vector<uint8_t> accepts_at_eol(output.size(), 0);
+
+    MultiPatternMatcher matcher;
+    matcher.finalize(byte_class, num_classes, transitions, output, accepts_at_eol, 0);
+    return matcher;
+}
+
+MultiPatternMatcher MultiPatternMatcher::from_regex(const std::vector<std::string>& patterns) {
+    std::vector<NfaState> nfa;
+    RegexCompiler compiler(nfa);
+
+    int match_state = static_cast<int>(nfa.size());
+    nfa.push_back({NfaState::Kind::Match, {}, -1, -1});
+
+    // Unanchored search: root -> (loop over any symbol back to root) | expr1 | expr2 ...
+    int root = static_cast<int>(nfa.size());
+    nfa.push_back({NfaState::Kind::Split, {}, -1, -1});
+    SymbolSet any_symbol;
+    any_symbol.set();
+    any_symbol.reset(EOL_SYMBOL);
+    int loop = static_cast<int>(nfa.size());
+    nfa.push_back({NfaState::Kind::Symbol, any_symbol, root, -1});
+
+    int chain = root;
+    nfa[root].out = loop;
+    for (const std::string& pattern : patterns) {
+        int start = compiler.compile(pattern, match_state);
+        int split = static_cast<int>(nfa.size());
+        nfa.push_back({NfaState::Kind::Split, {}, start, -1});
+        nfa[chain].out1 = split;
+        chain = split;
+    }
+
+    // Equivalence classes over all symbol sets used by the NFA
+    std::vector<const SymbolSet*> sets;
+    for (const NfaState& state : nfa) {
+        if (state.kind == NfaState::Kind::Symbol) {
+            sets.push_back(&state.symbols);
+        }
+    }
+    size_t num_classes = 0;
+    std::vector<uint16_t> symbol_class = compute_symbol_classes(sets, NUM_SYMBOLS, num_classes);
+    std::vector<size_t> representative(num_classes);
+    for (size_t symbol = NUM_SYMBOLS; symbol-- > 0;) {
+        representative[symbol_class[symbol]] = symbol;
+    }
+
+    // Epsilon closure, keeping only the states that matter for the DFA
+    auto closure = [&](std::vector<int> stack) {
+        std::vector<uint8_t> seen(nfa.size(), 0);
+        std::vector<int> result;
+        while (!stack.empty()) {
+            int s = stack.back();
+            stack.pop_back();
+            if (s < 0 || seen[s]) {
+                continue;
+            }
+            seen[s] = 1;
+            if (nfa[s].kind == NfaState::Kind::Split) {
+                stack.push_back(nfa[s].out);
+                stack.push_back(nfa[s].out1);
+            } else {
+                result.push_back(s);
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    // Subset construction
+    std::map<std::vector<int>, uint32_t> dfa_ids;
+    std::vector<std::vector<int>> dfa_states;
+    std::vector<uint32_t> dfa_trans;
+    auto intern = [&](std::vector<int> key) {
+        auto it = dfa_ids.find(key);
+        if (it != dfa_ids.end()) {
+            return it->second;
+        }
+        if (dfa_states.size() >= MAX_DFA_STATES) {
+            throw std::invalid_argument("Regex set is too complex: DFA exceeds " +
+                                        std::to_string(MAX_DFA_STATES) + " states");
+        }
+        uint32_t id = static_cast<uint32_t>(dfa_states.size());
+        dfa_ids.emplace(key, id);
+        dfa_states.push_back(std::move(key));
+        return id;
+    };
+
+    uint32_t start = intern(closure({root}));
+    for (size_t current = 0; current < dfa_states.size(); ++current) {
+        dfa_trans.resize((current + 1) * num_classes);
+        for (size_t cls = 0; cls < num_classes; ++cls) {
+            std::vector<int> moved;
+            for (int s : dfa_states[current]) {
+                if (nfa[s].kind == NfaState::Kind::Symbol && nfa[s].symbols.test(representative[cls])) {
+                    moved.push_back(nfa[s].out);
+                }
+            }
+            uint32_t target = intern(closure(std::move(moved)));
+            dfa_trans[current * num_classes + cls] = target;
+        }
+    }
+
+    std::array<uint16_t, 256> byte_class{};
+    for (size_t b = 0; b < 256; ++b) {
+        byte_class[b] = symbol_class[b];
+    }
+    std::vector<uint8_t> accepting(dfa_states.size());
+    for (size_t i = 0; i < dfa_states.size(); ++i) {
+        accepting[i] = std::binary_search(dfa_states[i].begin(), dfa_states[i].end(), match_state);
+    }
+    std::vector<uint8_t> accepts_at_eol(dfa_states.size());
+    for (size_t i = 0; i < dfa_states.size(); ++i) {
+        uint32_t after_eol = dfa_trans[i * num_classes + symbol_class[EOL_SYMBOL]];
+        accepts_at_eol[i] = accepting[i] || accepting[after_eol];
+    }
+    uint32_t line_start_state = dfa_trans[start * num_classes + symbol_class[BOL_SYMBOL]];
+
+    MultiPatternMatcher matcher;
+    matcher.finalize(byte_class, num_classes, dfa_trans, accepting, accepts_at_eol, line_start_state);
+    return matcher;
+}
+
+void MultiPatternMatcher::finalize(const std::array<uint16_t, 256>& byte_class, size_t num_classes,
+                                   const std::vector<uint32_t>& transitions,
+                                   const std::vector<uint8_t>& accepting,
+                                   const std::vector<uint8_t>& accepts_at_eol,
+                                   uint32_t line_start_state) {
+    const size_t num_states = accepting.size();
+
+    // Non-accepting states first, then accepting ones, then the two newline pseudo-states
+    std::vector<uint32_t> new_id(num_states);
+    uint32_t next_id = 0;
+    for (size_t s = 0; s < num_states; ++s) {
+        if (!accepting[s]) {
+            new_id[s] = next_id++;
+        }
+    }
+    const uint32_t num_plain = next_id;
+    for (size_t s = 0; s < num_states; ++s) {
+        if (accepting[s]) {
+            new_id[s] = next_id++;
+        }
+    }
+    const uint32_t reset_id = next_id++;
+    const uint32_t accept_id = next_id++;
+
+    // '\n' gets an extra column that routes every state to a newline pseudo-state
+    num_columns_ = num_classes + 1;
+    newline_column_ = num_classes;
+    byte_class_ = byte_class;
+    byte_class_[static_cast<unsigned char>('\n')] = static_cast<uint16_t>(newline_column_);
+
+    const uint32_t width = static_cast<uint32_t>(num_columns_);
+    table_.assign(static_cast<size_t>(next_id) * num_columns_, 0);
+    for (size_t s = 0; s < num_states; ++s) {
+        uint32_t* row = table_.data() + static_cast<size_t>(new_id[s]) * num_columns_;
+        for (size_t cls = 0; cls < num_classes; ++cls) {
+            row[cls] = new_id[transitions[s * num_classes + cls]] * width;
+        }
+        row[newline_column_] = (accepts_at_eol[s] ? accept_id : reset_id) * width;
+    }
+
+    first_special_ = num_plain * width;
+    line_start_ = new_id[line_start_state] * width;
+    newline_reset_ = reset_id * width;
+    newline_accept_ = accept_id * width;
+    line_start_accepts_ = accepting[line_start_state];
+    state_count_ = num_states;
+}
+
+bool MultiPatternMatcher::find_line(const char* begin, const char* end,
+                                    const char*& line_start, const char*& line_end) const {
+    if (begin >= end) {
+        return false;
+    }
+
+    // An automaton that accepts at the start of a line matches every line
+    if (line_start_accepts_) {
+        line_start = begin;
+        line_end = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        if (!line_end) {
+            line_end = end;
+        }
+        return true;
+    }
+
+    const uint32_t* const table = table_.data();
+    const char* current_line = begin;
+    uint32_t state = line_start_;
+
+    for (const char* p = begin; p < end; ++p) {
+        state = table[state + byte_class_[static_cast<unsigned char>(*p)]];
+        if (state < first_special_) {
+            continue;
+        }
+
+        if (state == newline_reset_) {
+            // Line ended without a match: restart the automaton on the next line
+            current_line = p + 1;
+            state = line_start_;
+            continue;
+        }
+
+        line_start = current_line;
+        if (state == newline_accept_) {
+            line_end = p;
+        } else {
+            line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!line_end) {
+                line_end = end;
+            }
+        }
+        return true;
+    }
+
+    // Unterminated last line: feed the end of line by hand
+    if (current_line < end && table[state + newline_column_] == newline_accept_) {
+        line_start = current_line;
+        line_end = end;
+        return true;
+    }
+    return false;
+}
+
+bool MultiPatternMatcher::matches(std::string_view line) const {
+    if (line.empty()) {
+        // No bytes to scan: check the line start and line end directly
+        return line_start_accepts_ || table_[line_start_ + newline_column_] == newline_accept_;
+    }
+    const char* line_start;
+    const char* line_end;
+    return find_line(line.data(), line.data() + line.size(), line_start, line_end);
+}
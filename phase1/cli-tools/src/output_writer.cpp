@@ -0,0 +1,152 @@
+/*
+ * output_writer.cpp - Batched output sink for the cli-tools
+ *
+ * Replaces per-line std::endl flushing with one large write per buffer.
+ * The put area of the stream buffer is the batch itself, so ordinary
+ * operator<< calls are plain memcpy's until the buffer fills up.
+ */
+
+#include "output_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/uio.h>
+#include <unistd.h>
+
+OutputWriter::OutputWriter(std::ostream& target, FlushPolicy policy, size_t capacity)
+    : target_(&target), policy_(policy), buffer_(std::max<size_t>(capacity, 1)), stream_(this) {
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+    if (policy_ == FlushPolicy::EveryLine) {
+        // Single characters bypass xsputn(); have the stream sync after
+        // every insertion so a trailing '\n' is noticed in sync()
+        stream_.setf(std::ios::unitbuf);
+    }
+}
+
+OutputWriter::OutputWriter(int fd, FlushPolicy policy, size_t capacity)
+    : fd_(fd), policy_(policy), buffer_(std::max<size_t>(capacity, 1)), stream_(this) {
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+    if (policy_ == FlushPolicy::EveryLine) {
+        stream_.setf(std::ios::unitbuf);
+    }
+}
+
+OutputWriter::~OutputWriter() {
+    flush();
+}
+
+FlushPolicy OutputWriter::default_policy_for(int fd) {
+    return ::isatty(fd) ? FlushPolicy::EveryLine : FlushPolicy::WhenFull;
+}
+
+bool OutputWriter::flush() {
+    bool ok = drain();
+    if (target_) {
+        target_->flush();
+        ok = ok && target_->good();
+    }
+    return ok;
+}
+
+bool OutputWriter::drain(const char* extra, size_t extra_len) {
+    const size_t buffered = pending();
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+    if (buffered == 0 && extra_len == 0) {
+        return !failed_;
+    }
+
+    if (target_) {
+        ++write_calls_;
+        target_->write(buffer_.data(), static_cast<std::streamsize>(buffered));
+        if (extra_len > 0) {
+            target_->write(extra, static_cast<std::streamsize>(extra_len));
+        }
+        failed_ = failed_ || !target_->good();
+        return !failed_;
+    }
+
+    // File descriptor mode: one writev for the batch and the extra range,
+    // looping over partial writes and interrupted calls
+    iovec iov[2] = {{buffer_.data(), buffered}, {const_cast<char*>(extra), extra_len}};
+    iovec* current = iov;
+    int count = extra_len > 0 ? 2 : 1;
+    while (count > 0) {
+        ++write_calls_;
+        ssize_t written = ::writev(fd_, current, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            failed_ = true;
+            return false;
+        }
+        // Skip the fully written vectors and advance into the partial one
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= current->iov_len) {
+            remaining -= current->iov_len;
+            ++current;
+            --count;
+        }
+        if (count > 0) {
+            current->iov_base = static_cast<char*>(current->iov_base) + remaining;
+            current->iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+OutputWriter::int_type OutputWriter::overflow(int_type ch) {
+    // Called when the put area is full
+    if (!drain()) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        if (policy_ == FlushPolicy::EveryLine && ch == '\n' && !drain()) {
+            return traits_type::eof();
+        }
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize OutputWriter::xsputn(const char* s, std::streamsize n) {
+    const size_t len = static_cast<size_t>(n);
+    const size_t space = static_cast<size_t>(epptr() - pptr());
+
+    if (len <= space) {
+        std::memcpy(pptr(), s, len);
+        pbump(static_cast<int>(len));
+    } else if (len >= buffer_.size() / 2) {
+        // Large write: send it straight from the caller's memory
+        if (!drain(s, len)) {
+            return 0;
+        }
+    } else {
+        if (!drain()) {
+            return 0;
+        }
+        std::memcpy(pptr(), s, len);
+        pbump(static_cast<int>(len));
+    }
+
+    if (policy_ == FlushPolicy::EveryLine && pending() > 0 && std::memchr(s, '\n', len) != nullptr) {
+        if (!drain()) {
+            return 0;
+        }
+    }
+    return n;
+}
+
+int OutputWriter::sync() {
+    if (policy_ == FlushPolicy::WhenFull) {
+        // Stream flushes are batched away; only flush() forces a write
+        return failed_ ? -1 : 0;
+    }
+    if (policy_ == FlushPolicy::EveryLine &&
+        std::memchr(pbase(), '\n', pending()) == nullptr) {
+        // Keep an unfinished line buffered until it is completed
+        return failed_ ? -1 : 0;
+    }
+    return flush() ? 0 : -1;
+}
@@ -0,0 +1,274 @@
+/*
+ * simd_search.cpp - Vectorized byte search kernels for the cli-tools
+ *
+ * find_substring() implements the "first byte + last byte" filter: every
+ * vector iteration compares 16 (SSE2) or 32 (AVX2) candidate start positions
+ * at once against the first and the last byte of the needle, and only the
+ * positions where both bytes agree are verified with memcmp. On typical text
+ * this rejects almost every position without touching the rest of the needle.
+ *
+ * count_lines_and_words() classifies 64 bytes at a time into a whitespace
+ * bitmask and a newline bitmask. A word starts wherever a non-whitespace bit
+ * follows a whitespace bit, so word starts are popcount(~space & (space << 1))
+ * with the top bit of the previous block carried into bit 0.
+ *
+ * The AVX2 variants are compiled with a function-level target attribute and
+ * selected at runtime, so the binary still runs on CPUs without AVX2.
+ * Non-x86 builds fall back to memchr/memcmp.
+ */
+
+#include "simd_search.h"
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__SSE2__)
+#include <immintrin.h>
+#define CLI_TOOLS_HAVE_X86_SIMD 1
+#endif
+
+namespace {
+
+// Scalar search used for short buffers and for the tail after the vector loop
+const char* find_substring_scalar(const char* haystack, size_t haystack_len,
+                                  std::string_view needle) {
+    const size_t m = needle.size();
+    if (haystack_len < m) {
+        return nullptr;
+    }
+    const char* p = haystack;
+    const char* last = haystack + haystack_len - m;
+    while (p <= last) {
+        p = static_cast<const char*>(std::memchr(p, needle[0], last - p + 1));
+        if (!p) {
+            return nullptr;
+        }
+        if (std::memcmp(p + 1, needle.data() + 1, m - 1) == 0) {
+            return p;
+        }
+        ++p;
+    }
+    return nullptr;
+}
+
+inline bool is_space_byte(unsigned char c) {
+    return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+}
+
+// Scalar line/word counter used on non-x86 builds and for the vector tails
+LineWordCounts count_lines_and_words_scalar(const char* data, size_t len, bool& prev_is_space) {
+    LineWordCounts counts;
+    for (size_t i = 0; i < len; ++i) {
+        const unsigned char c = static_cast<unsigned char>(data[i]);
+        const bool space = is_space_byte(c);
+        counts.newlines += c == '\n';
+        counts.word_starts += prev_is_space && !space;
+        prev_is_space = space;
+    }
+    return counts;
+}
+
+#ifdef CLI_TOOLS_HAVE_X86_SIMD
+
+const char* find_substring_sse2(const char* haystack, size_t haystack_len,
+                                std::string_view needle) {
+    const size_t m = needle.size();
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[m - 1]);
+
+    size_t i = 0;
+    // Both loads must stay inside the buffer: the last-byte load ends at i + m - 1 + 16
+    for (; i + m - 1 + 16 <= haystack_len; i += 16) {
+        const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+        const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + m - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+        while (mask != 0) {
+            const unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (std::memcmp(haystack + i + bit + 1, needle.data() + 1, m - 2) == 0) {
+                return haystack + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return find_substring_scalar(haystack + i, haystack_len - i, needle);
+}
+
+__attribute__((target("avx2")))
+const char* find_substring_avx2(const char* haystack, size_t haystack_len,
+                                std::string_view needle) {
+    const size_t m = needle.size();
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[m - 1]);
+
+    size_t i = 0;
+    for (; i + m - 1 + 32 <= haystack_len; i += 32) {
+        const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i));
+        const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i + m - 1));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+        while (mask != 0) {
+            const unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (std::memcmp(haystack + i + bit + 1, needle.data() + 1, m - 2) == 0) {
+                return haystack + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return find_substring_sse2(haystack + i, haystack_len - i, needle);
+}
+
+size_t count_newlines_sse2(const char* data, size_t len) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        count += static_cast<size_t>(__builtin_popcount(
+            static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)))));
+    }
+    for (; i < len; ++i) {
+        count += data[i] == '\n';
+    }
+    return count;
+}
+
+__attribute__((target("avx2,popcnt")))
+size_t count_newlines_avx2(const char* data, size_t len) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        count += static_cast<size_t>(__builtin_popcount(
+            static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline)))));
+    }
+    return count + count_newlines_sse2(data + i, len - i);
+}
+
+// Bit i of the result is set if byte i of the 16-byte block is whitespace/newline
+inline void classify_sse2(const char* p, unsigned& space, unsigned& newline) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    // '\t'..'\r' are contiguous: (c - '\t') <= 4 as an unsigned byte compare
+    const __m128i shifted = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+    const __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(4)), shifted);
+    const __m128i is_space = _mm_or_si128(in_range, _mm_cmpeq_epi8(block, _mm_set1_epi8(' ')));
+    space = static_cast<unsigned>(_mm_movemask_epi8(is_space));
+    newline = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))));
+}
+
+LineWordCounts count_lines_and_words_sse2(const char* data, size_t len, bool& prev_is_space) {
+    LineWordCounts counts;
+    uint64_t carry = prev_is_space ? 1 : 0;
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        uint64_t space = 0;
+        uint64_t newline = 0;
+        for (int k = 0; k < 4; ++k) {
+            unsigned s16, n16;
+            classify_sse2(data + i + 16 * k, s16, n16);
+            space |= static_cast<uint64_t>(s16) << (16 * k);
+            newline |= static_cast<uint64_t>(n16) << (16 * k);
+        }
+        counts.newlines += static_cast<uint64_t>(__builtin_popcountll(newline));
+        counts.word_starts += static_cast<uint64_t>(__builtin_popcountll(~space & ((space << 1) | carry)));
+        carry = space >> 63;
+    }
+    prev_is_space = carry != 0;
+    LineWordCounts tail = count_lines_and_words_scalar(data + i, len - i, prev_is_space);
+    counts.newlines += tail.newlines;
+    counts.word_starts += tail.word_starts;
+    return counts;
+}
+
+__attribute__((target("avx2,popcnt")))
+LineWordCounts count_lines_and_words_avx2(const char* data, size_t len, bool& prev_is_space) {
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i four = _mm256_set1_epi8(4);
+    const __m256i blank = _mm256_set1_epi8(' ');
+    const __m256i nl = _mm256_set1_epi8('\n');
+
+    LineWordCounts counts;
+    uint64_t carry = prev_is_space ? 1 : 0;
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        const __m256i lo_shifted = _mm256_sub_epi8(lo, tab);
+        const __m256i hi_shifted = _mm256_sub_epi8(hi, tab);
+        const __m256i lo_space = _mm256_or_si256(
+            _mm256_cmpeq_epi8(_mm256_min_epu8(lo_shifted, four), lo_shifted), _mm256_cmpeq_epi8(lo, blank));
+        const __m256i hi_space = _mm256_or_si256(
+            _mm256_cmpeq_epi8(_mm256_min_epu8(hi_shifted, four), hi_shifted), _mm256_cmpeq_epi8(hi, blank));
+
+        const uint64_t space = static_cast<uint32_t>(_mm256_movemask_epi8(lo_space)) |
+                               static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi_space))) << 32;
+        const uint64_t newline = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, nl))) |
+                                 static_cast<uint64_t>(static_cast<uint32_t>(
+                                     _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, nl)))) << 32;
+
+        counts.newlines += static_cast<uint64_t>(__builtin_popcountll(newline));
+        counts.word_starts += static_cast<uint64_t>(__builtin_popcountll(~space & ((space << 1) | carry)));
+        carry = space >> 63;
+    }
+    prev_is_space = carry != 0;
+    LineWordCounts tail = count_lines_and_words_scalar(data + i, len - i, prev_is_space);
+    counts.newlines += tail.newlines;
+    counts.word_starts += tail.word_starts;
+    return counts;
+}
+
+bool cpu_has_avx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+
+#endif // CLI_TOOLS_HAVE_X86_SIMD
+
+} // anonymous namespace
+
+const char* find_substring(const char* haystack, size_t haystack_len, std::string_view needle) {
+    if (needle.empty()) {
+        return haystack;
+    }
+    if (needle.size() > haystack_len) {
+        return nullptr;
+    }
+    if (needle.size() == 1) {
+        // libc memchr is already vectorized and hard to beat for a single byte
+        return static_cast<const char*>(std::memchr(haystack, needle[0], haystack_len));
+    }
+
+#ifdef CLI_TOOLS_HAVE_X86_SIMD
+    if (cpu_has_avx2()) {
+        return find_substring_avx2(haystack, haystack_len, needle);
+    }
+    return find_substring_sse2(haystack, haystack_len, needle);
+#else
+    return find_substring_scalar(haystack, haystack_len, needle);
+#endif
+}
+
+size_t count_newlines(const char* data, size_t len) {
+#ifdef CLI_TOOLS_HAVE_X86_SIMD
+    if (cpu_has_avx2()) {
+        return count_newlines_avx2(data, len);
+    }
+    return count_newlines_sse2(data, len);
+#else
+    size_t count = 0;
+    for (size_t i = 0; i < len; ++i) {
+        count += data[i] == '\n';
+    }
+    return count;
+#endif
+}
+
+LineWordCounts count_lines_and_words(const char* data, size_t len, bool prev_is_space) {
+#ifdef CLI_TOOLS_HAVE_X86_SIMD
+    if (cpu_has_avx2()) {
+        return count_lines_and_words_avx2(data, len, prev_is_space);
+    }
+    return count_lines_and_words_sse2(data, len, prev_is_space);
+#else
+    return count_lines_and_words_scalar(data, len, prev_is_space);
+#endif
+}
@@ -0,0 +1,320 @@
+/*
+ * utf8.cpp - Vectorized UTF-8 validation and code point counting
+ *
+ * The AVX2 path validates 32 bytes per step with the lookup-table algorithm
+ * from Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per
+ * Byte" (2021): three 16-entry nibble lookups classify every pair of
+ * adjacent bytes into error classes, and a saturating-subtract check makes
+ * sure the third and fourth bytes of long sequences are continuations. In
+ * valid input every byte that is not a continuation byte starts exactly one
+ * code point, so counting is a compare and a popcount next to the check.
+ *
+ * Input is validated in runs of a few KB that begin and end on sequence
+ * boundaries. A run that fails validation is split into small runs, and the
+ * small runs that fail are decoded again with the scalar WHATWG decoder,
+ * which counts each maximal invalid subpart as one error; clean text
+ * therefore never touches the scalar code. Without AVX2 the
+ * scalar decoder is used, with a shortcut for 16-byte all-ASCII blocks.
+ */
+
+#include "utf8.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__SSE2__)
+#include <immintrin.h>
+#define CLI_TOOLS_HAVE_X86_SIMD 1
+#endif
+
+namespace {
+
+inline bool is_continuation(unsigned char c) {
+    return (c & 0xC0) == 0x80;
+}
+
+inline void reset(Utf8State& state) {
+    state.bytes_needed = 0;
+    state.bytes_seen = 0;
+    state.lower = 0x80;
+    state.upper = 0xBF;
+}
+
+// WHATWG UTF-8 decoder, byte at a time
+void decode_scalar(const unsigned char* p, size_t len, Utf8State& state, Utf8Counts& counts) {
+    size_t i = 0;
+    while (i < len) {
+        const unsigned char b = p[i];
+        if (state.bytes_needed == 0) {
+            if (b < 0x80) {
+                ++counts.code_points;
+            } else if (b >= 0xC2 && b <= 0xDF) {
+                state.bytes_needed = 1;
+            } else if (b >= 0xE0 && b <= 0xEF) {
+                if (b == 0xE0) state.lower = 0xA0;  // Overlong
+                if (b == 0xED) state.upper = 0x9F;  // Surrogates
+                state.bytes_needed = 2;
+            } else if (b >= 0xF0 && b <= 0xF4) {
+                if (b == 0xF0) state.lower = 0x90;  // Overlong
+                if (b == 0xF4) state.upper = 0x8F;  // Above U+10FFFF
+                state.bytes_needed = 3;
+            } else {
+                ++counts.invalid;
+            }
+            ++i;
+            continue;
+        }
+
+        if (b < state.lower || b > state.upper) {
+            // Sequence cut short: one error, then decode b again from scratch
+            reset(state);
+            ++counts.invalid;
+            continue;
+        }
+        state.lower = 0x80;
+        state.upper = 0xBF;
+        if (++state.bytes_seen == state.bytes_needed) {
+            ++counts.code_points;
+            reset(state);
+        }
+        ++i;
+    }
+}
+
+#ifdef CLI_TOOLS_HAVE_X86_SIMD
+
+// Scalar decoding with a shortcut for 16-byte blocks of pure ASCII
+void decode_ascii_fast(const unsigned char* p, size_t len, Utf8State& state, Utf8Counts& counts) {
+    size_t i = 0;
+    while (i < len) {
+        if (state.bytes_needed == 0 && i + 16 <= len &&
+            _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))) == 0) {
+            counts.code_points += 16;
+            i += 16;
+            continue;
+        }
+        const size_t next = std::min(len, i + 16);
+        decode_scalar(p + i, next - i, state, counts);
+        i = next;
+    }
+}
+
+// Error classes of the lookup algorithm, one bit each
+constexpr uint8_t TOO_SHORT = 1 << 0;       // 11______ 0_______ or 11______ 11______
+constexpr uint8_t TOO_LONG = 1 << 1;        // 0_______ 10______
+constexpr uint8_t OVERLONG_3 = 1 << 2;      // 11100000 100_____
+constexpr uint8_t TOO_LARGE = 1 << 3;       // 11110100 1001____ or above
+constexpr uint8_t SURROGATE = 1 << 4;       // 11101101 101_____
+constexpr uint8_t OVERLONG_2 = 1 << 5;      // 1100000_ 10______
+constexpr uint8_t TOO_LARGE_1000 = 1 << 6;  // 11110101+ 1000____
+constexpr uint8_t OVERLONG_4 = 1 << 6;      // 11110000 1000____
+constexpr uint8_t TWO_CONTS = 1 << 7;       // 10______ 10______
+constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+// Broadcast a 16-entry table to both 128-bit lanes
+__attribute__((target("avx2")))
+inline __m256i table16(uint8_t t0, uint8_t t1, uint8_t t2, uint8_t t3, uint8_t t4, uint8_t t5,
+                       uint8_t t6, uint8_t t7, uint8_t t8, uint8_t t9, uint8_t t10, uint8_t t11,
+                       uint8_t t12, uint8_t t13, uint8_t t14, uint8_t t15) {
+    return _mm256_setr_epi8(t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15,
+                            t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15);
+}
+
+// The 32 bytes ending n bytes before the end of input (n = 1..3)
+template <int N>
+__attribute__((target("avx2")))
+inline __m256i prev_bytes(__m256i input, __m256i prev_input) {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - N);
+}
+
+struct Avx2Validator {
+    __m256i error;
+    __m256i prev_input;
+    __m256i prev_incomplete;
+    uint64_t continuation_bytes;
+
+    __attribute__((target("avx2")))
+    void init() {
+        error = _mm256_setzero_si256();
+        prev_input = _mm256_setzero_si256();
+        prev_incomplete = _mm256_setzero_si256();
+        continuation_bytes = 0;
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    void step(__m256i input) {
+        if (_mm256_movemask_epi8(input) == 0) {
+            // ASCII block: only an unfinished sequence before it is an error
+            error = _mm256_or_si256(error, prev_incomplete);
+            prev_incomplete = _mm256_setzero_si256();
+            prev_input = input;
+            return;
+        }
+
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        const __m256i prev1 = prev_bytes<1>(input, prev_input);
+        const __m256i byte_1_high = _mm256_shuffle_epi8(
+            table16(TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+                    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+                    TOO_SHORT | OVERLONG_2,
+                    TOO_SHORT,
+                    TOO_SHORT | OVERLONG_3 | SURROGATE,
+                    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4),
+            _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+        const __m256i byte_1_low = _mm256_shuffle_epi8(
+            table16(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+                    CARRY | OVERLONG_2,
+                    CARRY,
+                    CARRY,
+                    CARRY | TOO_LARGE,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000),
+            _mm256_and_si256(prev1, nibble));
+        const __m256i byte_2_high = _mm256_shuffle_epi8(
+            table16(TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+                    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+                    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+                    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT),
+            _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+        const __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+        // Third and fourth bytes of 3- and 4-byte sequences must be continuations;
+        // TWO_CONTS is expected exactly there, so xor leaves only the mismatches
+        const __m256i prev2 = prev_bytes<2>(input, prev_input);
+        const __m256i prev3 = prev_bytes<3>(input, prev_input);
+        const __m256i is_third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 1)));
+        const __m256i is_fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 1)));
+        const __m256i must_be_cont = _mm256_cmpgt_epi8(_mm256_or_si256(is_third, is_fourth), _mm256_setzero_si256());
+        const __m256i must_80 = _mm256_and_si256(must_be_cont, _mm256_set1_epi8(static_cast<char>(0x80)));
+        error = _mm256_or_si256(error, _mm256_xor_si256(must_80, special));
+
+        // Lead bytes in the last three positions whose sequence continues in the next block
+        const __m256i max_value = _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+        prev_incomplete = _mm256_subs_epu8(input, max_value);
+        prev_input = input;
+
+        // Continuation bytes are 0x80..0xBF, i.e. below -64 as signed bytes
+        const __m256i cont = _mm256_cmpgt_epi8(_mm256_set1_epi8(-64), input);
+        continuation_bytes += static_cast<uint64_t>(
+            __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(cont))));
+    }
+
+    // Validate [p, p + len) as a complete run; counts its continuation bytes
+    __attribute__((target("avx2,popcnt")))
+    bool validate(const unsigned char* p, size_t len) {
+        init();
+        size_t i = 0;
+        for (; i + 32 <= len; i += 32) {
+            step(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+        }
+        // The zero padding also flags a sequence left open at the end of the run
+        alignas(32) unsigned char tail[32] = {};
+        std::memcpy(tail, p + i, len - i);
+        step(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+        return _mm256_testz_si256(error, error) != 0;
+    }
+};
+
+// Bytes per validated run. A failing run is validated again in small runs,
+// and only the small runs that fail are decoded by the scalar path.
+constexpr size_t RUN_SIZE = 4096;
+constexpr size_t SMALL_RUN_SIZE = 256;
+
+// Decode [i, cut) in runs that begin and end on sequence boundaries
+__attribute__((target("avx2,popcnt")))
+void decode_runs(const unsigned char* p, size_t i, size_t cut, size_t len, size_t run_size,
+                 Utf8State& state, Utf8Counts& counts) {
+    Avx2Validator validator;
+    while (i < cut && state.bytes_needed == 0) {
+        // Runs end right before a non-continuation byte
+        size_t end = std::min(cut, i + run_size);
+        while (end < cut && is_continuation(p[end])) {
+            ++end;
+        }
+        if (validator.validate(p + i, end - i)) {
+            counts.code_points += (end - i) - validator.continuation_bytes;
+        } else if (run_size > SMALL_RUN_SIZE) {
+            decode_runs(p, i, end, len, SMALL_RUN_SIZE, state, counts);
+        } else {
+            decode_scalar(p + i, end - i, state, counts);
+            if (state.bytes_needed != 0 && end < len) {
+                // The next byte starts a new sequence, so this one is truncated
+                reset(state);
+                ++counts.invalid;
+            }
+        }
+        i = end;
+    }
+}
+
+__attribute__((target("avx2,popcnt")))
+void decode_avx2(const unsigned char* p, size_t len, Utf8State& state, Utf8Counts& counts) {
+    size_t i = 0;
+    // Finish a sequence left open by the previous piece
+    while (i < len && state.bytes_needed != 0) {
+        decode_scalar(p + i, 1, state, counts);
+        ++i;
+    }
+
+    // Leave a possibly unfinished sequence at the end to the scalar decoder
+    size_t cut = len;
+    for (size_t k = 1; k <= 4 && k <= len - i; ++k) {
+        const unsigned char c = p[len - k];
+        if (c >= 0xC0) {
+            cut = len - k;
+            break;
+        }
+        if (c < 0x80) {
+            break;
+        }
+    }
+
+    decode_runs(p, i, cut, len, RUN_SIZE, state, counts);
+    decode_scalar(p + cut, len - cut, state, counts);
+}
+
+bool cpu_has_avx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+
+#endif // CLI_TOOLS_HAVE_X86_SIMD
+
+} // anonymous namespace
+
+Utf8Counts count_utf8(const char* data, size_t len, Utf8State& state) {
+    Utf8Counts counts;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+#ifdef CLI_TOOLS_HAVE_X86_SIMD
+    if (cpu_has_avx2()) {
+        decode_avx2(p, len, state, counts);
+    } else {
+        decode_ascii_fast(p, len, state, counts);
+    }
+#else
+    decode_scalar(p, len, state, counts);
+#endif
+    return counts;
+}
+
+Utf8Counts finish_utf8(Utf8State& state) {
+    Utf8Counts counts;
+    if (state.bytes_needed != 0) {
+        ++counts.invalid;
+    }
+    reset(state);
+    return counts;
+}
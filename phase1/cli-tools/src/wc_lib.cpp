@@ -22,14 +22,193 @@
  */
 
 #include "wc.h"
+#include "simd_search.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <future>
 #include <iostream>
-#include <fstream>
-#include <string>
+#include <memory>
 #include <sstream>
-#include <algorithm>
-#include <cctype>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+inline bool is_space_byte(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Count bytes [offset, offset + length) of a file with pread
+WcResult count_range(int fd, off_t offset, size_t length, bool count_code_points) {
+    std::unique_ptr<char[]> buffer(new char[std::min(length, WC_BUFFER_SIZE)]);
+    WcCounter counter(count_code_points);
+    while (length > 0) {
+        ssize_t n = ::pread(fd, buffer.get(), std::min(length, WC_BUFFER_SIZE), offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            // Read error, or the file shrank while it was being counted
+            return WcResult{0, 0, 0, n == 0};
+        }
+        counter.update(buffer.get(), static_cast<size_t>(n));
+        offset += n;
+        length -= static_cast<size_t>(n);
+    }
+    return counter.result();
+}
+
+// Move a chunk boundary past continuation bytes so it does not split a
+// UTF-8 sequence (at most 3 bytes)
+size_t align_to_sequence(int fd, size_t pos, size_t size) {
+    unsigned char bytes[3];
+    ssize_t n = ::pread(fd, bytes, std::min<size_t>(3, size - pos), static_cast<off_t>(pos));
+    for (ssize_t k = 0; k < n && (bytes[k] & 0xC0) == 0x80; ++k) {
+        ++pos;
+    }
+    return pos;
+}
+
+// Count bytes [begin, end) of a file, nominally; both boundaries are moved
+// past continuation bytes exactly as the neighbouring chunks move them, so
+// no UTF-8 sequence is split. The file is opened for the duration of the
+// chunk only, so the number of open descriptors is bounded by the number of
+// workers, not the number of files.
+WcResult count_file_range(const std::filesystem::path& path, size_t begin, size_t end, size_t size,
+                          bool count_code_points, std::atomic<bool>& open_failed) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        open_failed = true;
+        return WcResult{0, 0, 0, false};
+    }
+    if (begin > 0) {
+        begin = align_to_sequence(fd, begin, size);
+    }
+    if (end < size) {
+        end = align_to_sequence(fd, end, size);
+    }
+    ::posix_fadvise(fd, static_cast<off_t>(begin), static_cast<off_t>(end - begin), POSIX_FADV_SEQUENTIAL);
+    WcResult result = count_range(fd, static_cast<off_t>(begin), end - begin, count_code_points);
+    ::close(fd);
+    return result;
+}
+
+// Count a file that cannot be split (pipe, character device) sequentially
+WcResult count_stream(const std::filesystem::path& path, bool count_code_points, std::atomic<bool>& open_failed) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        open_failed = true;
+        return WcResult{0, 0, 0, false};
+    }
+    std::ostringstream ignored;  // Reported by the caller from the success flag
+    WcResult result = wc_fd(fd, ignored, count_code_points);
+    ::close(fd);
+    return result;
+}
 
-WcResult wc_file(const std::filesystem::path& filepath, std::ostream& out) {
+// Per-file state while its chunks are being counted
+struct WcFileJob {
+    std::string error;
+    std::atomic<bool> open_failed{false};
+    std::vector<std::future<WcResult>> chunks;
+};
+
+} // anonymous namespace
+
+WcResult wc_merge(const WcResult& front, const WcResult& back) {
+    if (front.characters == 0) {
+        WcResult merged = back;
+        merged.success = front.success && back.success;
+        return merged;
+    }
+    if (back.characters == 0) {
+        WcResult merged = front;
+        merged.success = front.success && back.success;
+        return merged;
+    }
+
+    WcResult merged;
+    merged.success = front.success && back.success;
+    merged.characters = front.characters + back.characters;
+    // A word running across the boundary was counted by both pieces
+    merged.words = front.words + back.words - (front.ends_in_word && back.starts_in_word ? 1 : 0);
+    // So was an unterminated last line of the front piece
+    merged.lines = front.lines + back.lines - (front.ends_with_newline ? 0 : 1);
+    merged.starts_in_word = front.starts_in_word;
+    merged.ends_in_word = back.ends_in_word;
+    merged.ends_with_newline = back.ends_with_newline;
+    merged.code_points = front.code_points + back.code_points;
+    merged.invalid_utf8 = front.invalid_utf8 + back.invalid_utf8;
+    return merged;
+}
+
+void WcCounter::update(const char* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    if (bytes_ == 0) {
+        starts_in_word_ = !is_space_byte(static_cast<unsigned char>(data[0]));
+    }
+    LineWordCounts counts = count_lines_and_words(data, size, prev_is_space_);
+    bytes_ += size;
+    newlines_ += counts.newlines;
+    words_ += counts.word_starts;
+    const unsigned char last = static_cast<unsigned char>(data[size - 1]);
+    prev_is_space_ = is_space_byte(last);
+    ends_with_newline_ = last == '\n';
+
+    if (count_code_points_) {
+        Utf8Counts utf8 = count_utf8(data, size, utf8_state_);
+        code_points_ += utf8.code_points;
+        invalid_utf8_ += utf8.invalid;
+    }
+}
+
+WcResult WcCounter::result() const {
+    WcResult result;
+    result.characters = bytes_;
+    result.words = words_;
+    // A final line without a trailing newline still counts as a line
+    result.lines = newlines_ + (bytes_ > 0 && !ends_with_newline_ ? 1 : 0);
+    result.starts_in_word = starts_in_word_;
+    result.ends_in_word = bytes_ > 0 && !prev_is_space_;
+    result.ends_with_newline = ends_with_newline_;
+    if (count_code_points_) {
+        // A sequence still open at the end of the input is truncated
+        Utf8State state = utf8_state_;
+        result.code_points = code_points_;
+        result.invalid_utf8 = invalid_utf8_ + finish_utf8(state).invalid;
+    }
+    return result;
+}
+
+WcResult wc_fd(int fd, std::ostream& out, bool count_code_points) {
+    // Fixed-size buffer: memory stays flat for any input size
+    std::unique_ptr<char[]> buffer(new char[WC_BUFFER_SIZE]);
+    WcCounter counter(count_code_points);
+    while (true) {
+        ssize_t n = ::read(fd, buffer.get(), WC_BUFFER_SIZE);
+        if (n == 0) {
+            break;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            out << "Error: Could not read input (" << std::strerror(errno) << ")" << std::endl;
+            return WcResult{0, 0, 0, false};
+        }
+        counter.update(buffer.get(), static_cast<size_t>(n));
+    }
+    return counter.result();
+}
+
+WcResult wc_file(const std::filesystem::path& filepath, std::ostream& out, bool count_code_points) {
     // Check if file exists
     if (!std::filesystem::exists(filepath)) {
         out << "Error: File does not exist: " << filepath << std::endl;
@@ -37,40 +216,91 @@ WcResult wc_file(const std::filesystem::path& filepath, std::ostream& out) {
     }
 
     // Open file
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
         out << "Error: Could not open file: " << filepath << std::endl;
         return WcResult{0, 0, 0, false};
     }
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
 
-    // Read file content
-    std::string content((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
+    // Count lines, words, and characters while streaming the file
+    WcResult result = wc_fd(fd, out, count_code_points);
+    ::close(fd);
+    return result;
+}
 
-    // Count lines, words, and characters
-    return wc_text(content);
+WcResult wc_text(const std::string& text, bool count_code_points) {
+    WcCounter counter(count_code_points);
+    counter.update(text.data(), text.size());
+    return counter.result();
 }
 
-WcResult wc_text(const std::string& text) {
-    WcResult result;
-    result.success = true;  // Text processing always succeeds
+std::vector<WcResult> wc_parallel(const std::vector<std::filesystem::path>& files, std::ostream& out,
+                                  size_t num_threads, size_t chunk_size, bool count_code_points) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (chunk_size == 0) {
+        chunk_size = DEFAULT_WC_CHUNK_SIZE;
+    }
 
-    // Count characters
-    result.characters = text.length();
+    std::vector<WcFileJob> jobs(files.size());
+    cli_tools::ThreadPool pool(num_threads);
 
-    // Count lines
-    result.lines = std::count(text.begin(), text.end(), '\n');
-    // If the text doesn't end with a newline, we need to add one more line
-    if (!text.empty() && text.back() != '\n') {
-        result.lines++;
-    }
+    // Enqueue the chunks of every file; workers open a file only while
+    // counting one of its chunks, so any number of files can be given
+    for (size_t i = 0; i < files.size(); ++i) {
+        WcFileJob& job = jobs[i];
+        if (!std::filesystem::exists(files[i])) {
+            job.error = "Error: File does not exist: ";
+            continue;
+        }
+        struct stat st;
+        if (::stat(files[i].c_str(), &st) != 0) {
+            job.error = "Error: Could not open file: ";
+            continue;
+        }
 
-    // Count words
-    std::istringstream stream(text);
-    std::string word;
-    while (stream >> word) {
-        result.words++;
+        if (!S_ISREG(st.st_mode)) {
+            // Not seekable: one worker reads it sequentially
+            job.chunks.push_back(pool.Enqueue([&path = files[i], &job, count_code_points]() {
+                return count_stream(path, count_code_points, job.open_failed);
+            }));
+            continue;
+        }
+        // At least one chunk, so an empty file is still checked for readability
+        const size_t size = static_cast<size_t>(st.st_size);
+        size_t pos = 0;
+        do {
+            const size_t end = std::min(pos + chunk_size, size);
+            job.chunks.push_back(pool.Enqueue([&path = files[i], &job, pos, end, size, count_code_points]() {
+                return count_file_range(path, pos, end, size, count_code_points, job.open_failed);
+            }));
+            pos = end;
+        } while (pos < size);
     }
 
-    return result;
-}
\ No newline at end of file
+    // Combine the chunks of each file in order
+    std::vector<WcResult> results(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        WcFileJob& job = jobs[i];
+        if (!job.error.empty()) {
+            out << job.error << files[i] << std::endl;
+            results[i].success = false;
+        } else {
+            WcResult total;
+            for (auto& chunk : job.chunks) {
+                total = wc_merge(total, chunk.get());
+            }
+            if (job.open_failed) {
+                out << "Error: Could not open file: " << files[i] << std::endl;
+                total = WcResult{0, 0, 0, false};
+            } else if (!total.success) {
+                out << "Error: Could not read file: " << files[i] << std::endl;
+                total = WcResult{0, 0, 0, false};
+            }
+            results[i] = total;
+        }
+    }
+    return results;
+}
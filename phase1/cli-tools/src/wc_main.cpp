@@ -2,7 +2,7 @@
  * my_wc: A simplified version of the 'wc' command.
  *
  * How to Run with Docker (builds and runs automatically):
- *   ./scripts/docker-dev.sh run-wc [options] [file]
+ *   ./scripts/docker-dev.sh run-wc [options] [file...]
  *
  * How to Compile and Run manually in Docker:
  *   1. Enter the Docker container:
@@ -12,14 +12,14 @@
  *      cmake ..
  *      make
  *   3. Run the executable:
- *      ./phase1/cli-tools/my_wc [options] [file]
+ *      ./phase1/cli-tools/my_wc [options] [file...]
  *
  * How to Compile without Docker (from project root):
  *   1. cmake -S . -B build
  *   2. cmake --build build -- -j
  *
  * How to Run without Docker:
- *   ./build/phase1/cli-tools/my_wc [options] [file]
+ *   ./build/phase1/cli-tools/my_wc [options] [file...]
  *
  * Usage Examples:
  *   - Count lines, words, and characters in a file:
@@ -34,6 +34,12 @@
  *   - Count only characters in a file:
  *     ./build/phase1/cli-tools/my_wc -c file.txt
  *
+ *   - Count UTF-8 characters (code points) instead of bytes:
+ *     ./build/phase1/cli-tools/my_wc -m file.txt
+ *
+ *   - Count several files on 4 threads, splitting large files into chunks:
+ *     ./build/phase1/cli-tools/my_wc -j 4 big1.log big2.log
+ *
  *   - Count from standard input:
  *     echo "Hello world" | ./build/phase1/cli-tools/my_wc
  * 
@@ -46,23 +52,63 @@
  */
 
 #include "wc.h"
+#include "output_writer.h"
 #include <iostream>
 #include <filesystem>
 #include <string>
+#include <unistd.h>
+#include <vector>
 
 void print_usage(const char* program_name) {
-    std::cout << "Usage: " << program_name << " [-lwc] [file]\n"
+    std::cout << "Usage: " << program_name << " [-lwmc] [-j N] [file...]\n"
               << "  -l\tCount lines\n"
               << "  -w\tCount words\n"
-              << "  -c\tCount characters\n"
+              << "  -m\tCount UTF-8 characters (code points)\n"
+              << "  -c\tCount characters (bytes)\n"
+              << "  -j N\tCount with N worker threads (0 = all cores)\n"
               << "  --help\tDisplay this help message\n";
 }
 
+// Print the selected counts, followed by the name if there is one
+void print_counts(std::ostream& out, const WcResult& result, const std::string& name,
+                  bool count_lines, bool count_words, bool count_code_points, bool count_chars) {
+    bool needs_space = false;
+    if (count_lines) {
+        if (needs_space) out << " ";
+        out << result.lines;
+        needs_space = true;
+    }
+    if (count_words) {
+        if (needs_space) out << " ";
+        out << result.words;
+        needs_space = true;
+    }
+    if (count_code_points) {
+        if (needs_space) out << " ";
+        out << result.code_points;
+        needs_space = true;
+    }
+    if (count_chars) {
+        if (needs_space) out << " ";
+        out << result.characters;
+        needs_space = true;
+    }
+
+    // Print filename if a file was specified
+    if (!name.empty()) {
+        out << " " << name;
+    }
+
+    out << '\n';
+}
+
 int main(int argc, char* argv[]) {
     bool count_lines = false;
     bool count_words = false;
+    bool count_code_points = false;
     bool count_chars = false;
-    std::string filepath;
+    size_t num_threads = 1;
+    std::vector<std::filesystem::path> files;
 
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -71,64 +117,77 @@ int main(int argc, char* argv[]) {
             count_lines = true;
         } else if (arg == "-w") {
             count_words = true;
+        } else if (arg == "-m") {
+            count_code_points = true;
         } else if (arg == "-c") {
             count_chars = true;
+        } else if (arg == "-j" && i + 1 < argc) {
+            try {
+                num_threads = std::stoul(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid thread count: " << argv[i] << std::endl;
+                return 1;
+            }
         } else if (arg == "--help") {
             print_usage(argv[0]);
             return 0;
-        } else if (filepath.empty()) {
-            filepath = arg;
-        } else {
-            std::cerr << "Usage: " << argv[0] << " [-lwc] [file]" << std::endl;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Usage: " << argv[0] << " [-lwmc] [-j N] [file...]" << std::endl;
             return 1;
+        } else {
+            files.push_back(arg);
         }
     }
 
     // If no options are specified, enable all counts
-    if (!count_lines && !count_words && !count_chars) {
+    if (!count_lines && !count_words && !count_code_points && !count_chars) {
         count_lines = count_words = count_chars = true;
     }
 
-    WcResult result;
+    std::vector<WcResult> results;
 
     // If no file is specified, read from standard input
-    if (filepath.empty()) {
-        std::string content((std::istreambuf_iterator<char>(std::cin)),
-                            std::istreambuf_iterator<char>());
-        result = wc_text(content);
-    } else {
-        // Count from file
-        result = wc_file(filepath, std::cerr);
-        // If there was an error, exit with error code
-        if (!result.success) {
-            return 1;
+    if (files.empty()) {
+        results.push_back(wc_fd(STDIN_FILENO, std::cerr, count_code_points));
+    } else if (num_threads == 1) {
+        // Count the files one after another
+        for (const auto& file : files) {
+            results.push_back(wc_file(file, std::cerr, count_code_points));
         }
+    } else {
+        // Split large files into chunks and count them on a worker pool
+        results = wc_parallel(files, std::cerr, num_threads, DEFAULT_WC_CHUNK_SIZE, count_code_points);
     }
 
     // Print results based on selected options
-    bool needs_space = false;
-    if (count_lines) {
-        if (needs_space) std::cout << " ";
-        std::cout << result.lines;
-        needs_space = true;
-    }
-    if (count_words) {
-        if (needs_space) std::cout << " ";
-        std::cout << result.words;
-        needs_space = true;
+    OutputWriter writer(STDOUT_FILENO, OutputWriter::default_policy_for(STDOUT_FILENO));
+    std::ostream& out = writer.stream();
+    bool success = true;
+    WcResult total;
+    for (size_t i = 0; i < results.size(); ++i) {
+        // If there was an error, skip the file and exit with an error code
+        if (!results[i].success) {
+            success = false;
+            continue;
+        }
+        const std::string name = files.empty() ? std::string() : files[i].string();
+        if (results[i].invalid_utf8 > 0) {
+            std::cerr << "Warning: " << results[i].invalid_utf8 << " invalid UTF-8 sequence(s) in "
+                      << (name.empty() ? std::string("standard input") : name) << std::endl;
+        }
+        print_counts(out, results[i], name, count_lines, count_words, count_code_points, count_chars);
+        // Separate files are summed, not merged: no word spans two files
+        total.lines += results[i].lines;
+        total.words += results[i].words;
+        total.characters += results[i].characters;
+        total.code_points += results[i].code_points;
     }
-    if (count_chars) {
-        if (needs_space) std::cout << " ";
-        std::cout << result.characters;
-        needs_space = true;
+    if (files.size() > 1) {
+        print_counts(out, total, "total", count_lines, count_words, count_code_points, count_chars);
     }
 
-    // Print filename if a file was specified
-    if (!filepath.empty()) {
-        std::cout << " " << filepath;
+    if (!writer.flush()) {
+        return 1;
     }
-
-    std::cout << std::endl;
-
-    return 0;
-}
\ No newline at end of file
+    return success ? 0 : 1;
+}
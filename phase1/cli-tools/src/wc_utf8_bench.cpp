@@ -0,0 +1,211 @@
+/*
+ * wc_utf8_bench: Throughput benchmark for UTF-8 code point counting.
+ *
+ * Builds in-memory corpora with different mixes of ASCII and CJK text and
+ * compares, per corpus:
+ *   - wc_text byte counting (lines, words, bytes)
+ *   - wc_text with code point counting (-m)
+ *   - count_utf8 alone (vectorized validation and counting)
+ *   - a straightforward scalar decoder, for reference
+ * The code point and error counts of the two decoders are cross-checked.
+ *
+ * How to Compile without Docker (from project root):
+ *   1. cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+ *   2. cmake --build build --target wc_utf8_bench -- -j
+ *
+ * How to Run without Docker:
+ *   ./build/phase1/cli-tools/wc_utf8_bench [size_mb]
+ *
+ * Usage Examples:
+ *   - Default run (64 MB per corpus):
+ *     ./build/phase1/cli-tools/wc_utf8_bench
+ *
+ *   - 256 MB per corpus:
+ *     ./build/phase1/cli-tools/wc_utf8_bench 256
+ */
+
+#include "utf8.h"
+#include "wc.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Append the UTF-8 encoding of a code point
+void append_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Log-like lines; cjk_percent of the message words are CJK, and one line in
+// invalid_every (0 = never) carries a stray invalid byte
+std::string generate_corpus(uint64_t target_bytes, int cjk_percent, int invalid_every) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<uint32_t> cjk(0x4E00, 0x9FFF);
+    std::uniform_int_distribution<int> word_length(2, 8);
+    std::string text;
+    text.reserve(target_bytes + 256);
+    uint64_t seq = 0;
+    while (text.size() < target_bytes) {
+        text += "2024-05-01T12:00:00Z INFO user=";
+        text += std::to_string(seq % 9973);
+        for (int w = 0; w < 8; ++w) {
+            text += ' ';
+            const bool use_cjk = percent(rng) < cjk_percent;
+            const int length = word_length(rng);
+            for (int k = 0; k < length; ++k) {
+                if (use_cjk) {
+                    append_utf8(text, cjk(rng));
+                } else {
+                    text += static_cast<char>('a' + (seq + k) % 26);
+                }
+            }
+        }
+        if (invalid_every > 0 && seq % invalid_every == 0) {
+            text += " \xC3(";
+        }
+        text += '\n';
+        ++seq;
+    }
+    return text;
+}
+
+// Reference: decode one sequence at a time with explicit range checks
+Utf8Counts count_utf8_reference(const std::string& text) {
+    Utf8Counts counts;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    const size_t n = text.size();
+    size_t i = 0;
+    while (i < n) {
+        const unsigned char b = p[i];
+        size_t need = 0;
+        unsigned char lo = 0x80, hi = 0xBF;
+        if (b < 0x80) {
+            ++counts.code_points;
+            ++i;
+            continue;
+        } else if (b >= 0xC2 && b <= 0xDF) {
+            need = 1;
+        } else if (b >= 0xE0 && b <= 0xEF) {
+            need = 2;
+            lo = b == 0xE0 ? 0xA0 : 0x80;
+            hi = b == 0xED ? 0x9F : 0xBF;
+        } else if (b >= 0xF0 && b <= 0xF4) {
+            need = 3;
+            lo = b == 0xF0 ? 0x90 : 0x80;
+            hi = b == 0xF4 ? 0x8F : 0xBF;
+        } else {
+            ++counts.invalid;
+            ++i;
+            continue;
+        }
+        size_t k = 1;
+        for (; k <= need && i + k < n; ++k) {
+            const unsigned char c = p[i + k];
+            if (c < lo || c > hi) {
+                break;
+            }
+            lo = 0x80;
+            hi = 0xBF;
+        }
+        if (k > need) {
+            ++counts.code_points;
+        } else {
+            ++counts.invalid;
+        }
+        i += k;
+    }
+    return counts;
+}
+
+double time_seconds(const std::function<void()>& work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& name, double seconds, uint64_t input_bytes, double baseline_seconds) {
+    double mb = static_cast<double>(input_bytes) / (1024.0 * 1024.0);
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(8) << seconds << " s"
+              << std::setprecision(1) << std::setw(10) << mb / seconds << " MB/s"
+              << std::setprecision(2) << std::setw(8) << baseline_seconds / seconds << "x" << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t size_mb = 64;
+    if (argc > 1) {
+        size_mb = std::stoull(argv[1]);
+    }
+
+    struct Corpus {
+        const char* name;
+        int cjk_percent;
+        int invalid_every;
+    };
+    const std::vector<Corpus> corpora = {
+        {"ASCII", 0, 0},
+        {"mixed (25% CJK words)", 25, 0},
+        {"CJK-heavy (90% CJK words)", 90, 0},
+        {"mixed with invalid bytes", 25, 100},
+    };
+
+    bool all_match = true;
+    for (const Corpus& corpus : corpora) {
+        const std::string text = generate_corpus(size_mb * 1024 * 1024, corpus.cjk_percent, corpus.invalid_every);
+        std::cout << corpus.name << ": " << text.size() << " bytes" << std::endl;
+
+        WcResult bytes_result;
+        double bytes_seconds = time_seconds([&] { bytes_result = wc_text(text); });
+        report("wc bytes (-lwc)", bytes_seconds, text.size(), bytes_seconds);
+
+        WcResult utf8_result;
+        double wc_m_seconds = time_seconds([&] { utf8_result = wc_text(text, true); });
+        report("wc code points (-lwmc)", wc_m_seconds, text.size(), bytes_seconds);
+
+        Utf8Counts kernel;
+        double kernel_seconds = time_seconds([&] {
+            Utf8State state;
+            kernel = count_utf8(text.data(), text.size(), state);
+            kernel.invalid += finish_utf8(state).invalid;
+        });
+        report("count_utf8 only", kernel_seconds, text.size(), bytes_seconds);
+
+        Utf8Counts reference;
+        double reference_seconds = time_seconds([&] { reference = count_utf8_reference(text); });
+        report("scalar reference decoder", reference_seconds, text.size(), bytes_seconds);
+
+        std::cout << "  code points=" << utf8_result.code_points << " invalid=" << utf8_result.invalid_utf8
+                  << " bytes=" << bytes_result.characters << std::endl;
+        if (kernel.code_points != reference.code_points || kernel.invalid != reference.invalid ||
+            utf8_result.code_points != reference.code_points) {
+            std::cout << "  [RESULT MISMATCH] reference code points=" << reference.code_points
+                      << " invalid=" << reference.invalid << std::endl;
+            all_match = false;
+        }
+    }
+    return all_match ? 0 : 1;
+}
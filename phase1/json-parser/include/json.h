@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <variant>
 #include <vector>
@@ -14,23 +15,35 @@ class JsonValue;
 using JsonArray = std::vector<JsonValue>;
 using JsonObject = std::map<std::string, JsonValue>;
 
+// Output options for JsonValue::write
+struct JsonWriteOptions {
+    bool pretty = false;   // Newlines and indentation, "key": value
+    int indent = 2;        // Spaces per nesting level when pretty
+};
+
 // JsonValue type - can be one of the following:
 // null, boolean, number, string, array, object
+// Numbers are held as int64_t when they are integers that fit, so 64-bit IDs
+// survive a round trip; everything else is a double.
 class JsonValue {
 public:
     // Types that JsonValue can hold
-    using ValueType = std::variant<std::nullptr_t, bool, double, std::string, JsonArray, JsonObject>;
+    using ValueType = std::variant<std::nullptr_t, bool, int64_t, double, std::string, JsonArray, JsonObject>;
 
     // Constructors for different types
     JsonValue();
     JsonValue(std::nullptr_t);
     JsonValue(bool value);
     JsonValue(int value);
+    JsonValue(int64_t value);
     JsonValue(double value);
     JsonValue(const std::string& value);
+    JsonValue(std::string&& value);
     JsonValue(const char* value);
     JsonValue(const JsonArray& value);
+    JsonValue(JsonArray&& value);
     JsonValue(const JsonObject& value);
+    JsonValue(JsonObject&& value);
 
     // Copy and move constructors/operators
     JsonValue(const JsonValue& other);
@@ -44,14 +57,16 @@ public:
     // Type checking
     bool is_null() const;
     bool is_bool() const;
-    bool is_number() const;
+    bool is_number() const;     // Integer or floating point
+    bool is_integer() const;    // Held exactly as int64_t
     bool is_string() const;
     bool is_array() const;
     bool is_object() const;
 
     // Value accessors - will throw std::bad_variant_access if type doesn't match
     bool as_bool() const;
-    double as_number() const;
+    double as_number() const;   // Integers are converted
+    int64_t as_int64() const;
     const std::string& as_string() const;
     const JsonArray& as_array() const;
     const JsonObject& as_object() const;
@@ -73,11 +88,15 @@ public:
     // Serialization
     std::string to_string() const;
 
+    // Append the JSON text to out in one pass. Reusing the same string
+    // across calls reuses its capacity, so steady-state writes do not allocate.
+    void write(std::string& out, const JsonWriteOptions& options = {}) const;
+
+    // Write the JSON text to a stream through a fixed-size staging buffer
+    void write(std::ostream& out, const JsonWriteOptions& options = {}) const;
+
 private:
     ValueType value_;
-
-    // Helper for serialization
-    std::string serialize_value() const;
 };
 
 // Parse a JSON string into a JsonValue
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+
+class JsonArena;
+
+// Internal helpers shared by the parser implementations; not part of the public API
+namespace json_parser {
+
+// Unescape the body of a JSON string (between the quotes) into the arena.
+// \u escapes are decoded to UTF-8. Throws std::runtime_error on a bad escape.
+std::string_view UnescapeString(const char* begin, const char* end, JsonArena& arena);
+
+// True if [p, end) is exactly one number: -?digits(.digits)?([eE][+-]?digits)?
+bool IsValidNumber(const char* p, const char* end);
+
+// Exact integer fast path for a valid number [first, last): true if it has no
+// fraction or exponent and fits in int64_t. -0 is left to the double path so
+// the sign survives.
+inline bool ParseInt64(const char* first, const char* last, int64_t& value) {
+    if (last - first == 2 && first[0] == '-' && first[1] == '0') {
+        return false;
+    }
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    return ec == std::errc() && ptr == last;
+}
+
+} // namespace json_parser
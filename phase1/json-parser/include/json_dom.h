@@ -0,0 +1,156 @@
+#pragma once
+
+#include "json.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Bump allocator backing a JsonDocument. Memory is carved out of large blocks
+// and released all at once, so a document of a million nodes costs a few
+// dozen heap allocations instead of a million.
+class JsonArena {
+public:
+    explicit JsonArena(size_t block_size = 64 * 1024);
+
+    JsonArena(const JsonArena&) = delete;
+    JsonArena& operator=(const JsonArena&) = delete;
+    // Moving leaves the source empty: it starts a fresh block on its next allocate()
+    JsonArena(JsonArena&& other) noexcept;
+    JsonArena& operator=(JsonArena&& other) noexcept;
+
+    // Allocate size bytes aligned to align (a power of two)
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+    // Allocate uninitialized storage for count objects of type T
+    template <typename T>
+    T* allocate_array(size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Drop everything allocated so far, keeping the first block for reuse
+    void reset();
+
+    // Bytes handed out since construction or the last reset
+    size_t bytes_used() const { return bytes_used_; }
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+    size_t block_size_;
+    size_t bytes_used_ = 0;
+};
+
+struct JsonMember;
+
+// Read-only DOM node. Strings are views into the parsed input, or into the
+// arena when they contained escapes; arrays and objects are flat arrays of
+// nodes and key/value members in the arena, in document order.
+class JsonNode {
+public:
+    enum class Type : uint8_t { Null, Bool, Number, String, Array, Object };
+
+    JsonNode() : type_(Type::Null), is_integer_(false), size_(0), number_(0) {}
+
+    // Node construction; the referenced storage must outlive the node
+    static JsonNode make_null() { return JsonNode(); }
+    static JsonNode make_bool(bool value);
+    static JsonNode make_number(double value);
+    static JsonNode make_integer(int64_t value);
+    static JsonNode make_string(std::string_view value);
+    static JsonNode make_array(const JsonNode* elements, size_t count);
+    static JsonNode make_object(const JsonMember* members, size_t count);
+
+    // Type checking
+    Type type() const { return type_; }
+    bool is_null() const { return type_ == Type::Null; }
+    bool is_bool() const { return type_ == Type::Bool; }
+    bool is_number() const { return type_ == Type::Number; }
+    bool is_integer() const { return type_ == Type::Number && is_integer_; }
+    bool is_string() const { return type_ == Type::String; }
+    bool is_array() const { return type_ == Type::Array; }
+    bool is_object() const { return type_ == Type::Object; }
+
+    // Value accessors - will throw std::bad_variant_access if type doesn't match
+    bool as_bool() const;
+    double as_number() const;   // Integers are converted
+    int64_t as_int64() const;
+    std::string_view as_string() const;
+    std::span<const JsonNode> as_array() const;
+    std::span<const JsonMember> as_object() const;
+
+    // Number of elements or members; 0 for scalars
+    size_t size() const { return is_array() || is_object() ? size_ : 0; }
+
+    // Array/Object element access - throw std::out_of_range like JsonValue
+    const JsonNode& operator[](size_t index) const;
+    const JsonNode& operator[](std::string_view key) const;
+
+    // Object member lookup by linear scan; nullptr if absent. With duplicate
+    // keys the last one wins, as in parse_json.
+    const JsonNode* find(std::string_view key) const;
+
+    // Deep copy into the std::map/std::vector based JsonValue
+    JsonValue to_value() const;
+
+private:
+    Type type_;
+    bool is_integer_;  // Number held exactly in integer_
+    uint32_t size_;    // String length, element or member count
+    union {
+        bool boolean_;
+        double number_;
+        int64_t integer_;
+        const char* chars_;
+        const JsonNode* elements_;
+        const JsonMember* members_;
+    };
+};
+
+struct JsonMember {
+    std::string_view key;
+    JsonNode value;
+};
+
+// Result of parse_json_document(). Owns the arena holding the nodes and,
+// for parse_json_document_file(), the memory mapping of the input.
+class JsonDocument {
+public:
+    JsonDocument() = default;
+    JsonDocument(JsonDocument&& other) noexcept;
+    JsonDocument& operator=(JsonDocument&& other) noexcept;
+    ~JsonDocument();
+
+    const JsonNode& root() const { return root_; }
+    const JsonArena& arena() const { return arena_; }
+
+    // The text the node strings point into
+    std::string_view input() const { return input_; }
+
+private:
+    friend JsonDocument parse_json_document(std::string_view json_text);
+    friend JsonDocument parse_json_document_file(const std::string& filepath);
+
+    JsonArena arena_;
+    JsonNode root_;
+    std::string_view input_;
+    void* mapping_ = nullptr;   // mmap of the input file, if any
+    size_t mapping_size_ = 0;
+};
+
+// Parse JSON text into an arena-backed document without copying it. The text
+// must stay alive and unchanged for as long as the document is used.
+// Throws std::runtime_error on malformed input, like parse_json.
+JsonDocument parse_json_document(std::string_view json_text);
+
+// Memory-map a JSON file and parse it; the document keeps the mapping alive
+JsonDocument parse_json_document_file(const std::string& filepath);
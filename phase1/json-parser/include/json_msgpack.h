@@ -0,0 +1,119 @@
+#pragma once
+
+#include "json.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Binary encoding of JsonValue in MessagePack (https://msgpack.org): every
+// value starts with a one-byte marker, small integers, strings and containers
+// fit their size into that byte, and strings are stored as raw bytes, so
+// decoding needs no escaping, number parsing or whitespace skipping.
+//
+// Integers use the smallest int encoding that holds them; doubles are stored
+// as float32 when that is exact and float64 otherwise.
+
+// Append the encoding of value to out
+void encode_msgpack(const JsonValue& value, std::string& out);
+std::string encode_msgpack(const JsonValue& value);
+
+// Decode exactly one value occupying all of bytes.
+// Throws std::runtime_error on truncated or malformed data.
+JsonValue decode_msgpack(std::string_view bytes);
+
+// Read-only view of an encoded value, navigated in place: nothing is decoded
+// or copied until asked for, strings come back as views into the buffer, and
+// element/member lookup steps over siblings using only their headers. The
+// buffer must outlive the view.
+//
+// Malformed data throws std::runtime_error when it is reached.
+class MsgPackView {
+public:
+    enum class Type : uint8_t { Null, Bool, Number, String, Array, Object };
+
+    // View of the value at the start of bytes
+    explicit MsgPackView(std::string_view bytes);
+
+    // Type checking
+    Type type() const { return type_; }
+    bool is_null() const { return type_ == Type::Null; }
+    bool is_bool() const { return type_ == Type::Bool; }
+    bool is_number() const { return type_ == Type::Number; }
+    bool is_integer() const { return type_ == Type::Number && !is_float_; }
+    bool is_string() const { return type_ == Type::String; }
+    bool is_array() const { return type_ == Type::Array; }
+    bool is_object() const { return type_ == Type::Object; }
+
+    // Value accessors - will throw std::bad_variant_access if type doesn't match
+    bool as_bool() const;
+    double as_number() const;   // Integers are converted
+    int64_t as_int64() const;
+    std::string_view as_string() const;
+
+    // Number of elements or members; 0 for scalars
+    size_t size() const { return is_array() || is_object() ? static_cast<size_t>(length_) : 0; }
+
+    // Array/Object element access - throw std::out_of_range like JsonValue.
+    // Each lookup steps over the preceding siblings, so prefer the
+    // for_each_* functions to visit every child.
+    MsgPackView operator[](size_t index) const;
+    MsgPackView operator[](std::string_view key) const;
+
+    // Object member lookup; false if absent
+    bool find(std::string_view key, MsgPackView& value) const;
+
+    // Call f(MsgPackView) for each array element, in order
+    template <typename F>
+    void for_each_element(F&& f) const {
+        const uint8_t* p = ChildrenBegin(Type::Array);
+        for (uint64_t i = 0; i < length_; ++i) {
+            MsgPackView element(p, end_);
+            p = element.Next();
+            f(element);
+        }
+    }
+
+    // Call f(std::string_view key, MsgPackView value) for each member, in order
+    template <typename F>
+    void for_each_member(F&& f) const {
+        const uint8_t* p = ChildrenBegin(Type::Object);
+        for (uint64_t i = 0; i < length_; ++i) {
+            MsgPackView key(p, end_);
+            if (!key.is_string()) {
+                throw std::runtime_error("Expected string key in MessagePack map");
+            }
+            MsgPackView value(key.Next(), end_);
+            p = value.Next();
+            f(key.as_string(), value);
+        }
+    }
+
+    // The encoded bytes of this value
+    std::string_view bytes() const;
+
+    // Decode this value and everything below it
+    JsonValue to_value() const;
+
+private:
+    friend JsonValue decode_msgpack(std::string_view bytes);
+
+    const uint8_t* start_;     // Marker byte
+    const uint8_t* payload_;   // First byte after the header
+    const uint8_t* end_;       // End of the whole buffer
+    uint64_t length_ = 0;      // String bytes, element or member count, or integer bits
+    double float_ = 0;
+    Type type_ = Type::Null;
+    bool is_float_ = false;
+
+    MsgPackView(const uint8_t* p, const uint8_t* end);
+
+    const uint8_t* ChildrenBegin(Type type) const;
+
+    // First byte after this value, including any children
+    const uint8_t* Next() const;
+
+    // Decode, leaving next at the first byte after this value
+    JsonValue ToValue(const uint8_t*& next, int depth) const;
+};
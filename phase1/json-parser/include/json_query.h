@@ -0,0 +1,49 @@
+#pragma once
+
+#include "json.h"
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A compiled path into a JSON document, evaluated lazily: the text is scanned
+// only as far as the target value, and every subtree off the path is skipped
+// by matching braces and brackets, without building any nodes. Build the path
+// once and reuse it across documents.
+//
+// Skipped subtrees are not validated. Values on the path are, and malformed
+// input there throws std::runtime_error like parse_json. When an object has
+// duplicate keys the first one is used, so the query can stop early.
+class JsonPointer {
+public:
+    // JSON Pointer (RFC 6901): "" is the whole document, "/request/headers/host"
+    // a nested member, "/items/0" an array element; "~1" stands for '/' and
+    // "~0" for '~' inside a token. Throws std::runtime_error on bad syntax.
+    explicit JsonPointer(std::string_view pointer);
+
+    // Dotted path: "request.headers.host", "items[0].name". Keys containing
+    // '.' or '[' need the JSON Pointer form.
+    static JsonPointer from_path(std::string_view path);
+
+    // The raw text of the value at this path, as a view into json_text
+    // (strings keep their quotes and escapes); std::nullopt if there is no
+    // such value
+    std::optional<std::string_view> find(std::string_view json_text) const;
+
+    // The value at this path, parsed into a JsonValue (\u escapes decoded to
+    // UTF-8, as for parse_json_document())
+    std::optional<JsonValue> get(std::string_view json_text) const;
+
+    // The value at this path if it is a string without escapes, as a view
+    // into json_text without the quotes. Strings with escapes, other types and
+    // missing paths give std::nullopt; use get() for those.
+    std::optional<std::string_view> find_string(std::string_view json_text) const;
+
+    // Unescaped reference tokens, outermost first
+    const std::vector<std::string>& tokens() const { return tokens_; }
+
+private:
+    JsonPointer() = default;
+
+    std::vector<std::string> tokens_;
+};
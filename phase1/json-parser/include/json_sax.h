@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Default size of the JsonStreamReader input buffer
+constexpr size_t DEFAULT_JSON_STREAM_BUFFER_SIZE = 64 * 1024;
+
+// Receives the events of a JsonStreamReader. Every callback returns true to
+// continue or false to stop reading; the defaults ignore the event.
+// String views are only valid for the duration of the callback.
+class JsonHandler {
+public:
+    virtual ~JsonHandler() = default;
+
+    virtual bool on_null() { return true; }
+    virtual bool on_bool(bool) { return true; }
+    virtual bool on_number(double) { return true; }
+    // Integers that fit in int64_t; the default passes them on as doubles
+    virtual bool on_integer(int64_t value) { return on_number(static_cast<double>(value)); }
+    virtual bool on_string(std::string_view) { return true; }
+    virtual bool on_key(std::string_view) { return true; }
+    virtual bool on_start_object() { return true; }
+    virtual bool on_end_object() { return true; }
+    virtual bool on_start_array() { return true; }
+    virtual bool on_end_array() { return true; }
+
+    // Called after each complete top-level value (each record in NDJSON)
+    virtual bool on_end_document() { return true; }
+};
+
+// Event-driven (SAX-style) JSON reader over a std::istream. Input is read
+// through one fixed-size buffer that is refilled as it drains, and nesting
+// is tracked on an explicit stack instead of recursion, so memory use depends
+// on the buffer size, the nesting depth and the longest single string or
+// number, never on the size of the input.
+//
+// Malformed input throws std::runtime_error with the byte offset of the error.
+class JsonStreamReader {
+public:
+    explicit JsonStreamReader(std::istream& in, size_t buffer_size = DEFAULT_JSON_STREAM_BUFFER_SIZE);
+
+    // Read exactly one JSON value followed only by whitespace.
+    // Returns false if the handler stopped the reader.
+    bool parse(JsonHandler& handler);
+
+    // Read newline-delimited JSON: one value per line, blank lines ignored.
+    // Returns the number of records read, stopping early if the handler does.
+    size_t parse_ndjson(JsonHandler& handler);
+
+    // Bytes consumed from the stream so far
+    uint64_t offset() const { return consumed_ + pos_; }
+
+private:
+    std::istream& in_;
+    std::vector<char> buffer_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    uint64_t consumed_ = 0;   // Bytes discarded from the buffer by refills
+    std::vector<bool> stack_; // Open containers; true for objects
+    std::string scratch_;     // Strings with escapes or split across refills
+    std::string number_;      // Numbers split across refills
+
+    bool Refill();
+    int Peek();
+    int Get();
+    void Expect(char c, const char* message);
+    [[noreturn]] void Fail(const std::string& message) const;
+
+    void SkipWhitespace();
+    bool ParseValue(JsonHandler& handler);
+    bool ParseScalar(int c, JsonHandler& handler);
+    std::string_view ParseString();
+    void ParseEscape();
+    bool ParseNumber(JsonHandler& handler);
+    void ParseLiteral(std::string_view literal);
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Timing and reporting helpers shared by the JSON benchmarks
+namespace json_bench {
+
+// Fastest of three runs, so page-fault and allocator warm-up do not favor any variant
+inline double time_seconds(const std::function<void()>& work) {
+    double best = 0;
+    for (int run = 0; run < 3; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        work();
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        best = run == 0 ? seconds : std::min(best, seconds);
+    }
+    return best;
+}
+
+// One result line: time, throughput over bytes and speedup against the baseline
+inline void report(const std::string& name, double seconds, uint64_t bytes, double baseline_seconds) {
+    double mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::cout << std::left << std::setw(34) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(8) << seconds << " s"
+              << std::setprecision(1) << std::setw(10) << mb / seconds << " MB/s"
+              << std::setprecision(2) << std::setw(8) << baseline_seconds / seconds << "x" << std::endl;
+}
+
+} // namespace json_bench
@@ -1,42 +1,162 @@
 #include "json.h"
+#include "json_detail.h"
+#include <array>
+#include <charconv>
 #include <iostream>
 #include <sstream>
-#include <iomanip>
 #include <stdexcept>
 #include <cmath>
-#include <limits>
 #include <fstream>
 
 // Implementation of JsonValue methods
 namespace {
 
-// Helper function to escape special characters in a string for JSON output
-std::string EscapeString(const std::string& str) {
-    std::string result = "\"";
-    for (char c : str) {
-        switch (c) {
-            case '"':  result += "\\\""; break;
-            case '\\': result += "\\\\"; break;
-            case '\b': result += "\\b";  break;
-            case '\f': result += "\\f";  break;
-            case '\n': result += "\\n";  break;
-            case '\r': result += "\\r";  break;
-            case '\t': result += "\\t";  break;
-            default:
-                if (c >= 0 && c < 0x20) {
-                    // Escape control characters
-                    std::ostringstream oss;
-                    oss << "\\u00" << std::hex << std::setw(2) << std::setfill('0') << (int)c;
-                    result += oss.str();
-                } else {
-                    result += c;
+// Size of the staging buffer that JsonValue::write(std::ostream&) fills
+// before each write to the stream
+constexpr size_t kStreamChunkSize = 64 * 1024;
+
+// Bytes that cannot appear unescaped inside a JSON string
+constexpr std::array<bool, 256> kNeedsEscape = [] {
+    std::array<bool, 256> table{};
+    for (int c = 0; c < 0x20; ++c) {
+        table[c] = true;
+    }
+    table['"'] = true;
+    table['\\'] = true;
+    return table;
+}();
+
+// Single-pass serializer appending to out_. With a stream attached, out_ is
+// a staging buffer handed to the stream whenever it outgrows kStreamChunkSize.
+class JsonWriter {
+public:
+    JsonWriter(std::string& out, const JsonWriteOptions& options, std::ostream* stream = nullptr)
+        : out_(out), options_(options), stream_(stream) {}
+
+    void Write(const JsonValue& value, int depth) {
+        if (value.is_null()) {
+            out_ += "null";
+        } else if (value.is_bool()) {
+            out_ += value.as_bool() ? "true" : "false";
+        } else if (value.is_integer()) {
+            char buffer[24];
+            auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value.as_int64());
+            out_.append(buffer, end);
+        } else if (value.is_number()) {
+            WriteDouble(value.as_number());
+        } else if (value.is_string()) {
+            WriteString(value.as_string());
+        } else if (value.is_array()) {
+            const JsonArray& arr = value.as_array();
+            out_ += '[';
+            bool first = true;
+            for (const auto& element : arr) {
+                if (!first) {
+                    out_ += ',';
+                }
+                first = false;
+                WriteNewline(depth + 1);
+                Write(element, depth + 1);
+            }
+            if (!arr.empty()) {
+                WriteNewline(depth);
+            }
+            out_ += ']';
+        } else {
+            const JsonObject& obj = value.as_object();
+            out_ += '{';
+            bool first = true;
+            for (const auto& pair : obj) {
+                if (!first) {
+                    out_ += ',';
                 }
+                first = false;
+                WriteNewline(depth + 1);
+                WriteString(pair.first);
+                out_ += options_.pretty ? ": " : ":";
+                Write(pair.second, depth + 1);
+            }
+            if (!obj.empty()) {
+                WriteNewline(depth);
+            }
+            out_ += '}';
+        }
+
+        if (stream_ != nullptr && out_.size() >= kStreamChunkSize) {
+            Flush();
+        }
+    }
+
+    void Flush() {
+        if (stream_ != nullptr) {
+            stream_->write(out_.data(), static_cast<std::streamsize>(out_.size()));
+            out_.clear();
+        }
+    }
+
+private:
+    std::string& out_;
+    const JsonWriteOptions& options_;
+    std::ostream* stream_;
+
+    void WriteNewline(int depth) {
+        if (options_.pretty) {
+            out_ += '\n';
+            out_.append(static_cast<size_t>(depth) * static_cast<size_t>(options_.indent), ' ');
+        }
+    }
+
+    void WriteDouble(double num) {
+        // Handle special cases for infinity and NaN
+        if (std::isinf(num)) {
+            throw std::runtime_error("Infinity values are not allowed in JSON");
+        }
+        if (std::isnan(num)) {
+            throw std::runtime_error("NaN values are not allowed in JSON");
+        }
+
+        // Shortest text that parses back to the same double; integral values
+        // print without a decimal point
+        char buffer[32];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), num);
+        out_.append(buffer, end);
+    }
+
+    // Runs of bytes that need no escaping are copied in one append
+    void WriteString(const std::string& str) {
+        static const char kHexDigits[] = "0123456789abcdef";
+        out_ += '"';
+        const char* p = str.data();
+        const char* end = p + str.size();
+        while (p < end) {
+            const char* run = p;
+            while (run < end && !kNeedsEscape[static_cast<unsigned char>(*run)]) {
+                ++run;
+            }
+            out_.append(p, run);
+            if (run == end) {
                 break;
+            }
+            switch (*run) {
+                case '"':  out_ += "\\\""; break;
+                case '\\': out_ += "\\\\"; break;
+                case '\b': out_ += "\\b";  break;
+                case '\f': out_ += "\\f";  break;
+                case '\n': out_ += "\\n";  break;
+                case '\r': out_ += "\\r";  break;
+                case '\t': out_ += "\\t";  break;
+                default: {
+                    // Escape control characters
+                    char escape[] = {'\\', 'u', '0', '0', kHexDigits[(*run >> 4) & 0xF], kHexDigits[*run & 0xF]};
+                    out_.append(escape, sizeof(escape));
+                    break;
+                }
+            }
+            p = run + 1;
         }
+        out_ += '"';
     }
-    result += "\"";
-    return result;
-}
+};
 
 // Helper function to trim whitespace from a string
 std::string Trim(const std::string& str) {
@@ -57,18 +177,26 @@ JsonValue::JsonValue(std::nullptr_t) : value_(nullptr) {}
 
 JsonValue::JsonValue(bool value) : value_(value) {}
 
-JsonValue::JsonValue(int value) : value_((double)value) {}
+JsonValue::JsonValue(int value) : value_(static_cast<int64_t>(value)) {}
+
+JsonValue::JsonValue(int64_t value) : value_(value) {}
 
 JsonValue::JsonValue(double value) : value_(value) {}
 
 JsonValue::JsonValue(const std::string& value) : value_(value) {}
 
+JsonValue::JsonValue(std::string&& value) : value_(std::move(value)) {}
+
 JsonValue::JsonValue(const char* value) : value_(std::string(value)) {}
 
 JsonValue::JsonValue(const JsonArray& value) : value_(value) {}
 
+JsonValue::JsonValue(JsonArray&& value) : value_(std::move(value)) {}
+
 JsonValue::JsonValue(const JsonObject& value) : value_(value) {}
 
+JsonValue::JsonValue(JsonObject&& value) : value_(std::move(value)) {}
+
 // Copy and move constructors/operators
 JsonValue::JsonValue(const JsonValue& other) : value_(other.value_) {}
 
@@ -100,7 +228,11 @@ bool JsonValue::is_bool() const {
 }
 
 bool JsonValue::is_number() const {
-    return std::holds_alternative<double>(value_);
+    return std::holds_alternative<int64_t>(value_) || std::holds_alternative<double>(value_);
+}
+
+bool JsonValue::is_integer() const {
+    return std::holds_alternative<int64_t>(value_);
 }
 
 bool JsonValue::is_string() const {
@@ -121,9 +253,16 @@ bool JsonValue::as_bool() const {
 }
 
 double JsonValue::as_number() const {
+    if (const int64_t* integer = std::get_if<int64_t>(&value_)) {
+        return static_cast<double>(*integer);
+    }
     return std::get<double>(value_);
 }
 
+int64_t JsonValue::as_int64() const {
+    return std::get<int64_t>(value_);
+}
+
 const std::string& JsonValue::as_string() const {
     return std::get<std::string>(value_);
 }
@@ -189,69 +328,24 @@ void JsonValue::insert(const std::string& key, JsonValue&& value) {
     obj[key] = std::move(value);
 }
 
-// Serialization helper
-std::string JsonValue::serialize_value() const {
-    if (std::holds_alternative<std::nullptr_t>(value_)) {
-        return "null";
-    } else if (std::holds_alternative<bool>(value_)) {
-        return std::get<bool>(value_) ? "true" : "false";
-    } else if (std::holds_alternative<double>(value_)) {
-        double num = std::get<double>(value_);
-        // Handle special cases for infinity and NaN
-        if (std::isinf(num)) {
-            throw std::runtime_error("Infinity values are not allowed in JSON");
-        }
-        if (std::isnan(num)) {
-            throw std::runtime_error("NaN values are not allowed in JSON");
-        }
-        
-        // Format the number to avoid unnecessary decimal points
-        if (num == std::floor(num) && 
-            std::abs(num) < std::pow(10.0, 15)) {
-            // It's an integer value within the safe range
-            return std::to_string((long long)num);
-        } else {
-            // It's a floating-point value
-            std::ostringstream oss;
-            oss << std::setprecision(std::numeric_limits<double>::digits10) << num;
-            return oss.str();
-        }
-    } else if (std::holds_alternative<std::string>(value_)) {
-        return EscapeString(std::get<std::string>(value_));
-    } else if (std::holds_alternative<JsonArray>(value_)) {
-        const JsonArray& arr = std::get<JsonArray>(value_);
-        std::string result = "[";
-        bool first = true;
-        for (const auto& element : arr) {
-            if (!first) {
-                result += ",";
-            }
-            first = false;
-            result += element.serialize_value();
-        }
-        result += "]";
-        return result;
-    } else if (std::holds_alternative<JsonObject>(value_)) {
-        const JsonObject& obj = std::get<JsonObject>(value_);
-        std::string result = "{";
-        bool first = true;
-        for (const auto& pair : obj) {
-            if (!first) {
-                result += ",";
-            }
-            first = false;
-            result += EscapeString(pair.first) + ":" + pair.second.serialize_value();
-        }
-        result += "}";
-        return result;
-    }
-    
-    return "null"; // Should never reach here
-}
-
 // Serialization to JSON string
 std::string JsonValue::to_string() const {
-    return serialize_value();
+    std::string result;
+    write(result);
+    return result;
+}
+
+void JsonValue::write(std::string& out, const JsonWriteOptions& options) const {
+    JsonWriter writer(out, options);
+    writer.Write(*this, 0);
+}
+
+void JsonValue::write(std::ostream& out, const JsonWriteOptions& options) const {
+    std::string staging;
+    staging.reserve(kStreamChunkSize + kStreamChunkSize / 4);
+    JsonWriter writer(staging, options, &out);
+    writer.Write(*this, 0);
+    writer.Flush();
 }
 
 // Parser implementation
@@ -459,7 +553,9 @@ private:
 
     JsonValue ParseNumber() {
         size_t start = pos_;
-        if (str_[pos_] == '-') {
+        bool negative = str_[pos_] == '-';
+        bool is_integer = true;
+        if (negative) {
             ++pos_;
         }
 
@@ -473,6 +569,7 @@ private:
 
         // Parse fractional part
         if (pos_ < str_.size() && str_[pos_] == '.') {
+            is_integer = false;
             ++pos_;
             if (pos_ >= str_.size() || !std::isdigit(str_[pos_])) {
                 throw std::runtime_error("Invalid number format");
@@ -484,6 +581,7 @@ private:
 
         // Parse exponent part
         if (pos_ < str_.size() && (str_[pos_] == 'e' || str_[pos_] == 'E')) {
+            is_integer = false;
             ++pos_;
             if (pos_ < str_.size() && (str_[pos_] == '+' || str_[pos_] == '-')) {
                 ++pos_;
@@ -496,13 +594,21 @@ private:
             }
         }
 
-        std::string numberStr = str_.substr(start, pos_ - start);
-        try {
-            double value = std::stod(numberStr);
-            return JsonValue(value);
-        } catch (const std::exception&) {
-            throw std::runtime_error("Invalid number format: " + numberStr);
+        const char* first = str_.data() + start;
+        const char* last = str_.data() + pos_;
+
+        // Exact integer fast path; -0 and integers beyond int64_t stay doubles
+        int64_t integer = 0;
+        if (is_integer && json_parser::ParseInt64(first, last, integer)) {
+            return JsonValue(integer);
+        }
+
+        double value = 0;
+        auto [ptr, ec] = std::from_chars(first, last, value);
+        if (ec != std::errc() || ptr != last) {
+            throw std::runtime_error("Invalid number format: " + std::string(first, last));
         }
+        return JsonValue(value);
     }
 
     JsonValue ParseTrue() {
@@ -0,0 +1,115 @@
+/*
+ * json_bench: Parse throughput of parse_json against the arena-backed DOM.
+ *
+ * Generates a telemetry-style document (an array of event objects with
+ * nested tags, metrics arrays and the occasional escaped string) and times:
+ *   - parse_json, the std::map/std::string based parser
+ *   - parse_json_document on the in-memory text (zero-copy, arena DOM)
+ *   - parse_json_document_file on the same text written to a temp file (mmap)
+ * Each variant runs three times and the fastest run is reported. The DOM is
+ * converted back with to_value() and compared with parse_json's result.
+ *
+ * How to Compile without Docker (from project root):
+ *   1. cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+ *   2. cmake --build build --target json_bench -- -j
+ *
+ * How to Run without Docker:
+ *   ./build/phase1/json-parser/json_bench [size_mb]
+ *
+ * Usage Examples:
+ *   - Default run (16 MB document):
+ *     ./build/phase1/json-parser/json_bench
+ *
+ *   - 128 MB document:
+ *     ./build/phase1/json-parser/json_bench 128
+ */
+
+#include "bench_util.h"
+#include "json.h"
+#include "json_dom.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+using json_bench::time_seconds;
+using json_bench::report;
+
+// An array of event objects, roughly target_bytes long
+std::string generate_document(uint64_t target_bytes) {
+    static const char* const services[] = {"api-gateway", "billing", "search", "auth", "inventory"};
+    static const char* const levels[] = {"debug", "info", "warn", "error"};
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pick(0, 1 << 20);
+    std::uniform_real_distribution<double> latency(0.1, 2500.0);
+
+    std::string text = "[";
+    text.reserve(target_bytes + 1024);
+    for (uint64_t seq = 0; text.size() < target_bytes; ++seq) {
+        if (seq > 0) {
+            text += ",\n";
+        }
+        text += "{\"id\":" + std::to_string(seq);
+        text += ",\"timestamp\":" + std::to_string(1700000000 + seq / 10);
+        text += ",\"service\":\"" + std::string(services[seq % 5]) + "\"";
+        text += ",\"level\":\"" + std::string(levels[pick(rng) % 4]) + "\"";
+        text += ",\"latency_ms\":" + std::to_string(latency(rng));
+        text += ",\"ok\":" + std::string(seq % 7 ? "true" : "false");
+        text += ",\"parent\":" + (seq % 3 ? std::to_string(seq - 1) : std::string("null"));
+        text += ",\"tags\":{\"region\":\"eu-west-" + std::to_string(seq % 3) + "\",\"host\":\"node-" +
+                std::to_string(pick(rng) % 64) + "\"}";
+        text += ",\"metrics\":[" + std::to_string(pick(rng) % 1000) + "," + std::to_string(pick(rng) % 1000) +
+                "," + std::to_string(pick(rng) % 1000) + "]";
+        if (seq % 16 == 0) {
+            text += ",\"message\":\"request \\\"" + std::to_string(seq) + "\\\" failed:\\n\\tretrying\"";
+        } else {
+            text += ",\"message\":\"request completed\"";
+        }
+        text += "}";
+    }
+    text += "]";
+    return text;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t size_mb = 16;
+    if (argc > 1) {
+        size_mb = std::stoull(argv[1]);
+    }
+
+    const std::string text = generate_document(size_mb * 1024 * 1024);
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "json_bench_input.json";
+    std::ofstream(path, std::ios::binary) << text;
+    std::cout << "Document: " << text.size() << " bytes" << std::endl;
+
+    JsonValue value;
+    double baseline = time_seconds([&] { value = parse_json(text); });
+    report("parse_json (std::map DOM)", baseline, text.size(), baseline);
+
+    JsonDocument document;
+    double dom_seconds = time_seconds([&] { document = parse_json_document(text); });
+    report("parse_json_document (arena DOM)", dom_seconds, text.size(), baseline);
+
+    JsonDocument mapped;
+    double file_seconds = time_seconds([&] { mapped = parse_json_document_file(path.string()); });
+    report("parse_json_document_file (mmap)", file_seconds, text.size(), baseline);
+    std::filesystem::remove(path);
+
+    std::cout << "Arena bytes: " << document.arena().bytes_used() << " ("
+              << std::setprecision(2) << static_cast<double>(document.arena().bytes_used()) / text.size()
+              << " per input byte)" << std::endl;
+
+    const std::string expected = value.to_string();
+    if (document.root().to_value().to_string() != expected || mapped.root().to_value().to_string() != expected) {
+        std::cout << "[RESULT MISMATCH] arena DOM differs from parse_json" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,677 @@
+#include "json_dom.h"
+#include "json_detail.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <variant>
+
+// Implementation of JsonArena methods
+JsonArena::JsonArena(size_t block_size) : block_size_(std::max<size_t>(block_size, 256)) {}
+
+JsonArena::JsonArena(JsonArena&& other) noexcept
+    : blocks_(std::move(other.blocks_)), cursor_(std::exchange(other.cursor_, nullptr)),
+      end_(std::exchange(other.end_, nullptr)), block_size_(other.block_size_),
+      bytes_used_(std::exchange(other.bytes_used_, 0)) {
+    other.blocks_.clear();
+}
+
+JsonArena& JsonArena::operator=(JsonArena&& other) noexcept {
+    if (this != &other) {
+        blocks_ = std::move(other.blocks_);
+        other.blocks_.clear();
+        cursor_ = std::exchange(other.cursor_, nullptr);
+        end_ = std::exchange(other.end_, nullptr);
+        block_size_ = other.block_size_;
+        bytes_used_ = std::exchange(other.bytes_used_, 0);
+    }
+    return *this;
+}
+
+void* JsonArena::allocate(size_t size, size_t align) {
+    auto current = reinterpret_cast<uintptr_t>(cursor_);
+    auto aligned = (current + align - 1) & ~static_cast<uintptr_t>(align - 1);
+    if (cursor_ == nullptr || aligned + size > reinterpret_cast<uintptr_t>(end_)) {
+        // Oversized requests get a block of their own; new char[] skips zeroing it
+        size_t block_size = std::max(block_size_, size + align);
+        blocks_.push_back(Block{std::unique_ptr<char[]>(new char[block_size]), block_size});
+        cursor_ = blocks_.back().data.get();
+        end_ = cursor_ + block_size;
+        current = reinterpret_cast<uintptr_t>(cursor_);
+        aligned = (current + align - 1) & ~static_cast<uintptr_t>(align - 1);
+    }
+    bytes_used_ += size;
+    cursor_ = reinterpret_cast<char*>(aligned + size);
+    return reinterpret_cast<void*>(aligned);
+}
+
+void JsonArena::reset() {
+    if (blocks_.size() > 1) {
+        blocks_.erase(blocks_.begin() + 1, blocks_.end());
+    }
+    cursor_ = blocks_.empty() ? nullptr : blocks_.front().data.get();
+    end_ = blocks_.empty() ? nullptr : cursor_ + blocks_.front().size;
+    bytes_used_ = 0;
+}
+
+// Implementation of JsonNode methods
+JsonNode JsonNode::make_bool(bool value) {
+    JsonNode node;
+    node.type_ = Type::Bool;
+    node.boolean_ = value;
+    return node;
+}
+
+JsonNode JsonNode::make_number(double value) {
+    JsonNode node;
+    node.type_ = Type::Number;
+    node.number_ = value;
+    return node;
+}
+
+JsonNode JsonNode::make_integer(int64_t value) {
+    JsonNode node;
+    node.type_ = Type::Number;
+    node.is_integer_ = true;
+    node.integer_ = value;
+    return node;
+}
+
+JsonNode JsonNode::make_string(std::string_view value) {
+    if (value.size() > UINT32_MAX) {
+        throw std::runtime_error("String too long");
+    }
+    JsonNode node;
+    node.type_ = Type::String;
+    node.size_ = static_cast<uint32_t>(value.size());
+    node.chars_ = value.data();
+    return node;
+}
+
+JsonNode JsonNode::make_array(const JsonNode* elements, size_t count) {
+    if (count > UINT32_MAX) {
+        throw std::runtime_error("Array too large");
+    }
+    JsonNode node;
+    node.type_ = Type::Array;
+    node.size_ = static_cast<uint32_t>(count);
+    node.elements_ = elements;
+    return node;
+}
+
+JsonNode JsonNode::make_object(const JsonMember* members, size_t count) {
+    if (count > UINT32_MAX) {
+        throw std::runtime_error("Object too large");
+    }
+    JsonNode node;
+    node.type_ = Type::Object;
+    node.size_ = static_cast<uint32_t>(count);
+    node.members_ = members;
+    return node;
+}
+
+bool JsonNode::as_bool() const {
+    if (type_ != Type::Bool) {
+        throw std::bad_variant_access();
+    }
+    return boolean_;
+}
+
+double JsonNode::as_number() const {
+    if (type_ != Type::Number) {
+        throw std::bad_variant_access();
+    }
+    return is_integer_ ? static_cast<double>(integer_) : number_;
+}
+
+int64_t JsonNode::as_int64() const {
+    if (!is_integer()) {
+        throw std::bad_variant_access();
+    }
+    return integer_;
+}
+
+std::string_view JsonNode::as_string() const {
+    if (type_ != Type::String) {
+        throw std::bad_variant_access();
+    }
+    return std::string_view(chars_, size_);
+}
+
+std::span<const JsonNode> JsonNode::as_array() const {
+    if (type_ != Type::Array) {
+        throw std::bad_variant_access();
+    }
+    return std::span<const JsonNode>(elements_, size_);
+}
+
+std::span<const JsonMember> JsonNode::as_object() const {
+    if (type_ != Type::Object) {
+        throw std::bad_variant_access();
+    }
+    return std::span<const JsonMember>(members_, size_);
+}
+
+const JsonNode& JsonNode::operator[](size_t index) const {
+    std::span<const JsonNode> elements = as_array();
+    if (index >= elements.size()) {
+        throw std::out_of_range("Index out of range");
+    }
+    return elements[index];
+}
+
+const JsonNode& JsonNode::operator[](std::string_view key) const {
+    const JsonNode* value = find(key);
+    if (value == nullptr) {
+        throw std::out_of_range("Key not found");
+    }
+    return *value;
+}
+
+const JsonNode* JsonNode::find(std::string_view key) const {
+    std::span<const JsonMember> members = as_object();
+    for (size_t i = members.size(); i > 0; --i) {
+        if (members[i - 1].key == key) {
+            return &members[i - 1].value;
+        }
+    }
+    return nullptr;
+}
+
+JsonValue JsonNode::to_value() const {
+    switch (type_) {
+        case Type::Null:   return JsonValue(nullptr);
+        case Type::Bool:   return JsonValue(boolean_);
+        case Type::Number: return is_integer_ ? JsonValue(integer_) : JsonValue(number_);
+        case Type::String: return JsonValue(std::string(chars_, size_));
+        case Type::Array: {
+            JsonArray arr;
+            arr.reserve(size_);
+            for (const JsonNode& element : as_array()) {
+                arr.push_back(element.to_value());
+            }
+            return JsonValue(std::move(arr));
+        }
+        case Type::Object: {
+            JsonObject obj;
+            for (const JsonMember& member : as_object()) {
+                obj[std::string(member.key)] = member.value.to_value();
+            }
+            return JsonValue(std::move(obj));
+        }
+    }
+    return JsonValue(); // Should never reach here
+}
+
+// Implementation of JsonDocument methods
+JsonDocument::JsonDocument(JsonDocument&& other) noexcept
+    : arena_(std::move(other.arena_)), root_(other.root_), input_(other.input_),
+      mapping_(other.mapping_), mapping_size_(other.mapping_size_) {
+    other.root_ = JsonNode();
+    other.input_ = {};
+    other.mapping_ = nullptr;
+    other.mapping_size_ = 0;
+}
+
+JsonDocument& JsonDocument::operator=(JsonDocument&& other) noexcept {
+    if (this != &other) {
+        if (mapping_ != nullptr) {
+            ::munmap(mapping_, mapping_size_);
+        }
+        arena_ = std::move(other.arena_);
+        root_ = other.root_;
+        input_ = other.input_;
+        mapping_ = other.mapping_;
+        mapping_size_ = other.mapping_size_;
+        other.root_ = JsonNode();
+        other.input_ = {};
+        other.mapping_ = nullptr;
+        other.mapping_size_ = 0;
+    }
+    return *this;
+}
+
+JsonDocument::~JsonDocument() {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapping_size_);
+    }
+}
+
+// Parser implementation
+namespace json_parser {
+
+namespace {
+
+uint32_t ParseHex4(const char* s, const char* end) {
+    if (end - s < 4) {
+        throw std::runtime_error("Invalid unicode escape sequence");
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = s[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value |= static_cast<uint32_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            value |= static_cast<uint32_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            value |= static_cast<uint32_t>(c - 'A' + 10);
+        } else {
+            throw std::runtime_error("Invalid unicode escape sequence");
+        }
+    }
+    return value;
+}
+
+// s points at the 'u'; on return it points at the last consumed hex digit.
+// Surrogate pairs are combined; an unpaired surrogate becomes U+FFFD.
+// The UTF-8 output (at most 4 bytes) never exceeds the 6 or 12 bytes read.
+char* DecodeUnicodeEscape(const char*& s, const char* end, char* w) {
+    uint32_t cp = ParseHex4(s + 1, end);
+    s += 4;
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+        if (end - s > 6 && s[1] == '\\' && s[2] == 'u') {
+            uint32_t low = ParseHex4(s + 3, end);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                s += 6;
+            } else {
+                cp = 0xFFFD;
+            }
+        } else {
+            cp = 0xFFFD;
+        }
+    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        cp = 0xFFFD;
+    }
+
+    if (cp < 0x80) {
+        *w++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *w++ = static_cast<char>(0xC0 | (cp >> 6));
+        *w++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *w++ = static_cast<char>(0xE0 | (cp >> 12));
+        *w++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *w++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *w++ = static_cast<char>(0xF0 | (cp >> 18));
+        *w++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *w++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *w++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return w;
+}
+
+} // anonymous namespace
+
+std::string_view UnescapeString(const char* begin, const char* end, JsonArena& arena) {
+    // Unescaping never makes a string longer
+    char* out = arena.allocate_array<char>(static_cast<size_t>(end - begin));
+    char* w = out;
+    for (const char* s = begin; s < end; ++s) {
+        if (*s != '\\') {
+            *w++ = *s;
+            continue;
+        }
+        if (++s == end) {
+            throw std::runtime_error("Unexpected end of input in string");
+        }
+        switch (*s) {
+            case '"':  *w++ = '"';  break;
+            case '\\': *w++ = '\\'; break;
+            case '/':  *w++ = '/';  break;
+            case 'b':  *w++ = '\b'; break;
+            case 'f':  *w++ = '\f'; break;
+            case 'n':  *w++ = '\n'; break;
+            case 'r':  *w++ = '\r'; break;
+            case 't':  *w++ = '\t'; break;
+            case 'u':  w = DecodeUnicodeEscape(s, end, w); break;
+            default:
+                throw std::runtime_error("Invalid escape sequence: \\" + std::string(1, *s));
+        }
+    }
+    return std::string_view(out, static_cast<size_t>(w - out));
+}
+
+bool IsValidNumber(const char* p, const char* end) {
+    auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+    if (p < end && *p == '-') {
+        ++p;
+    }
+    if (p == end || !is_digit(*p)) {
+        return false;
+    }
+    while (p < end && is_digit(*p)) {
+        ++p;
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        if (p == end || !is_digit(*p)) {
+            return false;
+        }
+        while (p < end && is_digit(*p)) {
+            ++p;
+        }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        if (p < end && (*p == '+' || *p == '-')) {
+            ++p;
+        }
+        if (p == end || !is_digit(*p)) {
+            return false;
+        }
+        while (p < end && is_digit(*p)) {
+            ++p;
+        }
+    }
+    return p == end;
+}
+
+// Recursive descent over a string_view. Children of the containers being
+// parsed are collected on two scratch stacks shared by all nesting levels;
+// when a container closes, its children are copied into the arena as one
+// contiguous array and popped.
+class DomParser {
+public:
+    DomParser(std::string_view text, JsonArena& arena)
+        : p_(text.data()), end_(text.data() + text.size()), arena_(arena) {}
+
+    JsonNode Parse() {
+        SkipWhitespace();
+        JsonNode result = ParseValue(0);
+        SkipWhitespace();
+
+        // Ensure we've consumed the entire input
+        if (p_ < end_) {
+            throw std::runtime_error("Unexpected characters at end of input");
+        }
+        return result;
+    }
+
+private:
+    static constexpr int kMaxDepth = 1024;
+
+    const char* p_;
+    const char* end_;
+    JsonArena& arena_;
+    std::vector<JsonNode> elements_;
+    std::vector<JsonMember> members_;
+
+    static bool IsWhitespace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    static bool IsDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    void SkipWhitespace() {
+        while (p_ < end_ && IsWhitespace(*p_)) {
+            ++p_;
+        }
+    }
+
+    JsonNode ParseValue(int depth) {
+        if (p_ >= end_) {
+            throw std::runtime_error("Unexpected end of input");
+        }
+
+        char c = *p_;
+        switch (c) {
+            case '{': return ParseObject(depth + 1);
+            case '[': return ParseArray(depth + 1);
+            case '"': return JsonNode::make_string(ParseString());
+            case 't': return ParseLiteral("true", JsonNode::make_bool(true));
+            case 'f': return ParseLiteral("false", JsonNode::make_bool(false));
+            case 'n': return ParseLiteral("null", JsonNode::make_null());
+            default:
+                if (c == '-' || IsDigit(c)) {
+                    return ParseNumber();
+                }
+                throw std::runtime_error("Unexpected character: " + std::string(1, c));
+        }
+    }
+
+    JsonNode ParseObject(int depth) {
+        if (depth > kMaxDepth) {
+            throw std::runtime_error("Maximum nesting depth exceeded");
+        }
+        ++p_;
+        SkipWhitespace();
+        if (p_ < end_ && *p_ == '}') {
+            // Empty object
+            ++p_;
+            return JsonNode::make_object(nullptr, 0);
+        }
+
+        const size_t start = members_.size();
+        while (true) {
+            SkipWhitespace();
+            if (p_ >= end_) {
+                throw std::runtime_error("Unexpected end of input while parsing object");
+            }
+
+            // Parse key
+            if (*p_ != '"') {
+                throw std::runtime_error("Expected string key in object");
+            }
+            std::string_view key = ParseString();
+
+            // Parse colon
+            SkipWhitespace();
+            if (p_ >= end_ || *p_ != ':') {
+                throw std::runtime_error("Expected ':' after key in object");
+            }
+            ++p_;
+
+            // Parse value; nested containers push onto members_, so append after
+            SkipWhitespace();
+            JsonNode value = ParseValue(depth);
+            members_.push_back(JsonMember{key, value});
+
+            // Check for comma or end of object
+            SkipWhitespace();
+            if (p_ >= end_) {
+                throw std::runtime_error("Unexpected end of input while parsing object");
+            }
+            if (*p_ == '}') {
+                ++p_;
+                break;
+            } else if (*p_ == ',') {
+                ++p_;
+            } else {
+                throw std::runtime_error("Expected ',' or '}' in object");
+            }
+        }
+
+        const size_t count = members_.size() - start;
+        JsonMember* members = arena_.allocate_array<JsonMember>(count);
+        std::uninitialized_copy(members_.begin() + start, members_.end(), members);
+        members_.resize(start);
+        return JsonNode::make_object(members, count);
+    }
+
+    JsonNode ParseArray(int depth) {
+        if (depth > kMaxDepth) {
+            throw std::runtime_error("Maximum nesting depth exceeded");
+        }
+        ++p_;
+        SkipWhitespace();
+        if (p_ < end_ && *p_ == ']') {
+            // Empty array
+            ++p_;
+            return JsonNode::make_array(nullptr, 0);
+        }
+
+        const size_t start = elements_.size();
+        while (true) {
+            SkipWhitespace();
+            JsonNode value = ParseValue(depth);
+            elements_.push_back(value);
+
+            // Check for comma or end of array
+            SkipWhitespace();
+            if (p_ >= end_) {
+                throw std::runtime_error("Unexpected end of input while parsing array");
+            }
+            if (*p_ == ']') {
+                ++p_;
+                break;
+            } else if (*p_ == ',') {
+                ++p_;
+            } else {
+                throw std::runtime_error("Expected ',' or ']' in array");
+            }
+        }
+
+        const size_t count = elements_.size() - start;
+        JsonNode* elements = arena_.allocate_array<JsonNode>(count);
+        std::uninitialized_copy(elements_.begin() + start, elements_.end(), elements);
+        elements_.resize(start);
+        return JsonNode::make_array(elements, count);
+    }
+
+    // Returns a view into the input, or into the arena when the string has escapes
+    std::string_view ParseString() {
+        ++p_;
+        const char* start = p_;
+        const char* q = p_;
+        bool has_escapes = false;
+        while (q < end_ && *q != '"') {
+            if (*q == '\\') {
+                has_escapes = true;
+                ++q;
+            }
+            ++q;
+        }
+        if (q >= end_) {
+            throw std::runtime_error("Unterminated string");
+        }
+        p_ = q + 1; // Skip closing quote
+        if (!has_escapes) {
+            return std::string_view(start, static_cast<size_t>(q - start));
+        }
+
+        return UnescapeString(start, q, arena_);
+    }
+
+    JsonNode ParseNumber() {
+        const char* start = p_;
+        bool is_integer = true;
+        if (*p_ == '-') {
+            ++p_;
+        }
+
+        // Parse integer part
+        if (p_ >= end_ || !IsDigit(*p_)) {
+            throw std::runtime_error("Invalid number format");
+        }
+        while (p_ < end_ && IsDigit(*p_)) {
+            ++p_;
+        }
+
+        // Parse fractional part
+        if (p_ < end_ && *p_ == '.') {
+            is_integer = false;
+            ++p_;
+            if (p_ >= end_ || !IsDigit(*p_)) {
+                throw std::runtime_error("Invalid number format");
+            }
+            while (p_ < end_ && IsDigit(*p_)) {
+                ++p_;
+            }
+        }
+
+        // Parse exponent part
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+            is_integer = false;
+            ++p_;
+            if (p_ < end_ && (*p_ == '+' || *p_ == '-')) {
+                ++p_;
+            }
+            if (p_ >= end_ || !IsDigit(*p_)) {
+                throw std::runtime_error("Invalid number format");
+            }
+            while (p_ < end_ && IsDigit(*p_)) {
+                ++p_;
+            }
+        }
+
+        int64_t integer = 0;
+        if (is_integer && ParseInt64(start, p_, integer)) {
+            return JsonNode::make_integer(integer);
+        }
+
+        double value = 0;
+        auto [ptr, ec] = std::from_chars(start, p_, value);
+        if (ec != std::errc() || ptr != p_) {
+            throw std::runtime_error("Invalid number format: " + std::string(start, p_));
+        }
+        return JsonNode::make_number(value);
+    }
+
+    JsonNode ParseLiteral(std::string_view literal, JsonNode node) {
+        if (static_cast<size_t>(end_ - p_) >= literal.size() &&
+            std::memcmp(p_, literal.data(), literal.size()) == 0) {
+            p_ += literal.size();
+            return node;
+        }
+        throw std::runtime_error("Expected '" + std::string(literal) + "'");
+    }
+};
+
+} // namespace json_parser
+
+// Public parsing functions
+JsonDocument parse_json_document(std::string_view json_text) {
+    JsonDocument document;
+    // Roughly one node per 8 bytes of input; size blocks so small documents stay small
+    document.arena_ = JsonArena(std::clamp<size_t>(json_text.size(), 4096, 1 << 20));
+    json_parser::DomParser parser(json_text, document.arena_);
+    document.root_ = parser.Parse();
+    document.input_ = json_text;
+    return document;
+}
+
+JsonDocument parse_json_document_file(const std::string& filepath) {
+    int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + filepath);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to open file: " + filepath);
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* mapping = nullptr;
+    if (size > 0) {
+        mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Failed to map file: " + filepath);
+        }
+        ::madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+
+    try {
+        JsonDocument document = parse_json_document(std::string_view(static_cast<const char*>(mapping), size));
+        document.mapping_ = mapping;
+        document.mapping_size_ = size;
+        return document;
+    } catch (...) {
+        if (mapping != nullptr) {
+            ::munmap(mapping, size);
+        }
+        throw;
+    }
+}
@@ -0,0 +1,387 @@
+#include "json_msgpack.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <variant>
+
+namespace {
+
+constexpr int kMaxDepth = 1024;
+
+// MessagePack markers used by the encoder; the reader also accepts the
+// unsigned integer forms other encoders emit
+constexpr uint8_t kNil = 0xc0;
+constexpr uint8_t kFalse = 0xc2;
+constexpr uint8_t kTrue = 0xc3;
+constexpr uint8_t kFloat32 = 0xca;
+constexpr uint8_t kFloat64 = 0xcb;
+constexpr uint8_t kUint8 = 0xcc;
+constexpr uint8_t kUint64 = 0xcf;
+constexpr uint8_t kInt8 = 0xd0;
+constexpr uint8_t kInt16 = 0xd1;
+constexpr uint8_t kInt32 = 0xd2;
+constexpr uint8_t kInt64 = 0xd3;
+constexpr uint8_t kStr8 = 0xd9;
+constexpr uint8_t kStr16 = 0xda;
+constexpr uint8_t kStr32 = 0xdb;
+constexpr uint8_t kArray16 = 0xdc;
+constexpr uint8_t kArray32 = 0xdd;
+constexpr uint8_t kMap16 = 0xde;
+constexpr uint8_t kMap32 = 0xdf;
+
+// Big-endian stores
+void PutBytes(std::string& out, uint8_t marker, uint64_t value, int bytes) {
+    char buffer[9];
+    buffer[0] = static_cast<char>(marker);
+    for (int i = 0; i < bytes; ++i) {
+        buffer[bytes - i] = static_cast<char>(value >> (8 * i));
+    }
+    out.append(buffer, static_cast<size_t>(bytes) + 1);
+}
+
+// Header for a string, array or map: fix form, then 8 (strings only), 16 or 32 bits
+void PutLength(std::string& out, uint64_t length, uint8_t fix_marker, uint64_t fix_limit, uint8_t marker8,
+               uint8_t marker16, uint8_t marker32) {
+    if (length < fix_limit) {
+        out += static_cast<char>(fix_marker | length);
+    } else if (marker8 != 0 && length <= 0xff) {
+        PutBytes(out, marker8, length, 1);
+    } else if (length <= 0xffff) {
+        PutBytes(out, marker16, length, 2);
+    } else if (length <= 0xffffffff) {
+        PutBytes(out, marker32, length, 4);
+    } else {
+        throw std::runtime_error("Value too large for MessagePack");
+    }
+}
+
+void PutInteger(std::string& out, int64_t value) {
+    if (value >= -32 && value <= 127) {
+        out += static_cast<char>(static_cast<int8_t>(value));
+    } else if (value >= INT8_MIN && value <= INT8_MAX) {
+        PutBytes(out, kInt8, static_cast<uint64_t>(value), 1);
+    } else if (value >= INT16_MIN && value <= INT16_MAX) {
+        PutBytes(out, kInt16, static_cast<uint64_t>(value), 2);
+    } else if (value >= INT32_MIN && value <= INT32_MAX) {
+        PutBytes(out, kInt32, static_cast<uint64_t>(value), 4);
+    } else {
+        PutBytes(out, kInt64, static_cast<uint64_t>(value), 8);
+    }
+}
+
+void PutDouble(std::string& out, double value) {
+    float narrow = static_cast<float>(value);
+    if (static_cast<double>(narrow) == value) {
+        uint32_t bits;
+        std::memcpy(&bits, &narrow, sizeof(bits));
+        PutBytes(out, kFloat32, bits, 4);
+    } else {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        PutBytes(out, kFloat64, bits, 8);
+    }
+}
+
+void Encode(const JsonValue& value, std::string& out) {
+    if (value.is_null()) {
+        out += static_cast<char>(kNil);
+    } else if (value.is_bool()) {
+        out += static_cast<char>(value.as_bool() ? kTrue : kFalse);
+    } else if (value.is_integer()) {
+        PutInteger(out, value.as_int64());
+    } else if (value.is_number()) {
+        PutDouble(out, value.as_number());
+    } else if (value.is_string()) {
+        const std::string& str = value.as_string();
+        PutLength(out, str.size(), 0xa0, 32, kStr8, kStr16, kStr32);
+        out += str;
+    } else if (value.is_array()) {
+        const JsonArray& arr = value.as_array();
+        PutLength(out, arr.size(), 0x90, 16, 0, kArray16, kArray32);
+        for (const auto& element : arr) {
+            Encode(element, out);
+        }
+    } else {
+        const JsonObject& obj = value.as_object();
+        PutLength(out, obj.size(), 0x80, 16, 0, kMap16, kMap32);
+        for (const auto& pair : obj) {
+            PutLength(out, pair.first.size(), 0xa0, 32, kStr8, kStr16, kStr32);
+            out += pair.first;
+            Encode(pair.second, out);
+        }
+    }
+}
+
+// Big-endian load of bytes (1, 2, 4 or 8) at p, bounds-checked against end
+uint64_t Load(const uint8_t* p, const uint8_t* end, int bytes) {
+    if (end - p < bytes) {
+        throw std::runtime_error("Truncated MessagePack data");
+    }
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+} // anonymous namespace
+
+void encode_msgpack(const JsonValue& value, std::string& out) {
+    Encode(value, out);
+}
+
+std::string encode_msgpack(const JsonValue& value) {
+    std::string out;
+    Encode(value, out);
+    return out;
+}
+
+JsonValue decode_msgpack(std::string_view bytes) {
+    MsgPackView view(bytes);
+    const uint8_t* next = nullptr;
+    JsonValue value = view.ToValue(next, 0);
+    if (next != view.end_) {
+        throw std::runtime_error("Unexpected bytes after MessagePack value");
+    }
+    return value;
+}
+
+MsgPackView::MsgPackView(std::string_view bytes)
+    : MsgPackView(reinterpret_cast<const uint8_t*>(bytes.data()),
+                  reinterpret_cast<const uint8_t*>(bytes.data()) + bytes.size()) {}
+
+// Decodes the header; payload_ ends up after the header and any number bytes
+MsgPackView::MsgPackView(const uint8_t* p, const uint8_t* end) : start_(p), payload_(p + 1), end_(end) {
+    if (p >= end) {
+        throw std::runtime_error("Truncated MessagePack data");
+    }
+    const uint8_t marker = *p;
+    auto sized = [&](Type type, int bytes) {
+        type_ = type;
+        length_ = Load(payload_, end_, bytes);
+        payload_ += bytes;
+    };
+    auto number = [&](int bytes, bool is_signed) {
+        type_ = Type::Number;
+        length_ = Load(payload_, end_, bytes);
+        payload_ += bytes;
+        if (is_signed && bytes < 8) {
+            // Sign-extend
+            const int shift = 64 - 8 * bytes;
+            length_ = static_cast<uint64_t>(static_cast<int64_t>(length_ << shift) >> shift);
+        } else if (!is_signed && length_ > static_cast<uint64_t>(INT64_MAX)) {
+            // uint64 beyond int64_t, as parse_json would hold it
+            is_float_ = true;
+            float_ = static_cast<double>(length_);
+        }
+    };
+
+    if (marker <= 0x7f) {
+        type_ = Type::Number;
+        length_ = marker;
+    } else if (marker >= 0xe0) {
+        type_ = Type::Number;
+        length_ = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(marker)));
+    } else if (marker <= 0x8f) {
+        type_ = Type::Object;
+        length_ = marker & 0x0f;
+    } else if (marker <= 0x9f) {
+        type_ = Type::Array;
+        length_ = marker & 0x0f;
+    } else if (marker <= 0xbf) {
+        type_ = Type::String;
+        length_ = marker & 0x1f;
+    } else {
+        switch (marker) {
+            case kNil: type_ = Type::Null; break;
+            case kFalse: type_ = Type::Bool; length_ = 0; break;
+            case kTrue: type_ = Type::Bool; length_ = 1; break;
+            case kFloat32: {
+                uint32_t bits = static_cast<uint32_t>(Load(payload_, end_, 4));
+                float narrow;
+                std::memcpy(&narrow, &bits, sizeof(narrow));
+                type_ = Type::Number;
+                is_float_ = true;
+                float_ = narrow;
+                payload_ += 4;
+                break;
+            }
+            case kFloat64: {
+                uint64_t bits = Load(payload_, end_, 8);
+                std::memcpy(&float_, &bits, sizeof(float_));
+                type_ = Type::Number;
+                is_float_ = true;
+                payload_ += 8;
+                break;
+            }
+            case kUint8: case kUint8 + 1: case kUint8 + 2: case kUint64:
+                number(1 << (marker - kUint8), false);
+                break;
+            case kInt8: case kInt16: case kInt32: case kInt64:
+                number(1 << (marker - kInt8), true);
+                break;
+            case kStr8: sized(Type::String, 1); break;
+            case kStr16: sized(Type::String, 2); break;
+            case kStr32: sized(Type::String, 4); break;
+            case kArray16: sized(Type::Array, 2); break;
+            case kArray32: sized(Type::Array, 4); break;
+            case kMap16: sized(Type::Object, 2); break;
+            case kMap32: sized(Type::Object, 4); break;
+            default: {
+                static const char kHexDigits[] = "0123456789abcdef";
+                throw std::runtime_error(std::string("Unsupported MessagePack type: 0x") + kHexDigits[marker >> 4] +
+                                         kHexDigits[marker & 0xf]);
+            }
+        }
+    }
+    if (type_ == Type::String && static_cast<uint64_t>(end_ - payload_) < length_) {
+        throw std::runtime_error("Truncated MessagePack data");
+    }
+}
+
+bool MsgPackView::as_bool() const {
+    if (type_ != Type::Bool) {
+        throw std::bad_variant_access();
+    }
+    return length_ != 0;
+}
+
+double MsgPackView::as_number() const {
+    if (type_ != Type::Number) {
+        throw std::bad_variant_access();
+    }
+    return is_float_ ? float_ : static_cast<double>(static_cast<int64_t>(length_));
+}
+
+int64_t MsgPackView::as_int64() const {
+    if (!is_integer()) {
+        throw std::bad_variant_access();
+    }
+    return static_cast<int64_t>(length_);
+}
+
+std::string_view MsgPackView::as_string() const {
+    if (type_ != Type::String) {
+        throw std::bad_variant_access();
+    }
+    return std::string_view(reinterpret_cast<const char*>(payload_), static_cast<size_t>(length_));
+}
+
+const uint8_t* MsgPackView::ChildrenBegin(Type type) const {
+    if (type_ != type) {
+        throw std::bad_variant_access();
+    }
+    return payload_;
+}
+
+// Containers are stepped over iteratively, counting the children still to
+// skip, so hostile nesting cannot exhaust the stack
+const uint8_t* MsgPackView::Next() const {
+    if (type_ == Type::String) {
+        return payload_ + length_;
+    }
+    if (type_ != Type::Array && type_ != Type::Object) {
+        return payload_;
+    }
+    uint64_t remaining = type_ == Type::Array ? length_ : 2 * length_;
+    const uint8_t* p = payload_;
+    while (remaining > 0) {
+        MsgPackView child(p, end_);
+        --remaining;
+        if (child.type_ == Type::Array) {
+            remaining += child.length_;
+            p = child.payload_;
+        } else if (child.type_ == Type::Object) {
+            remaining += 2 * child.length_;
+            p = child.payload_;
+        } else {
+            p = child.Next();
+        }
+    }
+    return p;
+}
+
+MsgPackView MsgPackView::operator[](size_t index) const {
+    const uint8_t* p = ChildrenBegin(Type::Array);
+    if (index >= length_) {
+        throw std::out_of_range("Index out of range");
+    }
+    for (size_t i = 0; i < index; ++i) {
+        p = MsgPackView(p, end_).Next();
+    }
+    return MsgPackView(p, end_);
+}
+
+MsgPackView MsgPackView::operator[](std::string_view key) const {
+    MsgPackView value(*this);
+    if (!find(key, value)) {
+        throw std::out_of_range("Key not found");
+    }
+    return value;
+}
+
+bool MsgPackView::find(std::string_view key, MsgPackView& value) const {
+    const uint8_t* p = ChildrenBegin(Type::Object);
+    for (uint64_t i = 0; i < length_; ++i) {
+        MsgPackView member_key(p, end_);
+        if (member_key.type_ != Type::String) {
+            throw std::runtime_error("Expected string key in MessagePack map");
+        }
+        MsgPackView member_value(member_key.Next(), end_);
+        if (member_key.as_string() == key) {
+            value = member_value;
+            return true;
+        }
+        p = member_value.Next();
+    }
+    return false;
+}
+
+std::string_view MsgPackView::bytes() const {
+    return std::string_view(reinterpret_cast<const char*>(start_), static_cast<size_t>(Next() - start_));
+}
+
+JsonValue MsgPackView::to_value() const {
+    const uint8_t* next = nullptr;
+    return ToValue(next, 0);
+}
+
+JsonValue MsgPackView::ToValue(const uint8_t*& next, int depth) const {
+    next = payload_;
+    switch (type_) {
+        case Type::Null: return JsonValue(nullptr);
+        case Type::Bool: return JsonValue(length_ != 0);
+        case Type::Number: return is_float_ ? JsonValue(float_) : JsonValue(static_cast<int64_t>(length_));
+        case Type::String:
+            next = payload_ + length_;
+            return JsonValue(std::string(as_string()));
+        case Type::Array: {
+            if (depth >= kMaxDepth) {
+                throw std::runtime_error("Maximum nesting depth exceeded");
+            }
+            JsonArray arr;
+            // Every element takes at least one byte, which bounds a hostile count
+            arr.reserve(static_cast<size_t>(std::min<uint64_t>(length_, static_cast<uint64_t>(end_ - payload_))));
+            for (uint64_t i = 0; i < length_; ++i) {
+                arr.push_back(MsgPackView(next, end_).ToValue(next, depth + 1));
+            }
+            return JsonValue(std::move(arr));
+        }
+        case Type::Object: {
+            if (depth >= kMaxDepth) {
+                throw std::runtime_error("Maximum nesting depth exceeded");
+            }
+            JsonObject obj;
+            for (uint64_t i = 0; i < length_; ++i) {
+                MsgPackView key(next, end_);
+                if (key.type_ != Type::String) {
+                    throw std::runtime_error("Expected string key in MessagePack map");
+                }
+                next = key.Next();
+                obj.insert_or_assign(std::string(key.as_string()), MsgPackView(next, end_).ToValue(next, depth + 1));
+            }
+            return JsonValue(std::move(obj));
+        }
+    }
+    return JsonValue(); // Should never reach here
+}
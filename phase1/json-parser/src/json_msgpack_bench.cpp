@@ -0,0 +1,131 @@
+/*
+ * json_msgpack_bench: MessagePack encode/decode against JSON text.
+ *
+ * Builds a JsonValue from a telemetry-style document (event objects with
+ * IDs, timestamps, short strings, float metrics and nested tags) and reports
+ * the size of the text and binary forms, then times:
+ *   - JsonValue::to_string vs encode_msgpack (serialization)
+ *   - parse_json vs decode_msgpack (full decode into JsonValue)
+ *   - reading three fields from every event: parse_json + operator[] vs
+ *     MsgPackView in place (no JsonValue built)
+ * Each variant runs three times and the fastest run is reported. Decoded
+ * values are compared with the original.
+ *
+ * How to Compile without Docker (from project root):
+ *   1. cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+ *   2. cmake --build build --target json_msgpack_bench -- -j
+ *
+ * How to Run without Docker:
+ *   ./build/phase1/json-parser/json_msgpack_bench [events]
+ *
+ * Usage Examples:
+ *   - Default run (100,000 events):
+ *     ./build/phase1/json-parser/json_msgpack_bench
+ *
+ *   - 500,000 events:
+ *     ./build/phase1/json-parser/json_msgpack_bench 500000
+ */
+
+#include "bench_util.h"
+#include "json.h"
+#include "json_msgpack.h"
+#include <cstdio>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+using json_bench::time_seconds;
+using json_bench::report;
+
+std::string generate_document(int count) {
+    static const char* const services[] = {"api-gateway", "billing", "search", "auth", "inventory"};
+    static const char* const levels[] = {"debug", "info", "warn", "error"};
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pick(0, 1 << 20);
+    std::uniform_real_distribution<double> latency(0.1, 2500.0);
+    char number[32];
+
+    std::string text = "[";
+    for (int seq = 0; seq < count; ++seq) {
+        if (seq > 0) {
+            text += ",\n";
+        }
+        snprintf(number, sizeof(number), "%.3f", latency(rng));
+        text += "{\"id\":" + std::to_string(505874924095815680LL + seq);
+        text += ",\"timestamp\":" + std::to_string(1700000000 + seq / 10);
+        text += ",\"service\":\"" + std::string(services[seq % 5]) + "\"";
+        text += ",\"level\":\"" + std::string(levels[pick(rng) % 4]) + "\"";
+        text += ",\"latency_ms\":" + std::string(number);
+        text += ",\"ok\":" + std::string(seq % 7 ? "true" : "false");
+        text += ",\"tags\":{\"region\":\"eu-west-" + std::to_string(seq % 3) + "\",\"host\":\"node-" +
+                std::to_string(pick(rng) % 64) + "\"}";
+        text += ",\"metrics\":[" + std::to_string(pick(rng) % 1000) + "," + std::to_string(pick(rng) % 1000) +
+                "," + std::to_string(pick(rng) % 1000) + "]";
+        text += ",\"message\":\"request completed\"}";
+    }
+    text += "]";
+    return text;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    int count = 100000;
+    if (argc > 1) {
+        count = std::stoi(argv[1]);
+    }
+
+    const JsonValue original = parse_json(generate_document(count));
+    const std::string text = original.to_string();
+    const std::string binary = encode_msgpack(original);
+    std::cout << "JSON text: " << text.size() << " bytes, MessagePack: " << binary.size() << " bytes ("
+              << std::setprecision(1) << std::fixed << 100.0 * binary.size() / text.size() << "%)" << std::endl;
+
+    std::string serialized;
+    double to_string_seconds = time_seconds([&] { serialized = original.to_string(); });
+    report("to_string", to_string_seconds, text.size(), to_string_seconds);
+    std::string encoded;
+    double encode_seconds = time_seconds([&] {
+        encoded.clear();
+        encode_msgpack(original, encoded);
+    });
+    report("encode_msgpack (reused buffer)", encode_seconds, text.size(), to_string_seconds);
+
+    JsonValue parsed;
+    double parse_seconds = time_seconds([&] { parsed = parse_json(text); });
+    report("parse_json", parse_seconds, text.size(), parse_seconds);
+    JsonValue decoded;
+    double decode_seconds = time_seconds([&] { decoded = decode_msgpack(binary); });
+    report("decode_msgpack", decode_seconds, text.size(), parse_seconds);
+
+    int64_t text_sum = 0;
+    double text_fields_seconds = time_seconds([&] {
+        text_sum = 0;
+        JsonValue value = parse_json(text);
+        for (const JsonValue& event : value.as_array()) {
+            text_sum += event["id"].as_int64() + event["metrics"][1].as_int64() +
+                        static_cast<int64_t>(event["tags"]["host"].as_string().size());
+        }
+    });
+    report("3 fields: parse_json", text_fields_seconds, text.size(), text_fields_seconds);
+    int64_t view_sum = 0;
+    double view_fields_seconds = time_seconds([&] {
+        view_sum = 0;
+        MsgPackView(binary).for_each_element([&](const MsgPackView& event) {
+            view_sum += event["id"].as_int64() + event["metrics"][1].as_int64() +
+                        static_cast<int64_t>(event["tags"]["host"].as_string().size());
+        });
+    });
+    report("3 fields: MsgPackView in place", view_fields_seconds, text.size(), text_fields_seconds);
+    std::cout << "(throughput is relative to the JSON text size throughout)" << std::endl;
+
+    if (encoded != binary || decoded.to_string() != text || view_sum != text_sum) {
+        std::cout << "[RESULT MISMATCH] MessagePack results differ from JSON" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * json_number_bench: Number parsing and printing throughput of JsonValue.
+ *
+ * Generates two number-heavy arrays:
+ *   - integers: 64-bit IDs and small counters
+ *   - doubles: random coordinates with full 17-digit precision
+ * and times, for each array:
+ *   - the old conversions on the same tokens: std::stod on a substring and
+ *     ostringstream with setprecision(15)
+ *   - the new conversions: std::from_chars / std::to_chars (shortest round trip)
+ *   - parse_json and JsonValue::to_string on the whole array
+ * Each variant runs three times and the fastest run is reported. The array is
+ * checked to survive parse -> to_string -> parse without losing a bit.
+ *
+ * How to Compile without Docker (from project root):
+ *   1. cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+ *   2. cmake --build build --target json_number_bench -- -j
+ *
+ * How to Run without Docker:
+ *   ./build/phase1/json-parser/json_number_bench [count]
+ *
+ * Usage Examples:
+ *   - Default run (1,000,000 numbers per array):
+ *     ./build/phase1/json-parser/json_number_bench
+ *
+ *   - 5,000,000 numbers per array:
+ *     ./build/phase1/json-parser/json_number_bench 5000000
+ */
+
+#include "bench_util.h"
+#include "json.h"
+#include <charconv>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using json_bench::time_seconds;
+
+void report(const std::string& name, double seconds, size_t count, double baseline_seconds) {
+    std::cout << std::left << std::setw(34) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(8) << seconds << " s"
+              << std::setprecision(1) << std::setw(10) << count / seconds / 1e6 << " M/s"
+              << std::setprecision(2) << std::setw(8) << baseline_seconds / seconds << "x" << std::endl;
+}
+
+// Returns false if the array does not round-trip exactly
+bool run_array(const std::string& name, const std::vector<std::string>& tokens) {
+    std::string text = "[";
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        text += i > 0 ? "," : "";
+        text += tokens[i];
+    }
+    text += "]";
+    std::cout << name << ": " << tokens.size() << " numbers, " << text.size() << " bytes" << std::endl;
+
+    // Token conversions in isolation
+    std::vector<double> numbers(tokens.size());
+    double stod_seconds = time_seconds([&] {
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            numbers[i] = std::stod(tokens[i].substr(0));
+        }
+    });
+    report("std::stod(substr)", stod_seconds, tokens.size(), stod_seconds);
+    double from_chars_seconds = time_seconds([&] {
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            std::from_chars(tokens[i].data(), tokens[i].data() + tokens[i].size(), numbers[i]);
+        }
+    });
+    report("std::from_chars", from_chars_seconds, tokens.size(), stod_seconds);
+
+    size_t printed = 0;
+    double ostream_seconds = time_seconds([&] {
+        printed = 0;
+        for (double number : numbers) {
+            std::ostringstream oss;
+            oss << std::setprecision(std::numeric_limits<double>::digits10) << number;
+            printed += oss.str().size();
+        }
+    });
+    report("ostringstream", ostream_seconds, tokens.size(), ostream_seconds);
+    double to_chars_seconds = time_seconds([&] {
+        printed = 0;
+        char buffer[32];
+        for (double number : numbers) {
+            printed += std::to_chars(buffer, buffer + sizeof(buffer), number).ptr - buffer;
+        }
+    });
+    report("std::to_chars", to_chars_seconds, tokens.size(), ostream_seconds);
+
+    // Whole-array parse and serialization
+    JsonValue value;
+    double parse_seconds = time_seconds([&] { value = parse_json(text); });
+    report("parse_json", parse_seconds, tokens.size(), parse_seconds);
+    std::string serialized;
+    double serialize_seconds = time_seconds([&] { serialized = value.to_string(); });
+    report("JsonValue::to_string", serialize_seconds, tokens.size(), serialize_seconds);
+
+    const JsonValue copy = parse_json(serialized);
+    const JsonArray& original = value.as_array();
+    const JsonArray& reparsed = copy.as_array();
+    for (size_t i = 0; i < original.size(); ++i) {
+        bool same = original[i].is_integer() ? reparsed[i].as_int64() == original[i].as_int64()
+                                             : reparsed[i].as_number() == original[i].as_number();
+        if (!same) {
+            std::cout << "[ROUND TRIP MISMATCH] " << name << " element " << i << std::endl;
+            return false;
+        }
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = 1000000;
+    if (argc > 1) {
+        count = std::stoull(argv[1]);
+    }
+
+    std::mt19937_64 rng(99);
+    std::vector<std::string> integers;
+    std::vector<std::string> doubles;
+    integers.reserve(count);
+    doubles.reserve(count);
+    std::uniform_real_distribution<double> coordinate(-180.0, 180.0);
+    char buffer[32];
+    for (size_t i = 0; i < count; ++i) {
+        int64_t integer = i % 2 ? static_cast<int64_t>(rng() >> 1) : static_cast<int64_t>(rng() % 10000);
+        integers.push_back(std::to_string(integer));
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), coordinate(rng));
+        doubles.emplace_back(buffer, end);
+    }
+
+    bool ok = run_array("integers", integers);
+    ok = run_array("doubles", doubles) && ok;
+    return ok ? 0 : 1;
+}
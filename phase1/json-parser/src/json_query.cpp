@@ -0,0 +1,310 @@
+#include "json_query.h"
+#include "json_detail.h"
+#include "json_dom.h"
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+bool IsWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool IsDelimiter(char c) {
+    return IsWhitespace(c) || c == ',' || c == ']' || c == '}';
+}
+
+// RFC 6901 array index: "0" or digits without a leading zero
+bool ParseIndex(const std::string& token, size_t& index) {
+    if (token.empty() || (token.size() > 1 && token[0] == '0')) {
+        return false;
+    }
+    auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), index);
+    return ec == std::errc() && ptr == token.data() + token.size();
+}
+
+} // anonymous namespace
+
+// Parser implementation
+namespace json_parser {
+
+// Walks the text along a list of reference tokens. Navigation reads only the
+// keys and separators of the containers on the path; everything else is
+// skipped as raw text.
+class QueryScanner {
+public:
+    explicit QueryScanner(std::string_view text) : p_(text.data()), end_(text.data() + text.size()) {}
+
+    std::optional<std::string_view> Find(const std::vector<std::string>& tokens) {
+        SkipWhitespace();
+        for (const std::string& token : tokens) {
+            if (p_ == end_) {
+                throw std::runtime_error("Unexpected end of input");
+            }
+            bool found = *p_ == '{' ? EnterMember(token) : *p_ == '[' ? EnterElement(token) : false;
+            if (!found) {
+                return std::nullopt;
+            }
+        }
+
+        const char* start = p_;
+        SkipValue(true);
+        return std::string_view(start, static_cast<size_t>(p_ - start));
+    }
+
+private:
+    const char* p_;
+    const char* end_;
+    JsonArena arena_{256};
+
+    void SkipWhitespace() {
+        while (p_ < end_ && IsWhitespace(*p_)) {
+            ++p_;
+        }
+    }
+
+    // Leaves p_ at the member's value, or returns false at the end of the object
+    bool EnterMember(const std::string& token) {
+        ++p_;
+        SkipWhitespace();
+        if (p_ < end_ && *p_ == '}') {
+            return false;
+        }
+        while (true) {
+            SkipWhitespace();
+            if (p_ == end_) {
+                throw std::runtime_error("Unexpected end of input while parsing object");
+            }
+            if (*p_ != '"') {
+                throw std::runtime_error("Expected string key in object");
+            }
+            const bool match = KeyEquals(token);
+
+            SkipWhitespace();
+            if (p_ == end_ || *p_ != ':') {
+                throw std::runtime_error("Expected ':' after key in object");
+            }
+            ++p_;
+            SkipWhitespace();
+            if (match) {
+                return true;
+            }
+            SkipValue(false);
+
+            SkipWhitespace();
+            if (p_ == end_) {
+                throw std::runtime_error("Unexpected end of input while parsing object");
+            }
+            if (*p_ == '}') {
+                return false;
+            } else if (*p_ == ',') {
+                ++p_;
+            } else {
+                throw std::runtime_error("Expected ',' or '}' in object");
+            }
+        }
+    }
+
+    // Leaves p_ at the element, or returns false if the array is too short
+    bool EnterElement(const std::string& token) {
+        size_t index = 0;
+        if (!ParseIndex(token, index)) {
+            return false;
+        }
+        ++p_;
+        SkipWhitespace();
+        if (p_ < end_ && *p_ == ']') {
+            return false;
+        }
+        for (size_t i = 0;; ++i) {
+            SkipWhitespace();
+            if (p_ == end_) {
+                throw std::runtime_error("Unexpected end of input while parsing array");
+            }
+            if (i == index) {
+                return true;
+            }
+            SkipValue(false);
+
+            SkipWhitespace();
+            if (p_ == end_) {
+                throw std::runtime_error("Unexpected end of input while parsing array");
+            }
+            if (*p_ == ']') {
+                return false;
+            } else if (*p_ == ',') {
+                ++p_;
+            } else {
+                throw std::runtime_error("Expected ',' or ']' in array");
+            }
+        }
+    }
+
+    // p_ is at the opening quote; on return it is past the closing quote
+    bool KeyEquals(const std::string& token) {
+        const char* begin = p_ + 1;
+        SkipString();
+        const char* last = p_ - 1;
+        if (std::memchr(begin, '\\', static_cast<size_t>(last - begin)) == nullptr) {
+            return std::string_view(begin, static_cast<size_t>(last - begin)) == token;
+        }
+        arena_.reset();
+        return UnescapeString(begin, last, arena_) == token;
+    }
+
+    // p_ is at the opening quote; jumps from quote to quote with memchr and
+    // counts the backslashes before each one to tell escaped quotes apart
+    void SkipString() {
+        const char* s = p_ + 1;
+        while (true) {
+            const char* quote = static_cast<const char*>(std::memchr(s, '"', static_cast<size_t>(end_ - s)));
+            if (quote == nullptr) {
+                throw std::runtime_error("Unterminated string");
+            }
+            const char* b = quote;
+            while (b > p_ + 1 && b[-1] == '\\') {
+                --b;
+            }
+            s = quote + 1;
+            if ((quote - b) % 2 == 0) {
+                p_ = s;
+                return;
+            }
+        }
+    }
+
+    // Skips one value. Containers are skipped by counting brackets, outside
+    // strings, without looking at their contents; validate checks scalars.
+    void SkipValue(bool validate) {
+        if (p_ == end_) {
+            throw std::runtime_error("Unexpected end of input");
+        }
+        char c = *p_;
+        if (c == '"') {
+            SkipString();
+            return;
+        }
+        if (c == '{' || c == '[') {
+            const char open = c;
+            size_t depth = 0;
+            while (p_ < end_) {
+                c = *p_;
+                if (c == '"') {
+                    SkipString();
+                    continue;
+                }
+                if (c == '{' || c == '[') {
+                    ++depth;
+                } else if (c == '}' || c == ']') {
+                    if (--depth == 0) {
+                        ++p_;
+                        return;
+                    }
+                }
+                ++p_;
+            }
+            throw std::runtime_error(open == '[' ? "Unexpected end of input while parsing array"
+                                             : "Unexpected end of input while parsing object");
+        }
+
+        const char* start = p_;
+        while (p_ < end_ && !IsDelimiter(*p_)) {
+            ++p_;
+        }
+        if (start == p_) {
+            throw std::runtime_error("Unexpected character: " + std::string(1, c));
+        }
+        if (validate) {
+            std::string_view scalar(start, static_cast<size_t>(p_ - start));
+            if (c == '-' || (c >= '0' && c <= '9')) {
+                if (!IsValidNumber(start, p_)) {
+                    throw std::runtime_error("Invalid number format: " + std::string(scalar));
+                }
+            } else if (scalar != "true" && scalar != "false" && scalar != "null") {
+                throw std::runtime_error("Unexpected character: " + std::string(1, c));
+            }
+        }
+    }
+};
+
+} // namespace json_parser
+
+JsonPointer::JsonPointer(std::string_view pointer) {
+    if (pointer.empty()) {
+        return;
+    }
+    if (pointer[0] != '/') {
+        throw std::runtime_error("Invalid JSON Pointer: " + std::string(pointer));
+    }
+    std::string token;
+    for (size_t i = 1; i <= pointer.size(); ++i) {
+        if (i == pointer.size() || pointer[i] == '/') {
+            tokens_.push_back(std::move(token));
+            token.clear();
+        } else if (pointer[i] == '~') {
+            if (i + 1 == pointer.size() || (pointer[i + 1] != '0' && pointer[i + 1] != '1')) {
+                throw std::runtime_error("Invalid JSON Pointer: " + std::string(pointer));
+            }
+            token += pointer[++i] == '0' ? '~' : '/';
+        } else {
+            token += pointer[i];
+        }
+    }
+}
+
+JsonPointer JsonPointer::from_path(std::string_view path) {
+    JsonPointer result;
+    size_t i = 0;
+    while (i < path.size()) {
+        if (path[i] == '[') {
+            size_t close = path.find(']', i);
+            if (close == std::string_view::npos || close == i + 1) {
+                throw std::runtime_error("Invalid path: " + std::string(path));
+            }
+            result.tokens_.emplace_back(path.substr(i + 1, close - i - 1));
+            i = close + 1;
+            if (i < path.size() && path[i] != '.' && path[i] != '[') {
+                throw std::runtime_error("Invalid path: " + std::string(path));
+            }
+        } else {
+            size_t stop = path.find_first_of(".[", i);
+            if (stop == std::string_view::npos) {
+                stop = path.size();
+            }
+            if (stop == i) {
+                throw std::runtime_error("Invalid path: " + std::string(path));
+            }
+            result.tokens_.emplace_back(path.substr(i, stop - i));
+            i = stop;
+        }
+        if (i < path.size() && path[i] == '.') {
+            if (++i == path.size()) {
+                throw std::runtime_error("Invalid path: " + std::string(path));
+            }
+        }
+    }
+    return result;
+}
+
+std::optional<std::string_view> JsonPointer::find(std::string_view json_text) const {
+    json_parser::QueryScanner scanner(json_text);
+    return scanner.Find(tokens_);
+}
+
+std::optional<JsonValue> JsonPointer::get(std::string_view json_text) const {
+    std::optional<std::string_view> raw = find(json_text);
+    if (!raw) {
+        return std::nullopt;
+    }
+    // Parsed like the keys on the path, so \u escapes decode to UTF-8
+    return parse_json_document(*raw).root().to_value();
+}
+
+std::optional<std::string_view> JsonPointer::find_string(std::string_view json_text) const {
+    std::optional<std::string_view> raw = find(json_text);
+    if (!raw || raw->front() != '"' || raw->find('\\') != std::string_view::npos) {
+        return std::nullopt;
+    }
+    return raw->substr(1, raw->size() - 2);
+}
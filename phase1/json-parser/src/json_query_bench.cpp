@@ -0,0 +1,139 @@
+/*
+ * json_query_bench: Cost of reading a few fields from a large document.
+ *
+ * Generates request documents: a small "request" object with headers up
+ * front, followed by a large "payload" array. Three fields are read per
+ * document:
+ *   /request/headers/host, /request/headers/user-agent and /trailer/status
+ * The last one sits after the payload, so it measures the cost of skipping a
+ * large subtree. Times, per document:
+ *   - parse_json, then operator[] lookups
+ *   - parse_json_document (arena DOM), then find() lookups
+ *   - JsonPointer::find for each field (lazy, no nodes built)
+ * Each variant runs three times and the fastest run is reported. The three
+ * variants' results are compared.
+ *
+ * How to Compile without Docker (from project root):
+ *   1. cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+ *   2. cmake --build build --target json_query_bench -- -j
+ *
+ * How to Run without Docker:
+ *   ./build/phase1/json-parser/json_query_bench [payload_items] [documents]
+ *
+ * Usage Examples:
+ *   - Default run (2,000 payload items, 200 documents):
+ *     ./build/phase1/json-parser/json_query_bench
+ *
+ *   - Small documents:
+ *     ./build/phase1/json-parser/json_query_bench 20 20000
+ */
+
+#include "bench_util.h"
+#include "json.h"
+#include "json_dom.h"
+#include "json_query.h"
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using json_bench::time_seconds;
+
+std::string generate_request(int payload_items, int seq) {
+    std::string text = "{\"request\":{\"method\":\"POST\",\"path\":\"/api/v1/orders\",\"headers\":{";
+    text += "\"accept\":\"application/json\",\"host\":\"shard-" + std::to_string(seq % 8) + ".example.com\",";
+    text += "\"user-agent\":\"client/" + std::to_string(seq % 5) + ".0\",\"x-request-id\":\"" +
+            std::to_string(1000000 + seq) + "\"}},\"payload\":[";
+    for (int i = 0; i < payload_items; ++i) {
+        if (i > 0) {
+            text += ",";
+        }
+        text += "{\"sku\":\"SKU-" + std::to_string(i) + "\",\"qty\":" + std::to_string(i % 9 + 1) +
+                ",\"price\":" + std::to_string(i % 100) + ".99,\"note\":\"fragile \\\"glass\\\" [handle] {care}\"" +
+                ",\"dims\":[" + std::to_string(i % 30) + "," + std::to_string(i % 20) + "," + std::to_string(i % 10) +
+                "]}";
+    }
+    text += "],\"trailer\":{\"status\":\"ok-" + std::to_string(seq) + "\"}}";
+    return text;
+}
+
+void report(const std::string& name, double seconds, size_t documents, double baseline_seconds) {
+    std::cout << std::left << std::setw(34) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(8) << seconds << " s"
+              << std::setprecision(2) << std::setw(10) << seconds * 1e6 / documents << " us/doc"
+              << std::setprecision(2) << std::setw(10) << baseline_seconds / seconds << "x" << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    int payload_items = 2000;
+    int count = 200;
+    if (argc > 1) {
+        payload_items = std::stoi(argv[1]);
+    }
+    if (argc > 2) {
+        count = std::stoi(argv[2]);
+    }
+
+    std::vector<std::string> documents;
+    size_t total_bytes = 0;
+    for (int i = 0; i < count; ++i) {
+        documents.push_back(generate_request(payload_items, i));
+        total_bytes += documents.back().size();
+    }
+    std::cout << "Documents: " << count << ", " << total_bytes / count << " bytes each" << std::endl;
+
+    std::vector<std::string> expected(documents.size());
+    double baseline = time_seconds([&] {
+        for (size_t i = 0; i < documents.size(); ++i) {
+            JsonValue value = parse_json(documents[i]);
+            const JsonValue& headers = value["request"]["headers"];
+            expected[i] = headers["host"].as_string() + " " + headers["user-agent"].as_string() + " " +
+                          value["trailer"]["status"].as_string();
+        }
+    });
+    report("parse_json + operator[]", baseline, documents.size(), baseline);
+
+    std::vector<std::string> from_dom(documents.size());
+    double dom_seconds = time_seconds([&] {
+        for (size_t i = 0; i < documents.size(); ++i) {
+            JsonDocument document = parse_json_document(documents[i]);
+            const JsonNode& headers = document.root()["request"]["headers"];
+            from_dom[i] = std::string(headers["host"].as_string()) + " " +
+                          std::string(headers["user-agent"].as_string()) + " " +
+                          std::string(document.root()["trailer"]["status"].as_string());
+        }
+    });
+    report("parse_json_document + find", dom_seconds, documents.size(), baseline);
+
+    const JsonPointer host("/request/headers/host");
+    const JsonPointer agent("/request/headers/user-agent");
+    const JsonPointer status("/trailer/status");
+    std::vector<std::string> from_query(documents.size());
+    double query_seconds = time_seconds([&] {
+        for (size_t i = 0; i < documents.size(); ++i) {
+            from_query[i] = std::string(*host.find_string(documents[i])) + " " +
+                            std::string(*agent.find_string(documents[i])) + " " +
+                            std::string(*status.find_string(documents[i]));
+        }
+    });
+    report("JsonPointer::find_string x3", query_seconds, documents.size(), baseline);
+
+    std::vector<std::string> headers_only(documents.size());
+    double headers_seconds = time_seconds([&] {
+        for (size_t i = 0; i < documents.size(); ++i) {
+            headers_only[i] = std::string(*host.find_string(documents[i]));
+        }
+    });
+    report("  header field only", headers_seconds, documents.size(), baseline);
+
+    if (from_dom != expected || from_query != expected) {
+        std::cout << "[RESULT MISMATCH] query results differ from parse_json" << std::endl;
+        return 1;
+    }
+    return 0;
+}
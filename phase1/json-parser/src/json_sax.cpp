@@ -0,0 +1,380 @@
+#include "json_sax.h"
+#include "json_detail.h"
+#include <charconv>
+#include <istream>
+#include <stdexcept>
+
+namespace {
+
+bool IsWhitespace(int c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool IsNumberChar(char c) {
+    return IsDigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+void AppendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+} // anonymous namespace
+
+JsonStreamReader::JsonStreamReader(std::istream& in, size_t buffer_size)
+    : in_(in), buffer_(buffer_size > 0 ? buffer_size : 1) {}
+
+bool JsonStreamReader::Refill() {
+    consumed_ += end_;
+    pos_ = 0;
+    end_ = 0;
+    if (in_) {
+        in_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        end_ = static_cast<size_t>(in_.gcount());
+    }
+    return end_ > 0;
+}
+
+int JsonStreamReader::Peek() {
+    if (pos_ == end_ && !Refill()) {
+        return -1;
+    }
+    return static_cast<unsigned char>(buffer_[pos_]);
+}
+
+int JsonStreamReader::Get() {
+    int c = Peek();
+    if (c >= 0) {
+        ++pos_;
+    }
+    return c;
+}
+
+void JsonStreamReader::Expect(char c, const char* message) {
+    if (Get() != static_cast<unsigned char>(c)) {
+        Fail(message);
+    }
+}
+
+void JsonStreamReader::Fail(const std::string& message) const {
+    throw std::runtime_error(message + " at byte " + std::to_string(offset()));
+}
+
+void JsonStreamReader::SkipWhitespace() {
+    while (true) {
+        while (pos_ < end_ && IsWhitespace(buffer_[pos_])) {
+            ++pos_;
+        }
+        if (pos_ < end_ || !Refill()) {
+            return;
+        }
+    }
+}
+
+bool JsonStreamReader::parse(JsonHandler& handler) {
+    SkipWhitespace();
+    if (!ParseValue(handler) || !handler.on_end_document()) {
+        return false;
+    }
+
+    // Ensure we've consumed the entire input
+    SkipWhitespace();
+    if (Peek() >= 0) {
+        Fail("Unexpected characters at end of input");
+    }
+    return true;
+}
+
+size_t JsonStreamReader::parse_ndjson(JsonHandler& handler) {
+    size_t records = 0;
+    while (true) {
+        SkipWhitespace();
+        if (Peek() < 0) {
+            return records;
+        }
+        if (!ParseValue(handler)) {
+            return records;
+        }
+        ++records;
+        if (!handler.on_end_document()) {
+            return records;
+        }
+
+        // The rest of the record's line may only hold blanks
+        int c = Peek();
+        while (c == ' ' || c == '\t' || c == '\r') {
+            ++pos_;
+            c = Peek();
+        }
+        if (c >= 0 && c != '\n') {
+            Fail("Expected newline after NDJSON record");
+        }
+    }
+}
+
+// Iterative: containers are pushed on stack_ and popped when they close
+bool JsonStreamReader::ParseValue(JsonHandler& handler) {
+    stack_.clear();
+    bool expect_key = false;
+    while (true) {
+        SkipWhitespace();
+        if (expect_key) {
+            Expect('"', "Expected string key in object");
+            if (!handler.on_key(ParseString())) {
+                return false;
+            }
+            SkipWhitespace();
+            Expect(':', "Expected ':' after key in object");
+            SkipWhitespace();
+        }
+
+        int c = Get();
+        if (c == '{') {
+            if (!handler.on_start_object()) {
+                return false;
+            }
+            SkipWhitespace();
+            if (Peek() != '}') {
+                stack_.push_back(true);
+                expect_key = true;
+                continue;
+            }
+            ++pos_;
+            if (!handler.on_end_object()) {
+                return false;
+            }
+        } else if (c == '[') {
+            if (!handler.on_start_array()) {
+                return false;
+            }
+            SkipWhitespace();
+            if (Peek() != ']') {
+                stack_.push_back(false);
+                expect_key = false;
+                continue;
+            }
+            ++pos_;
+            if (!handler.on_end_array()) {
+                return false;
+            }
+        } else if (!ParseScalar(c, handler)) {
+            return false;
+        }
+
+        // A value is complete: close containers until one continues with ','
+        while (true) {
+            if (stack_.empty()) {
+                return true;
+            }
+            SkipWhitespace();
+            c = Get();
+            if (stack_.back()) {
+                if (c == '}') {
+                    stack_.pop_back();
+                    if (!handler.on_end_object()) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (c == ',') {
+                    expect_key = true;
+                    break;
+                }
+                Fail(c < 0 ? "Unexpected end of input while parsing object" : "Expected ',' or '}' in object");
+            } else {
+                if (c == ']') {
+                    stack_.pop_back();
+                    if (!handler.on_end_array()) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (c == ',') {
+                    expect_key = false;
+                    break;
+                }
+                Fail(c < 0 ? "Unexpected end of input while parsing array" : "Expected ',' or ']' in array");
+            }
+        }
+    }
+}
+
+// c has already been consumed
+bool JsonStreamReader::ParseScalar(int c, JsonHandler& handler) {
+    switch (c) {
+        case '"': return handler.on_string(ParseString());
+        case 't': ParseLiteral("true"); return handler.on_bool(true);
+        case 'f': ParseLiteral("false"); return handler.on_bool(false);
+        case 'n': ParseLiteral("null"); return handler.on_null();
+        case -1: Fail("Unexpected end of input");
+        default:
+            --pos_; // Get() just returned c from the current buffer
+            if (c == '-' || IsDigit(static_cast<char>(c))) {
+                return ParseNumber(handler);
+            }
+            Fail("Unexpected character: " + std::string(1, static_cast<char>(c)));
+    }
+}
+
+// Called after the opening quote. Strings without escapes that lie within the
+// buffer are returned as views into it; everything else goes through scratch_.
+std::string_view JsonStreamReader::ParseString() {
+    const size_t start = pos_;
+    while (pos_ < end_) {
+        char c = buffer_[pos_];
+        if (c == '"') {
+            return std::string_view(buffer_.data() + start, pos_++ - start);
+        }
+        if (c == '\\') {
+            break;
+        }
+        ++pos_;
+    }
+
+    scratch_.assign(buffer_.data() + start, pos_ - start);
+    while (true) {
+        size_t run = pos_;
+        while (run < end_ && buffer_[run] != '"' && buffer_[run] != '\\') {
+            ++run;
+        }
+        scratch_.append(buffer_.data() + pos_, run - pos_);
+        pos_ = run;
+        if (pos_ == end_) {
+            if (!Refill()) {
+                Fail("Unterminated string");
+            }
+            continue;
+        }
+        if (buffer_[pos_++] == '"') {
+            return scratch_;
+        }
+        ParseEscape();
+    }
+}
+
+// Called after the backslash; appends the unescaped text to scratch_
+void JsonStreamReader::ParseEscape() {
+    int c = Get();
+    switch (c) {
+        case '"':  scratch_ += '"';  return;
+        case '\\': scratch_ += '\\'; return;
+        case '/':  scratch_ += '/';  return;
+        case 'b':  scratch_ += '\b'; return;
+        case 'f':  scratch_ += '\f'; return;
+        case 'n':  scratch_ += '\n'; return;
+        case 'r':  scratch_ += '\r'; return;
+        case 't':  scratch_ += '\t'; return;
+        case 'u':  break;
+        case -1:   Fail("Unexpected end of input in string");
+        default:   Fail("Invalid escape sequence: \\" + std::string(1, static_cast<char>(c)));
+    }
+
+    auto read_hex4 = [this] {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            int h = Get();
+            value <<= 4;
+            if (h >= '0' && h <= '9') {
+                value |= static_cast<uint32_t>(h - '0');
+            } else if (h >= 'a' && h <= 'f') {
+                value |= static_cast<uint32_t>(h - 'a' + 10);
+            } else if (h >= 'A' && h <= 'F') {
+                value |= static_cast<uint32_t>(h - 'A' + 10);
+            } else {
+                Fail("Invalid unicode escape sequence");
+            }
+        }
+        return value;
+    };
+
+    // Surrogate pairs are combined; an unpaired surrogate becomes U+FFFD
+    uint32_t cp = read_hex4();
+    if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        cp = 0xFFFD;
+    } else if (cp >= 0xD800 && cp <= 0xDBFF) {
+        if (Peek() != '\\') {
+            cp = 0xFFFD;
+        } else {
+            ++pos_;
+            if (Peek() != 'u') {
+                AppendUtf8(scratch_, 0xFFFD);
+                ParseEscape();
+                return;
+            }
+            ++pos_;
+            uint32_t low = read_hex4();
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            } else {
+                AppendUtf8(scratch_, 0xFFFD);
+                cp = low >= 0xD800 && low <= 0xDBFF ? 0xFFFD : low;
+            }
+        }
+    }
+    AppendUtf8(scratch_, cp);
+}
+
+// Numbers that end inside the buffer are converted in place
+bool JsonStreamReader::ParseNumber(JsonHandler& handler) {
+    const size_t start = pos_;
+    while (pos_ < end_ && IsNumberChar(buffer_[pos_])) {
+        ++pos_;
+    }
+    const char* first = buffer_.data() + start;
+    const char* last = buffer_.data() + pos_;
+    if (pos_ == end_) {
+        number_.assign(first, last);
+        while (Refill()) {
+            const size_t run = pos_;
+            while (pos_ < end_ && IsNumberChar(buffer_[pos_])) {
+                ++pos_;
+            }
+            number_.append(buffer_.data() + run, pos_ - run);
+            if (pos_ < end_) {
+                break;
+            }
+        }
+        first = number_.data();
+        last = number_.data() + number_.size();
+    }
+
+    if (!json_parser::IsValidNumber(first, last)) {
+        Fail("Invalid number format: " + std::string(first, last));
+    }
+    int64_t integer = 0;
+    if (json_parser::ParseInt64(first, last, integer)) {
+        return handler.on_integer(integer);
+    }
+    double value = 0;
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    if (ec != std::errc() || ptr != last) {
+        Fail("Invalid number format: " + std::string(first, last));
+    }
+    return handler.on_number(value);
+}
+
+// The first character has already been consumed
+void JsonStreamReader::ParseLiteral(std::string_view literal) {
+    for (size_t i = 1; i < literal.size(); ++i) {
+        if (Get() != literal[i]) {
+            Fail("Expected '" + std::string(literal) + "'");
+        }
+    }
+}
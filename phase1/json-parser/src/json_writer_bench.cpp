@@ -0,0 +1,183 @@
+/*
+ * json_writer_bench: Serialization throughput of JsonValue::write against the old to_string.
+ *
+ * Builds a JsonValue holding a large array of event objects (strings with
+ * the occasional quote or control character, numbers, nested tags) and times:
+ *   - the old recursive serializer, which returned a std::string per value
+ *     and concatenated them (reproduced here as the baseline)
+ *   - JsonValue::to_string
+ *   - JsonValue::write into a reused std::string
+ *   - JsonValue::write to a std::ofstream
+ *   - JsonValue::write with pretty printing
+ * Each variant runs three times and the fastest run is reported. The compact
+ * outputs are compared with each other.
+ *
+ * How to Compile without Docker (from project root):
+ *   1. cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+ *   2. cmake --build build --target json_writer_bench -- -j
+ *
+ * How to Run without Docker:
+ *   ./build/phase1/json-parser/json_writer_bench [events]
+ *
+ * Usage Examples:
+ *   - Default run (200,000 events):
+ *     ./build/phase1/json-parser/json_writer_bench
+ *
+ *   - 1,000,000 events:
+ *     ./build/phase1/json-parser/json_writer_bench 1000000
+ */
+
+#include "bench_util.h"
+#include "json.h"
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+using json_bench::time_seconds;
+using json_bench::report;
+
+// The serializer JsonValue::to_string used before write() existed
+std::string legacy_escape(const std::string& str) {
+    std::string result = "\"";
+    for (char c : str) {
+        switch (c) {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\b': result += "\\b";  break;
+            case '\f': result += "\\f";  break;
+            case '\n': result += "\\n";  break;
+            case '\r': result += "\\r";  break;
+            case '\t': result += "\\t";  break;
+            default:
+                if (c >= 0 && c < 0x20) {
+                    std::ostringstream oss;
+                    oss << "\\u00" << std::hex << std::setw(2) << std::setfill('0') << (int)c;
+                    result += oss.str();
+                } else {
+                    result += c;
+                }
+                break;
+        }
+    }
+    result += "\"";
+    return result;
+}
+
+std::string legacy_to_string(const JsonValue& value) {
+    if (value.is_null()) {
+        return "null";
+    } else if (value.is_bool()) {
+        return value.as_bool() ? "true" : "false";
+    } else if (value.is_integer()) {
+        return std::to_string(value.as_int64());
+    } else if (value.is_number()) {
+        char buffer[32];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value.as_number());
+        return std::string(buffer, end);
+    } else if (value.is_string()) {
+        return legacy_escape(value.as_string());
+    } else if (value.is_array()) {
+        std::string result = "[";
+        bool first = true;
+        for (const auto& element : value.as_array()) {
+            if (!first) {
+                result += ",";
+            }
+            first = false;
+            result += legacy_to_string(element);
+        }
+        return result + "]";
+    }
+    std::string result = "{";
+    bool first = true;
+    for (const auto& pair : value.as_object()) {
+        if (!first) {
+            result += ",";
+        }
+        first = false;
+        result += legacy_escape(pair.first) + ":" + legacy_to_string(pair.second);
+    }
+    return result + "}";
+}
+
+JsonValue generate_events(int count) {
+    static const char* const services[] = {"api-gateway", "billing", "search", "auth", "inventory"};
+    JsonValue events = JsonArray();
+    for (int seq = 0; seq < count; ++seq) {
+        JsonValue event = JsonObject();
+        event.insert("id", JsonValue(static_cast<int64_t>(seq)));
+        event.insert("service", JsonValue(services[seq % 5]));
+        event.insert("latency_ms", JsonValue(0.25 * seq + 0.125));
+        event.insert("ok", JsonValue(seq % 7 != 0));
+        event.insert("parent", seq % 3 ? JsonValue(static_cast<int64_t>(seq - 1)) : JsonValue(nullptr));
+        JsonValue tags = JsonObject();
+        tags.insert("region", JsonValue("eu-west-" + std::to_string(seq % 3)));
+        tags.insert("host", JsonValue("node-" + std::to_string(seq % 64)));
+        event.insert("tags", tags);
+        if (seq % 16 == 0) {
+            event.insert("message", JsonValue("request \"" + std::to_string(seq) + "\" failed:\n\tretrying\x01"));
+        } else {
+            event.insert("message", JsonValue("request completed in the usual amount of time"));
+        }
+        events.push_back(std::move(event));
+    }
+    return events;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    int count = 200000;
+    if (argc > 1) {
+        count = std::stoi(argv[1]);
+    }
+
+    const JsonValue events = generate_events(count);
+
+    std::string legacy;
+    double baseline = time_seconds([&] { legacy = legacy_to_string(events); });
+    std::cout << "Output: " << legacy.size() << " bytes" << std::endl;
+    report("recursive concatenation (old)", baseline, legacy.size(), baseline);
+
+    std::string compact;
+    double to_string_seconds = time_seconds([&] { compact = events.to_string(); });
+    report("to_string", to_string_seconds, compact.size(), baseline);
+
+    std::string reused;
+    double reused_seconds = time_seconds([&] {
+        reused.clear();
+        events.write(reused);
+    });
+    report("write (reused buffer)", reused_seconds, reused.size(), baseline);
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "json_writer_bench.json";
+    double stream_seconds = time_seconds([&] {
+        std::ofstream out(path, std::ios::binary);
+        events.write(out);
+    });
+    report("write (std::ofstream)", stream_seconds, compact.size(), baseline);
+    const uintmax_t file_size = std::filesystem::file_size(path);
+    std::filesystem::remove(path);
+
+    JsonWriteOptions pretty;
+    pretty.pretty = true;
+    std::string pretty_text;
+    double pretty_seconds = time_seconds([&] {
+        pretty_text.clear();
+        events.write(pretty_text, pretty);
+    });
+    report("write (pretty, reused buffer)", pretty_seconds, pretty_text.size(), baseline);
+
+    if (compact != legacy || reused != legacy || file_size != legacy.size()) {
+        std::cout << "[RESULT MISMATCH] writer output differs from the old serializer" << std::endl;
+        return 1;
+    }
+    return 0;
+}
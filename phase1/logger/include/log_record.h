@@ -0,0 +1,175 @@
+#ifndef LOG_RECORD_H
+#define LOG_RECORD_H
+
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+enum class LogLevel {
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR
+};
+
+// Bytes of encoded arguments a record holds inline; larger argument lists
+// spill into the record's heap buffer, which keeps its capacity across laps
+constexpr size_t LOG_RECORD_INLINE_BYTES = 160;
+
+// Tag written before every encoded argument
+enum class LogArgType : uint8_t {
+    INT,     // int64_t
+    UINT,    // uint64_t
+    DOUBLE,  // double
+    BOOL,    // uint8_t
+    CHAR,    // char
+    STRING,  // uint32_t length, then the bytes
+    POINTER  // uintptr_t
+};
+
+// One log call as captured on the caller's thread: a raw timestamp, the
+// caller's thread id, a pointer to the (static) format string and the
+// arguments in binary form. Nothing is formatted until the worker hands the
+// record to a LogFormatter.
+struct LogRecord {
+    int64_t timestamp = 0; // system_clock ticks since the epoch
+    std::thread::id thread;
+    LogLevel level = LogLevel::INFO;
+    const char* format = "";
+    uint32_t size = 0;     // Encoded argument bytes
+    std::string spill;     // Holds the arguments when they exceed the inline buffer
+    alignas(8) unsigned char inline_args[LOG_RECORD_INLINE_BYTES];
+
+    const unsigned char* args() const {
+        return size <= LOG_RECORD_INLINE_BYTES ? inline_args
+                                                : reinterpret_cast<const unsigned char*>(spill.data());
+    }
+};
+
+namespace log_record_detail {
+
+template <typename T>
+struct ArgTraits {
+    using Arg = std::remove_cvref_t<T>;
+    static_assert(std::is_arithmetic_v<Arg> || std::is_pointer_v<Arg> || std::is_enum_v<Arg>,
+                  "Logger arguments must be arithmetic, enums, pointers or strings");
+
+    static constexpr size_t size(const Arg&) { return 1 + 8; }
+
+    static unsigned char* write(unsigned char* out, const Arg& value) {
+        if constexpr (std::is_same_v<Arg, bool>) {
+            *out++ = static_cast<unsigned char>(LogArgType::BOOL);
+            *out = value ? 1 : 0;
+            return out + 8;
+        } else if constexpr (std::is_same_v<Arg, char>) {
+            *out++ = static_cast<unsigned char>(LogArgType::CHAR);
+            *out = static_cast<unsigned char>(value);
+            return out + 8;
+        } else if constexpr (std::is_floating_point_v<Arg>) {
+            return store(out, LogArgType::DOUBLE, static_cast<double>(value));
+        } else if constexpr (std::is_pointer_v<Arg>) {
+            return store(out, LogArgType::POINTER, reinterpret_cast<uintptr_t>(value));
+        } else if constexpr (std::is_enum_v<Arg>) {
+            return ArgTraits<std::underlying_type_t<Arg>>::write(out, static_cast<std::underlying_type_t<Arg>>(value));
+        } else if constexpr (std::is_signed_v<Arg>) {
+            return store(out, LogArgType::INT, static_cast<int64_t>(value));
+        } else {
+            return store(out, LogArgType::UINT, static_cast<uint64_t>(value));
+        }
+    }
+
+    template <typename V>
+    static unsigned char* store(unsigned char* out, LogArgType type, V value) {
+        static_assert(sizeof(V) == 8);
+        *out++ = static_cast<unsigned char>(type);
+        std::memcpy(out, &value, sizeof(V));
+        return out + sizeof(V);
+    }
+};
+
+// Strings are copied, so the caller's buffer may be reused as soon as the
+// log call returns
+struct StringArg {
+    static size_t size(std::string_view value) { return 1 + sizeof(uint32_t) + value.size(); }
+
+    static unsigned char* write(unsigned char* out, std::string_view value) {
+        *out++ = static_cast<unsigned char>(LogArgType::STRING);
+        const auto length = static_cast<uint32_t>(value.size());
+        std::memcpy(out, &length, sizeof(length));
+        out += sizeof(length);
+        std::memcpy(out, value.data(), value.size());
+        return out + value.size();
+    }
+};
+
+template <>
+struct ArgTraits<std::string> : StringArg {};
+template <>
+struct ArgTraits<std::string_view> : StringArg {};
+template <>
+struct ArgTraits<const char*> : StringArg {};
+template <>
+struct ArgTraits<char*> : StringArg {};
+
+template <typename T>
+using Traits = ArgTraits<std::conditional_t<std::is_array_v<std::remove_cvref_t<T>>, const char*, std::remove_cvref_t<T>>>;
+
+} // namespace log_record_detail
+
+// Capture a log call into record. Sizes every argument first, so the
+// arguments are written in one pass straight into their final buffer.
+template <typename... Args>
+void encodeLogRecord(LogRecord& record, LogLevel level, const char* format, const Args&... args) {
+    using namespace log_record_detail;
+    record.timestamp = std::chrono::system_clock::now().time_since_epoch().count();
+    record.thread = std::this_thread::get_id();
+    record.level = level;
+    record.format = format;
+
+    if constexpr (sizeof...(Args) == 0) {
+        record.size = 0;
+    } else {
+        const size_t size = (size_t{0} + ... + Traits<Args>::size(args));
+        record.size = static_cast<uint32_t>(size);
+        unsigned char* out = record.inline_args;
+        if (size > LOG_RECORD_INLINE_BYTES) {
+            record.spill.resize(size);
+            out = reinterpret_cast<unsigned char*>(record.spill.data());
+        }
+        ((out = Traits<Args>::write(out, args)), ...);
+    }
+}
+
+// Append the record's message to out: every "{}" in the format string is
+// replaced by the next argument, "{{" and "}}" stand for literal braces.
+// Placeholders beyond the last argument are kept as-is.
+void formatLogArgs(const LogRecord& record, std::string& out);
+
+const char* levelToString(LogLevel level);
+
+// Turns records into complete lines on the worker thread:
+//   "YYYY-mm-dd HH:MM:SS [LEVEL] [Thread <id>] <message>"
+// localtime() runs once per distinct second and each thread id is
+// stringified once, so formatting a line is mostly appends.
+class LogFormatter {
+public:
+    // Append the line for record to out, without a trailing newline
+    void format(const LogRecord& record, std::string& out);
+
+private:
+    const std::string& threadName(std::thread::id thread);
+
+    int64_t m_second = INT64_MIN;
+    char m_timePrefix[32] = {};
+    size_t m_timePrefixLength = 0;
+    std::unordered_map<std::thread::id, std::string> m_threadNames;
+};
+
+#endif // LOG_RECORD_H
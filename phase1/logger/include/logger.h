@@ -1,18 +1,63 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
-#include <string>
-#include <mutex>
+#include "log_record.h"
+#include "spsc_ring.h"
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
-#include <queue>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
-#include <fstream>
+#include <vector>
+
+// Levels below LOGGER_MIN_LEVEL (0 = DEBUG ... 3 = ERROR) are compiled out
+// of the LOG_* macros: the call, including its arguments, never runs.
+// Set it for a build with -DLOGGER_MIN_LEVEL=<n> (CMake: LOGGER_MIN_LEVEL).
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL 0
+#endif
+constexpr LogLevel LOGGER_COMPILED_MIN_LEVEL = static_cast<LogLevel>(LOGGER_MIN_LEVEL);
+
+// What log() does when the calling thread's staging buffer is full
+enum class OverflowPolicy {
+    BLOCK,          // Wait for the worker to free a slot (no message is lost)
+    DROP,           // Discard the message and count it in droppedCount()
+    DROP_AND_REPORT // As DROP, and the worker also logs how many were lost
+};
+
+// Number of preallocated record slots in each producer thread's staging
+// buffer (about 116 KiB per thread). The worker drains every buffer as soon
+// as it is woken, so bursts rarely need more.
+constexpr size_t LOGGER_RING_CAPACITY = 512;
+
+// One producer thread's records, drained by the worker. Owned jointly by the
+// logger and the thread, so either may go away first.
+struct LogStagingBuffer {
+    explicit LogStagingBuffer(size_t capacity) : ring(capacity) {}
 
-enum class LogLevel {
-    DEBUG,
-    INFO,
-    WARN,
-    ERROR
+    SpscRing<LogRecord> ring;
+    std::atomic<bool> retired{false}; // The owning thread has exited
+};
+
+// Output file, batching and rotation settings, applied with Logger::configure()
+struct LoggerOptions {
+    std::string path = "app.log";
+    // The worker collects formatted lines in one buffer and writes it with a
+    // single write() once it holds flushBytes, once flushInterval has passed
+    // since the last write, or when flush() is called
+    size_t flushBytes = 64 * 1024;
+    std::chrono::milliseconds flushInterval{50};
+    // Rotate before a line would take the file past rotateBytes, or on the
+    // first write after rotateInterval has passed (0 disables either).
+    // The current file becomes path.1, path.1 becomes path.2 and so on;
+    // files beyond path.<maxFiles> are deleted.
+    uint64_t rotateBytes = 0;
+    std::chrono::seconds rotateInterval{0};
+    int maxFiles = 5;
 };
 
 class Logger {
@@ -20,20 +65,140 @@ public:
     static Logger& getInstance();
     void log(LogLevel level, const std::string& message);
 
+    // Messages below the minimum level are discarded before anything is
+    // captured. The LOG_* macros check it before evaluating their arguments.
+    void setMinLevel(LogLevel level);
+    LogLevel minLevel() const;
+    bool isEnabled(LogLevel level) const {
+        return level >= m_minLevel.load(std::memory_order_relaxed);
+    }
+
+    // Structured logging: capture a timestamp, the thread id and the typed
+    // arguments into the calling thread's staging buffer, and leave all
+    // formatting to the worker.
+    // "{}" in format is replaced by the next argument ("{{" / "}}" escape a
+    // brace). format is stored by pointer, so it must be a string literal or
+    // otherwise outlive the logger; string arguments are copied.
+    //   logger.logFormat(LogLevel::INFO, "order {} took {} ms", id, elapsed);
+    template <typename... Args>
+    void logFormat(LogLevel level, const char* format, const Args&... args) {
+        if (!isEnabled(level)) {
+            return;
+        }
+        publish([&](LogRecord& record) { encodeLogRecord(record, level, format, args...); });
+    }
+
+    void setOverflowPolicy(OverflowPolicy policy);
+    OverflowPolicy overflowPolicy() const;
+    // Messages discarded because a staging buffer was full
+    uint64_t droppedCount() const;
+
+    // Block until every message logged before the call has been written
+    void flush();
+
+    // Flush, then switch to the given options. Reopens the file if the path
+    // changed. Rotation happens on the worker, so producers never wait for it.
+    void configure(const LoggerOptions& options);
+    LoggerOptions options() const;
+    // write() calls made by the worker so far
+    uint64_t writeCount() const;
+
 private:
     Logger();
     ~Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
+    // Fill a slot of the calling thread's staging buffer in place, applying
+    // the overflow policy when it is full
+    template <typename F>
+    void publish(F&& fill) {
+        LogStagingBuffer* staging = s_staging;
+        if (staging == nullptr) {
+            staging = registerThread();
+        }
+        SpscRing<LogRecord>& ring = staging->ring;
+        if (!ring.tryEmplace(fill)) {
+            if (m_policy.load(std::memory_order_relaxed) != OverflowPolicy::BLOCK) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            do {
+                wakeWorker();
+                std::this_thread::yield();
+            } while (!ring.tryEmplace(fill));
+        }
+        wakeWorker();
+    }
+
+    struct StagingOwner;
+    LogStagingBuffer* registerThread();
+    size_t drainStagingBuffers();
+    bool stagingBuffersEmpty() const;
+
     void worker();
+    void wakeWorker();
+    void sleep(bool pendingOutput, std::chrono::steady_clock::time_point deadline);
+    void append(const LogRecord& record);
+    void writeOut();
+    void openFile();
+    void rotate();
+    void applyOptions();
 
-    std::mutex m_mutex;
-    std::condition_variable m_cv;
-    std::queue<std::string> m_queue;
+    // The calling thread's staging buffer, registered on its first message
+    static inline thread_local LogStagingBuffer* s_staging = nullptr;
+
+    std::mutex m_buffersMutex;
+    std::vector<std::shared_ptr<LogStagingBuffer>> m_buffers; // Guarded by m_buffersMutex
+    std::atomic<uint64_t> m_buffersVersion{0};                // Bumped when m_buffers changes
+
+    std::atomic<LogLevel> m_minLevel{LogLevel::DEBUG};
+    std::atomic<OverflowPolicy> m_policy{OverflowPolicy::BLOCK};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_flushRequested{0}; // flush() calls so far
+    std::atomic<uint64_t> m_flushServed{0};    // flush() calls the worker has completed
+    std::atomic<uint64_t> m_writeCount{0};
+    std::atomic<bool> m_sleeping{false};    // Worker is (about to be) waiting on m_sleepCv
+    std::atomic<bool> m_exit{false};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCv;
+    uint32_t m_signal = 0;                  // Guarded by m_sleepMutex, bumped to wake the worker
+
+    mutable std::mutex m_optionsMutex;
+    LoggerOptions m_pendingOptions;         // Guarded by m_optionsMutex
+    std::atomic<uint64_t> m_optionsRequested{0};
+    std::atomic<uint64_t> m_optionsApplied{0};
     std::thread m_workerThread;
-    bool m_exit = false;
-    std::ofstream m_logFile;
+
+    // Worker only
+    std::vector<std::shared_ptr<LogStagingBuffer>> m_drainList; // Copy of m_buffers
+    uint64_t m_drainVersion = 0;
+    LoggerOptions m_options;
+    int m_fd = -1;
+    uint64_t m_fileBytes = 0;
+    std::chrono::steady_clock::time_point m_nextRotation;
+    std::chrono::steady_clock::time_point m_lastWrite;
+    LogFormatter m_formatter;
+    std::string m_line;   // Reused for every formatted line
+    std::string m_buffer; // Lines waiting for the next write()
 };
 
+// Log through the singleton if level survives both the compile-time and the
+// runtime threshold. Arguments are only evaluated when it does.
+//   LOG_INFO("order {} took {} ms", id, elapsed);
+#define LOGGER_LOG(level, ...)                                       \
+    do {                                                             \
+        if constexpr ((level) >= LOGGER_COMPILED_MIN_LEVEL) {        \
+            Logger& logger_instance_ = Logger::getInstance();        \
+            if (logger_instance_.isEnabled(level)) {                 \
+                logger_instance_.logFormat((level), __VA_ARGS__);    \
+            }                                                        \
+        }                                                            \
+    } while (0)
+
+#define LOG_DEBUG(...) LOGGER_LOG(LogLevel::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LOGGER_LOG(LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARN(...) LOGGER_LOG(LogLevel::WARN, __VA_ARGS__)
+#define LOG_ERROR(...) LOGGER_LOG(LogLevel::ERROR, __VA_ARGS__)
+
 #endif // LOGGER_H
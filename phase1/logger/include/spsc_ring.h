@@ -0,0 +1,87 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded single-producer single-consumer ring of preallocated slots.
+// The producer owns the head and the consumer owns the tail; each keeps a
+// cached copy of the other side's index and only reloads it when the ring
+// looks full (or empty). Publishing a value is one release store, with no
+// read-modify-write at all, so a thread writing to its own ring never
+// contends with anyone.
+template <typename T>
+class SpscRing {
+public:
+    // Capacity is rounded up to a power of two. Slots are default-initialized
+    // rather than value-initialized, so large trivially-constructible members
+    // (such as a record's inline buffer) are not zeroed up front.
+    explicit SpscRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_slots = std::make_unique_for_overwrite<T[]>(size);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    // Producer only: let fill(T&) write the next slot in place.
+    // Returns false without calling fill if the ring is full.
+    template <typename F>
+    bool tryEmplace(F&& fill) {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail > m_mask) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail > m_mask) {
+                return false;
+            }
+        }
+        fill(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only: pass the oldest value to consume(T&), then free its slot.
+    // Returns false if the ring is empty.
+    template <typename F>
+    bool tryConsume(F&& consume) {
+        const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_cachedHead) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail == m_cachedHead) {
+                return false;
+            }
+        }
+        consume(m_slots[tail & m_mask]);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only: true if nothing is waiting to be consumed
+    bool empty() const {
+        return m_tail.load(std::memory_order_relaxed) == m_head.load(std::memory_order_acquire);
+    }
+
+    // Values published by the producer / released by the consumer so far
+    uint64_t pushed() const { return m_head.load(std::memory_order_acquire); }
+    uint64_t popped() const { return m_tail.load(std::memory_order_acquire); }
+
+private:
+    std::unique_ptr<T[]> m_slots;
+    size_t m_mask = 0;
+    // Producer side
+    alignas(64) std::atomic<uint64_t> m_head{0};
+    uint64_t m_cachedTail = 0;
+    // Consumer side
+    alignas(64) std::atomic<uint64_t> m_tail{0};
+    uint64_t m_cachedHead = 0;
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,131 @@
+#include "log_record.h"
+#include <charconv>
+#include <ctime>
+#include <sstream>
+
+namespace {
+
+template <typename V>
+V load(const unsigned char*& in) {
+    V value;
+    std::memcpy(&value, in, sizeof(V));
+    in += sizeof(V);
+    return value;
+}
+
+template <typename V>
+void appendNumber(std::string& out, V value, int base = 10) {
+    char buffer[32];
+    std::to_chars_result result;
+    if constexpr (std::is_floating_point_v<V>) {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    } else {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), value, base);
+    }
+    out.append(buffer, result.ptr);
+}
+
+// Decode the argument at in, append it to out and advance in past it
+void appendArg(const unsigned char*& in, std::string& out) {
+    const auto type = static_cast<LogArgType>(*in++);
+    switch (type) {
+        case LogArgType::INT:
+            appendNumber(out, load<int64_t>(in));
+            break;
+        case LogArgType::UINT:
+            appendNumber(out, load<uint64_t>(in));
+            break;
+        case LogArgType::DOUBLE:
+            appendNumber(out, load<double>(in));
+            break;
+        case LogArgType::BOOL:
+            out += *in ? "true" : "false";
+            in += 8;
+            break;
+        case LogArgType::CHAR:
+            out += static_cast<char>(*in);
+            in += 8;
+            break;
+        case LogArgType::STRING: {
+            const auto length = load<uint32_t>(in);
+            out.append(reinterpret_cast<const char*>(in), length);
+            in += length;
+            break;
+        }
+        case LogArgType::POINTER:
+            out += "0x";
+            appendNumber(out, load<uintptr_t>(in), 16);
+            break;
+    }
+}
+
+} // anonymous namespace
+
+void formatLogArgs(const LogRecord& record, std::string& out) {
+    const unsigned char* in = record.args();
+    const unsigned char* end = in + record.size;
+    const char* format = record.format;
+
+    while (*format != '\0') {
+        // Copy the literal run up to the next brace in one append
+        const char* brace = format;
+        while (*brace != '\0' && *brace != '{' && *brace != '}') {
+            ++brace;
+        }
+        out.append(format, brace);
+        format = brace;
+        if (*format == '\0') {
+            break;
+        }
+        if (format[0] == '{' && format[1] == '}' && in < end) {
+            appendArg(in, out);
+            format += 2;
+        } else if ((format[0] == '{' && format[1] == '{') || (format[0] == '}' && format[1] == '}')) {
+            out += format[0];
+            format += 2;
+        } else {
+            out += *format++;
+        }
+    }
+}
+
+const char* levelToString(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO:  return "INFO";
+        case LogLevel::WARN:  return "WARN";
+        case LogLevel::ERROR: return "ERROR";
+        default:              return "UNKNOWN";
+    }
+}
+
+void LogFormatter::format(const LogRecord& record, std::string& out) {
+    using namespace std::chrono;
+    const system_clock::time_point time{system_clock::duration(record.timestamp)};
+    const int64_t second = duration_cast<seconds>(time.time_since_epoch()).count();
+    if (second != m_second) {
+        const std::time_t time_t = static_cast<std::time_t>(second);
+        std::tm tm;
+        localtime_r(&time_t, &tm);
+        m_timePrefixLength = std::strftime(m_timePrefix, sizeof(m_timePrefix), "%Y-%m-%d %H:%M:%S ", &tm);
+        m_second = second;
+    }
+
+    out.append(m_timePrefix, m_timePrefixLength);
+    out += '[';
+    out += levelToString(record.level);
+    out += "] [Thread ";
+    out += threadName(record.thread);
+    out += "] ";
+    formatLogArgs(record, out);
+}
+
+const std::string& LogFormatter::threadName(std::thread::id thread) {
+    auto it = m_threadNames.find(thread);
+    if (it == m_threadNames.end()) {
+        std::ostringstream name;
+        name << thread;
+        it = m_threadNames.emplace(thread, name.str()).first;
+    }
+    return it->second;
+}
@@ -1,23 +1,27 @@
 #include "logger.h"
-#include <iostream>
-#include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 Logger::Logger() {
-    m_logFile.open("app.log", std::ios::out | std::ios::app);
+    m_buffer.reserve(m_options.flushBytes + 4096);
+    openFile();
     m_workerThread = std::thread(&Logger::worker, this);
 }
 
 Logger::~Logger() {
+    m_exit.store(true, std::memory_order_release);
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_exit = true;
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        ++m_signal;
     }
-    m_cv.notify_one();
+    m_sleepCv.notify_one();
     m_workerThread.join();
-    if (m_logFile.is_open()) {
-        m_logFile.close();
+    if (m_fd > STDERR_FILENO) {
+        ::close(m_fd);
     }
 }
 
@@ -26,51 +30,310 @@ Logger& Logger::getInstance() {
     return instance;
 }
 
-std::string levelToString(LogLevel level) {
-    switch (level) {
-        case LogLevel::DEBUG: return "DEBUG";
-        case LogLevel::INFO:  return "INFO";
-        case LogLevel::WARN:  return "WARN";
-        case LogLevel::ERROR: return "ERROR";
-        default:              return "UNKNOWN";
+void Logger::log(LogLevel level, const std::string& message) {
+    logFormat(level, "{}", message);
+}
+
+void Logger::setMinLevel(LogLevel level) {
+    m_minLevel.store(level, std::memory_order_relaxed);
+}
+
+LogLevel Logger::minLevel() const {
+    return m_minLevel.load(std::memory_order_relaxed);
+}
+
+// Lives in thread-local storage next to s_staging. When the thread exits it
+// marks the buffer retired, so the worker frees it once it has been drained.
+struct Logger::StagingOwner {
+    std::shared_ptr<LogStagingBuffer> buffer;
+
+    ~StagingOwner() {
+        if (buffer) {
+            Logger::s_staging = nullptr;
+            buffer->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+LogStagingBuffer* Logger::registerThread() {
+    thread_local StagingOwner owner;
+    owner.buffer = std::make_shared<LogStagingBuffer>(LOGGER_RING_CAPACITY);
+    {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        m_buffers.push_back(owner.buffer);
+        m_buffersVersion.fetch_add(1, std::memory_order_release);
     }
+    s_staging = owner.buffer.get();
+    return s_staging;
 }
 
-void Logger::log(LogLevel level, const std::string& message) {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto tm = *std::localtime(&time_t);
+size_t Logger::drainStagingBuffers() {
+    if (m_buffersVersion.load(std::memory_order_acquire) != m_drainVersion) {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        m_drainList = m_buffers;
+        m_drainVersion = m_buffersVersion.load(std::memory_order_relaxed);
+    }
+
+    // Take at most one lap of each buffer per pass, so flush() callers are
+    // not held up by producers that keep refilling theirs
+    size_t count = 0;
+    bool anyRetired = false;
+    for (const auto& buffer : m_drainList) {
+        // Read before draining: once set, the owner has published its last record
+        const bool retired = buffer->retired.load(std::memory_order_acquire);
+        size_t drained = 0;
+        while (drained < buffer->ring.capacity() &&
+               buffer->ring.tryConsume([this](const LogRecord& record) { append(record); })) {
+            ++drained;
+        }
+        count += drained;
+        anyRetired = anyRetired || (retired && buffer->ring.empty());
+    }
+
+    if (anyRetired) {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        std::erase_if(m_buffers, [](const std::shared_ptr<LogStagingBuffer>& buffer) {
+            return buffer->retired.load(std::memory_order_acquire) && buffer->ring.empty();
+        });
+        m_drainList = m_buffers;
+        m_drainVersion = m_buffersVersion.fetch_add(1, std::memory_order_release) + 1;
+    }
+    return count;
+}
+
+bool Logger::stagingBuffersEmpty() const {
+    if (m_buffersVersion.load(std::memory_order_relaxed) != m_drainVersion) {
+        return false;
+    }
+    return std::all_of(m_drainList.begin(), m_drainList.end(),
+                       [](const std::shared_ptr<LogStagingBuffer>& buffer) { return buffer->ring.empty(); });
+}
+
+void Logger::setOverflowPolicy(OverflowPolicy policy) {
+    m_policy.store(policy, std::memory_order_relaxed);
+}
+
+OverflowPolicy Logger::overflowPolicy() const {
+    return m_policy.load(std::memory_order_relaxed);
+}
+
+uint64_t Logger::droppedCount() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+void Logger::flush() {
+    // The worker serves a request with a pass that starts after reading it.
+    // Every buffer holds at most one lap, so that pass writes out everything
+    // published before this call.
+    const uint64_t request = m_flushRequested.fetch_add(1) + 1;
+    wakeWorker();
+    uint64_t served = m_flushServed.load(std::memory_order_acquire);
+    while (served < request) {
+        m_flushServed.wait(served, std::memory_order_acquire);
+        served = m_flushServed.load(std::memory_order_acquire);
+    }
+}
+
+void Logger::configure(const LoggerOptions& options) {
+    flush();
+    uint64_t version;
+    {
+        std::lock_guard<std::mutex> lock(m_optionsMutex);
+        m_pendingOptions = options;
+        version = m_optionsRequested.fetch_add(1) + 1;
+    }
+    wakeWorker();
+    uint64_t applied = m_optionsApplied.load(std::memory_order_acquire);
+    while (applied < version) {
+        m_optionsApplied.wait(applied, std::memory_order_acquire);
+        applied = m_optionsApplied.load(std::memory_order_acquire);
+    }
+}
+
+LoggerOptions Logger::options() const {
+    std::lock_guard<std::mutex> lock(m_optionsMutex);
+    return m_pendingOptions;
+}
 
-    std::stringstream ss;
-    ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << " ";
-    ss << "[" << levelToString(level) << "] ";
-    ss << "[Thread " << std::this_thread::get_id() << "] ";
-    ss << message;
+uint64_t Logger::writeCount() const {
+    return m_writeCount.load(std::memory_order_relaxed);
+}
+
+void Logger::wakeWorker() {
+    // Pairs with the fence in sleep(): either the worker sees the message
+    // published before this call, or this call sees the worker going to sleep.
+    // Only the caller that clears m_sleeping pays for the notify.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_relaxed) && m_sleeping.exchange(false, std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            ++m_signal;
+        }
+        m_sleepCv.notify_one();
+    }
+}
+
+void Logger::openFile() {
+    m_fd = ::open(m_options.path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    m_fileBytes = 0;
+    if (m_fd < 0) {
+        m_fd = STDOUT_FILENO;
+    } else {
+        struct stat st;
+        if (::fstat(m_fd, &st) == 0) {
+            m_fileBytes = static_cast<uint64_t>(st.st_size);
+        }
+    }
+    m_nextRotation = std::chrono::steady_clock::now() + m_options.rotateInterval;
+}
+
+void Logger::rotate() {
+    if (m_fd <= STDERR_FILENO) {
+        return;
+    }
+    ::close(m_fd);
+    const std::string& path = m_options.path;
+    if (m_options.maxFiles <= 0) {
+        ::unlink(path.c_str());
+    } else {
+        for (int i = m_options.maxFiles - 1; i >= 1; --i) {
+            ::rename((path + "." + std::to_string(i)).c_str(), (path + "." + std::to_string(i + 1)).c_str());
+        }
+        ::rename(path.c_str(), (path + ".1").c_str());
+    }
+    openFile();
+}
 
+void Logger::applyOptions() {
+    const uint64_t version = m_optionsRequested.load(std::memory_order_acquire);
+    if (version == m_optionsApplied.load(std::memory_order_relaxed)) {
+        return;
+    }
+    writeOut();
+    LoggerOptions options;
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_queue.push(ss.str());
+        std::lock_guard<std::mutex> lock(m_optionsMutex);
+        options = m_pendingOptions;
     }
-    m_cv.notify_one();
+    const bool reopen = options.path != m_options.path;
+    m_options = options;
+    if (reopen) {
+        if (m_fd > STDERR_FILENO) {
+            ::close(m_fd);
+        }
+        openFile();
+    } else {
+        m_nextRotation = std::chrono::steady_clock::now() + m_options.rotateInterval;
+    }
+    m_buffer.reserve(m_options.flushBytes + 4096);
+    m_optionsApplied.store(version, std::memory_order_release);
+    m_optionsApplied.notify_all();
+}
+
+void Logger::append(const LogRecord& record) {
+    m_line.clear();
+    m_formatter.format(record, m_line);
+    m_line += '\n';
+    // Cut the file at a line boundary, so no rotated file exceeds rotateBytes
+    // unless a single line does
+    if (m_options.rotateBytes > 0 && m_fileBytes + m_buffer.size() > 0 &&
+        m_fileBytes + m_buffer.size() + m_line.size() > m_options.rotateBytes) {
+        writeOut();
+        rotate();
+    }
+    m_buffer += m_line;
+    if (m_buffer.size() >= m_options.flushBytes) {
+        writeOut();
+    }
+}
+
+void Logger::writeOut() {
+    if (m_buffer.empty()) {
+        return;
+    }
+    if (m_options.rotateInterval.count() > 0 && m_fileBytes > 0 &&
+        std::chrono::steady_clock::now() >= m_nextRotation) {
+        rotate();
+    }
+    const char* data = m_buffer.data();
+    size_t remaining = m_buffer.size();
+    while (remaining > 0) {
+        const ssize_t n = ::write(m_fd, data, remaining);
+        m_writeCount.fetch_add(1, std::memory_order_relaxed);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Nowhere to report a failing log file; drop the batch
+            std::perror("Logger write");
+            break;
+        }
+        data += n;
+        remaining -= static_cast<size_t>(n);
+        m_fileBytes += static_cast<uint64_t>(n);
+    }
+    m_buffer.clear();
+    m_lastWrite = std::chrono::steady_clock::now();
+}
+
+void Logger::sleep(bool pendingOutput, std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(m_sleepMutex);
+    const uint32_t signal = m_signal;
+    // Announce that we are going to sleep, then check for work once more
+    // before waiting, so anything published in between is not left behind
+    m_sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const bool idle = stagingBuffersEmpty() && !m_exit.load(std::memory_order_relaxed) &&
+                      m_flushRequested.load(std::memory_order_relaxed) ==
+                          m_flushServed.load(std::memory_order_relaxed) &&
+                      m_optionsRequested.load(std::memory_order_relaxed) ==
+                          m_optionsApplied.load(std::memory_order_relaxed);
+    if (idle) {
+        auto woken = [this, signal] { return m_signal != signal; };
+        if (pendingOutput) {
+            m_sleepCv.wait_until(lock, deadline, woken);
+        } else {
+            m_sleepCv.wait(lock, woken);
+        }
+    }
+    m_sleeping.store(false, std::memory_order_relaxed);
 }
 
 void Logger::worker() {
+    uint64_t reportedDrops = 0;
     while (true) {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_cv.wait(lock, [this] { return !m_queue.empty() || m_exit; });
+        applyOptions();
+        const uint64_t flushRequest = m_flushRequested.load(std::memory_order_acquire);
+        const size_t count = drainStagingBuffers();
 
-        if (m_exit && m_queue.empty()) {
-            break;
+        const uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDrops) {
+            if (m_policy.load(std::memory_order_relaxed) == OverflowPolicy::DROP_AND_REPORT) {
+                LogRecord report;
+                encodeLogRecord(report, LogLevel::WARN, "Logger dropped {} messages (ring full)",
+                                dropped - reportedDrops);
+                append(report);
+            }
+            reportedDrops = dropped;
         }
 
-        std::string message = m_queue.front();
-        m_queue.pop();
-        lock.unlock();
+        const bool exiting = m_exit.load(std::memory_order_acquire);
+        const auto now = std::chrono::steady_clock::now();
+        const bool flushing = flushRequest != m_flushServed.load(std::memory_order_relaxed);
+        if (now - m_lastWrite >= m_options.flushInterval || exiting || flushing) {
+            writeOut();
+        }
+        if (flushing) {
+            m_flushServed.store(flushRequest, std::memory_order_release);
+            m_flushServed.notify_all();
+        }
 
-        if (m_logFile.is_open()) {
-            m_logFile << message << std::endl;
-        } else {
-            std::cout << message << std::endl;
+        if (count > 0) {
+            continue;
+        }
+        if (exiting) {
+            break;
         }
+        sleep(!m_buffer.empty(), m_lastWrite + m_options.flushInterval);
     }
 }
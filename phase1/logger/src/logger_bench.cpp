@@ -0,0 +1,244 @@
+/*
+ * logger_bench: Multi-threaded throughput and caller latency of Logger::log.
+ *
+ * Several threads log a fixed number of short messages each, and every
+ * eighth call is timed. Reports, per variant:
+ *   - producer throughput: log() calls per second until all threads finish
+ *   - end-to-end throughput: until the last message has been written out
+ *   - caller latency percentiles of the sampled log() calls
+ * Variants:
+ *   - the previous design (std::queue behind a mutex and condition variable,
+ *     std::endl per message), rebuilt here as the baseline
+ *   - Logger with OverflowPolicy::BLOCK
+ *   - Logger with OverflowPolicy::DROP (also reports how many were dropped)
+ *   - Logger::logFormat with typed arguments, OverflowPolicy::BLOCK
+ *   - LOG_DEBUG below the runtime minimum level (the cost of a filtered call)
+ * The baseline formats every line on the calling thread; Logger only
+ * captures a timestamp and the arguments there and formats on its worker.
+ * All other variants produce the same lines. At the end the total number of
+ * write() calls Logger's worker issued is compared with the messages it
+ * wrote; the baseline flushes (one write()) per message. The baseline writes to
+ * logger_bench_baseline.log and Logger to app.log in the working directory.
+ *
+ * How to Compile without Docker (from project root):
+ *   1. cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+ *   2. cmake --build build --target logger_bench -- -j
+ *
+ * How to Run without Docker:
+ *   ./build/phase1/logger/logger_bench [threads] [messages_per_thread]
+ *
+ * Usage Examples:
+ *   - Default run (4 threads, 100,000 messages each):
+ *     ./build/phase1/logger/logger_bench
+ *
+ *   - Heavier contention:
+ *     ./build/phase1/logger/logger_bench 16 50000
+ */
+
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kSampleEvery = 8;
+
+std::string formatBaseline(LogLevel level, const std::string& message) {
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+    auto tm = *std::localtime(&time_t);
+
+    std::stringstream ss;
+    ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << " ";
+    ss << "[" << (level == LogLevel::INFO ? "INFO" : "OTHER") << "] ";
+    ss << "[Thread " << std::this_thread::get_id() << "] ";
+    ss << message;
+    return ss.str();
+}
+
+// The logger as it was before the lock-free handoff: one lock per message on both sides
+class MutexQueueLogger {
+public:
+    MutexQueueLogger() {
+        m_logFile.open("logger_bench_baseline.log", std::ios::out | std::ios::trunc);
+        m_workerThread = std::thread(&MutexQueueLogger::worker, this);
+    }
+
+    ~MutexQueueLogger() {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_exit = true;
+        }
+        m_cv.notify_one();
+        m_workerThread.join();
+    }
+
+    void log(LogLevel level, const std::string& message) {
+        std::string line = formatBaseline(level, message);
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queue.push(std::move(line));
+        }
+        m_cv.notify_one();
+    }
+
+private:
+    void worker() {
+        while (true) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return !m_queue.empty() || m_exit; });
+            if (m_exit && m_queue.empty()) {
+                break;
+            }
+            std::string message = m_queue.front();
+            m_queue.pop();
+            lock.unlock();
+            m_logFile << message << std::endl;
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::queue<std::string> m_queue;
+    std::thread m_workerThread;
+    bool m_exit = false;
+    std::ofstream m_logFile;
+};
+
+struct RunResult {
+    double produce_seconds = 0;
+    double total_seconds = 0;
+    std::vector<int64_t> latencies_ns;
+};
+
+// Run threads x messages calls of log(thread, message), then drain()
+RunResult run(int threads, int messages, const std::function<void(int, const std::string&)>& log,
+              const std::function<void()>& drain) {
+    RunResult result;
+    std::vector<std::vector<int64_t>> samples(threads);
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::vector<int64_t>& mine = samples[t];
+            mine.reserve(messages / kSampleEvery + 1);
+            const std::string message = "order " + std::to_string(t) + " processed in 42 ms";
+            for (int i = 0; i < messages; ++i) {
+                if (i % kSampleEvery == 0) {
+                    auto before = std::chrono::steady_clock::now();
+                    log(t, message);
+                    auto after = std::chrono::steady_clock::now();
+                    mine.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+                } else {
+                    log(t, message);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    auto produced = std::chrono::steady_clock::now();
+    drain();
+    auto end = std::chrono::steady_clock::now();
+
+    result.produce_seconds = std::chrono::duration<double>(produced - start).count();
+    result.total_seconds = std::chrono::duration<double>(end - start).count();
+    for (const auto& mine : samples) {
+        result.latencies_ns.insert(result.latencies_ns.end(), mine.begin(), mine.end());
+    }
+    std::sort(result.latencies_ns.begin(), result.latencies_ns.end());
+    return result;
+}
+
+int64_t percentile(const std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+void report(const std::string& name, const RunResult& result, uint64_t calls) {
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(9) << calls / result.produce_seconds / 1e6 << " M/s"
+              << std::setw(9) << calls / result.total_seconds / 1e6 << " M/s"
+              << std::setw(9) << percentile(result.latencies_ns, 0.50)
+              << std::setw(9) << percentile(result.latencies_ns, 0.99)
+              << std::setw(10) << percentile(result.latencies_ns, 0.999)
+              << std::setw(11) << result.latencies_ns.back() << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    int threads = 4;
+    int messages = 100000;
+    if (argc > 1) {
+        threads = std::stoi(argv[1]);
+    }
+    if (argc > 2) {
+        messages = std::stoi(argv[2]);
+    }
+    const uint64_t calls = static_cast<uint64_t>(threads) * messages;
+    std::cout << threads << " threads x " << messages << " messages, " << LOGGER_RING_CAPACITY
+              << " staging slots per thread" << std::endl;
+    std::cout << std::left << std::setw(24) << "variant" << std::right << std::setw(13) << "produce"
+              << std::setw(13) << "end-to-end" << std::setw(9) << "p50 ns" << std::setw(9) << "p99 ns"
+              << std::setw(10) << "p99.9 ns" << std::setw(11) << "max ns" << std::endl;
+
+    {
+        auto baseline = std::make_unique<MutexQueueLogger>();
+        MutexQueueLogger* raw = baseline.get();
+        RunResult result = run(
+            threads, messages, [raw](int, const std::string& message) { raw->log(LogLevel::INFO, message); },
+            [&baseline] { baseline.reset(); });
+        report("mutex + std::queue", result, calls);
+    }
+
+    Logger& logger = Logger::getInstance();
+    const uint64_t writes_before = logger.writeCount();
+    auto log = [&logger](int, const std::string& message) { logger.log(LogLevel::INFO, message); };
+    auto drain = [&logger] { logger.flush(); };
+
+    logger.setOverflowPolicy(OverflowPolicy::BLOCK);
+    report("log(), BLOCK", run(threads, messages, log, drain), calls);
+
+    logger.setOverflowPolicy(OverflowPolicy::DROP);
+    const uint64_t dropped_before = logger.droppedCount();
+    RunResult dropping = run(threads, messages, log, drain);
+    report("log(), DROP", dropping, calls);
+    std::cout << "DROP discarded " << logger.droppedCount() - dropped_before << " of " << calls << " messages"
+              << std::endl;
+    logger.setOverflowPolicy(OverflowPolicy::BLOCK);
+
+    auto logTyped = [&logger](int thread, const std::string&) {
+        logger.logFormat(LogLevel::INFO, "order {} processed in {} ms", thread, 42);
+    };
+    report("logFormat(), BLOCK", run(threads, messages, logTyped, drain), calls);
+
+    logger.setMinLevel(LogLevel::INFO);
+    auto logFiltered = [](int thread, const std::string&) { LOG_DEBUG("order {} processed in {} ms", thread, 42); };
+    report("LOG_DEBUG, filtered", run(threads, messages, logFiltered, drain), calls);
+    logger.setMinLevel(LogLevel::DEBUG);
+
+    const uint64_t written = 3 * calls - (logger.droppedCount() - dropped_before);
+    std::cout << "Logger wrote " << written << " messages with " << logger.writeCount() - writes_before
+              << " write() calls" << std::endl;
+    return 0;
+}
@@ -0,0 +1,133 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace memory_pool {
+
+/**
+ * @brief A monotonic bump-pointer arena.
+ *
+ * Allocate() moves a pointer forward through the current chunk, so an
+ * allocation is an align, a compare and an add. Individual blocks are never
+ * freed. The whole arena is reset at once, or rewound to a Marker taken
+ * earlier, which frees everything allocated since the marker. Both are
+ * O(1): they move the pointer back and keep the chunks for reuse.
+ *
+ * When the current chunk is full, the arena moves to the next chunk in its
+ * chain. That chunk is either one kept from before a reset or a new chunk
+ * from std::malloc. New chunks double in size, starting at the initial
+ * chunk size and up to kMaxChunkSize, and are always big enough for the
+ * request. Only Release() and the destructor return chunks to the system.
+ *
+ * Suited to request-scoped work: allocate freely while handling a request,
+ * then Reset() when done. Not thread-safe.
+ */
+class Arena {
+public:
+    /// Default size of the first chunk
+    static constexpr size_t kDefaultChunkSize = 64 * 1024;
+    /// Chunks stop doubling at this size (larger requests still get their own chunk)
+    static constexpr size_t kMaxChunkSize = 4 * 1024 * 1024;
+
+    /**
+     * @brief A position in the arena to rewind to.
+     */
+    struct Marker {
+        void* chunk = nullptr;     ///< Chunk the position is in (nullptr: the very start)
+        char* position = nullptr;  ///< Next free byte in that chunk
+    };
+
+    /**
+     * @brief Constructs an Arena. No memory is allocated until the first Allocate().
+     *
+     * @param initial_chunk_size Usable bytes in the first chunk.
+     */
+    explicit Arena(size_t initial_chunk_size = kDefaultChunkSize);
+
+    /**
+     * @brief Destructor. Frees every chunk.
+     */
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Allocates a block of memory.
+     *
+     * @param size The size of the block in bytes.
+     * @param alignment Alignment of the block; a power of two.
+     * @return Pointer to the block, or nullptr if size is 0 or a new chunk
+     * could not be allocated.
+     */
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        // Fast path: room left in the current chunk
+        const uintptr_t end = reinterpret_cast<uintptr_t>(end_);
+        const uintptr_t aligned = (reinterpret_cast<uintptr_t>(position_) + alignment - 1) & ~(alignment - 1);
+        if (size != 0 && aligned <= end && size <= end - aligned) {
+            position_ = reinterpret_cast<char*>(aligned + size);
+            return reinterpret_cast<void*>(aligned);
+        }
+        return AllocateSlow(size, alignment);
+    }
+
+    /**
+     * @brief Gets the current position, to rewind to later.
+     *
+     * @return A marker for the current position.
+     */
+    Marker GetMarker() const { return Marker{current_, position_}; }
+
+    /**
+     * @brief Frees everything allocated since the marker was taken.
+     *
+     * Markers taken after this one become invalid.
+     *
+     * @param marker A marker from GetMarker() on this arena.
+     */
+    void Rewind(const Marker& marker);
+
+    /**
+     * @brief Frees everything, keeping the chunks for reuse.
+     */
+    void Reset() { Rewind(Marker{}); }
+
+    /**
+     * @brief Frees everything and returns every chunk to the system.
+     */
+    void Release();
+
+    /**
+     * @brief Gets the number of chunks in the chain.
+     *
+     * @return The number of chunks.
+     */
+    size_t GetNumChunks() const { return num_chunks_; }
+
+    /**
+     * @brief Gets the usable bytes of all chunks in the chain.
+     *
+     * @return The capacity in bytes.
+     */
+    size_t GetCapacity() const { return capacity_; }
+
+private:
+    struct Chunk;
+
+    void* AllocateSlow(size_t size, size_t alignment);
+    void Enter(Chunk* chunk);
+
+    size_t next_chunk_size_;     ///< Usable bytes of the next new chunk
+    Chunk* first_ = nullptr;     ///< Start of the chunk chain
+    Chunk* current_ = nullptr;   ///< Chunk being allocated from
+    char* position_ = nullptr;   ///< Next free byte in the current chunk
+    char* end_ = nullptr;        ///< End of the current chunk
+    size_t num_chunks_ = 0;
+    size_t capacity_ = 0;
+};
+
+} // namespace memory_pool
+
+#endif // ARENA_H
@@ -0,0 +1,107 @@
+#ifndef CONCURRENT_BLOCK_ALLOCATOR_H
+#define CONCURRENT_BLOCK_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace memory_pool {
+
+/**
+ * @brief A thread-safe fixed-size block allocator with per-thread caches.
+ *
+ * Blocks come from one pre-allocated region, like FixedBlockAllocator, but
+ * every thread allocates from and frees into its own magazines: small
+ * stacks of kMagazineSize free blocks. A thread only takes the depot lock
+ * to swap a whole magazine, i.e. at most once every kMagazineSize
+ * operations; everything in between touches thread-local data only and
+ * uses no locks or atomics (Bonwick's magazine layer).
+ *
+ * Each thread keeps two magazines per allocator, so a thread alternating
+ * between allocating and freeing around a magazine boundary does not go
+ * to the depot every time. Blocks cached by one thread are not visible to
+ * others until its magazines go back to the depot, which happens when the
+ * thread exits; Allocate() can therefore return nullptr while a few
+ * magazines' worth of blocks sit in other threads' caches.
+ *
+ * Blocks may be freed by a different thread than the one that allocated
+ * them. The allocator may be destroyed while threads that used it are
+ * still running; their cached magazines are discarded the next time such a
+ * thread starts using an allocator it has not used before, or when it exits.
+ */
+class ConcurrentBlockAllocator {
+public:
+    /// Number of blocks a magazine holds
+    static constexpr size_t kMagazineSize = 64;
+
+    /**
+     * @brief Constructs a ConcurrentBlockAllocator.
+     *
+     * @param block_size The size of each block in bytes.
+     * @param num_blocks The number of blocks to allocate.
+     */
+    ConcurrentBlockAllocator(size_t block_size, size_t num_blocks);
+
+    /**
+     * @brief Destructor. Frees the memory region; blocks still cached by
+     * other threads are dropped with it.
+     */
+    ~ConcurrentBlockAllocator();
+
+    ConcurrentBlockAllocator(const ConcurrentBlockAllocator&) = delete;
+    ConcurrentBlockAllocator& operator=(const ConcurrentBlockAllocator&) = delete;
+
+    /**
+     * @brief Allocates a block from the calling thread's magazines.
+     *
+     * @return Pointer to the allocated block, or nullptr if neither the
+     * thread's magazines nor the depot have a free block.
+     */
+    void* Allocate();
+
+    /**
+     * @brief Returns a block to the calling thread's magazines.
+     *
+     * @param ptr Pointer to a block from this allocator, or nullptr.
+     */
+    void Deallocate(void* ptr);
+
+    /**
+     * @brief Gets the size of each block.
+     *
+     * @return The block size in bytes.
+     */
+    size_t GetBlockSize() const { return block_size_; }
+
+    /**
+     * @brief Gets the total number of blocks.
+     *
+     * @return The total number of blocks.
+     */
+    size_t GetNumBlocks() const { return num_blocks_; }
+
+    /**
+     * @brief Gets the number of free blocks held by the depot, including
+     * blocks never handed out yet. Blocks in thread caches are not counted.
+     *
+     * @return The number of free blocks in the depot.
+     */
+    size_t GetNumDepotBlocks() const;
+
+    struct Magazine;
+    struct Depot;
+    struct ThreadCache;
+
+private:
+    ThreadCache& GetThreadCache();
+
+    size_t block_size_;              ///< Size of each block
+    size_t num_blocks_;              ///< Total number of blocks
+    uint64_t id_;                    ///< Unique id, matches this allocator's thread caches
+    void* memory_pool_;              ///< Pointer to the allocated memory region
+    std::shared_ptr<Depot> depot_;   ///< Shared with every thread cache of this allocator
+};
+
+} // namespace memory_pool
+
+#endif // CONCURRENT_BLOCK_ALLOCATOR_H
@@ -2,16 +2,34 @@
 #define FIXED_BLOCK_ALLOCATOR_H
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace memory_pool {
 
+/// Whether FixedBlockAllocator tracks allocated blocks to catch double frees
+/// unless told otherwise: on in debug builds, off when NDEBUG is defined
+#ifdef NDEBUG
+constexpr bool kCheckDoubleFreeDefault = false;
+#else
+constexpr bool kCheckDoubleFreeDefault = true;
+#endif
+
 /**
  * @brief A fixed-size block allocator.
  * 
  * This allocator pre-allocates a large chunk of memory and divides it into
- * fixed-size blocks. It maintains a free list of available blocks for
- * efficient allocation and deallocation.
+ * fixed-size blocks. Free blocks form an intrusive singly linked list: each
+ * free block stores the pointer to the next one in its first bytes, so the
+ * allocator needs no memory besides the pool itself and both Allocate() and
+ * Deallocate() are O(1). Blocks that were never handed out are not on the
+ * list; they are taken from the end of the used part of the pool on demand,
+ * so construction does not touch the pool at all.
+ *
+ * With double-free checking enabled, a bitmap with one bit per block records
+ * which blocks are allocated, and freeing a block that is already free is
+ * ignored. Without it, freeing a block twice corrupts the free list, as it
+ * would with malloc.
  */
 class FixedBlockAllocator {
 public:
@@ -20,14 +38,19 @@ public:
      * 
      * @param block_size The size of each block in bytes.
      * @param num_blocks The number of blocks to allocate.
+     * @param check_double_free Track allocated blocks in a bitmap to detect double frees.
      */
-    FixedBlockAllocator(size_t block_size, size_t num_blocks);
+    FixedBlockAllocator(size_t block_size, size_t num_blocks,
+                        bool check_double_free = kCheckDoubleFreeDefault);
 
     /**
      * @brief Destructor. Frees the allocated memory pool.
      */
     ~FixedBlockAllocator();
 
+    FixedBlockAllocator(const FixedBlockAllocator&) = delete;
+    FixedBlockAllocator& operator=(const FixedBlockAllocator&) = delete;
+
     /**
      * @brief Allocates a block of memory.
      * 
@@ -38,10 +61,24 @@ public:
     /**
      * @brief Deallocates a block of memory.
      * 
+     * Null pointers, pointers outside the pool or not at a block boundary,
+     * and (with double-free checking) blocks that are already free are ignored.
+     *
      * @param ptr Pointer to the block to deallocate.
      */
     void Deallocate(void* ptr);
 
+    /**
+     * @brief Whether a pointer lies inside this allocator's pool.
+     *
+     * @param ptr The pointer to check.
+     * @return True if ptr is within the pool's blocks.
+     */
+    bool Owns(const void* ptr) const {
+        const char* pool_start = static_cast<const char*>(memory_pool_);
+        return ptr >= pool_start && static_cast<const char*>(ptr) < pool_start + stride_ * num_blocks_;
+    }
+
     /**
      * @brief Gets the size of each block.
      * 
@@ -49,6 +86,13 @@ public:
      */
     size_t GetBlockSize() const { return block_size_; }
 
+    /**
+     * @brief Gets the alignment every block is guaranteed to have.
+     *
+     * @return The block alignment in bytes (a power of two).
+     */
+    size_t GetBlockAlignment() const { return block_alignment_; }
+
     /**
      * @brief Gets the total number of blocks.
      * 
@@ -70,12 +114,23 @@ public:
      */
     size_t GetNumUsedBlocks() const { return num_blocks_ - num_free_blocks_; }
 
+    /**
+     * @brief Whether double frees are detected.
+     *
+     * @return True if the allocated-block bitmap is maintained.
+     */
+    bool ChecksDoubleFree() const { return used_bits_ != nullptr; }
+
 private:
     size_t block_size_;          ///< Size of each block
+    size_t stride_;              ///< Distance between blocks (room for an aligned free-list link)
+    size_t block_alignment_;     ///< Alignment of the pool, and so of every block
     size_t num_blocks_;          ///< Total number of blocks
     size_t num_free_blocks_;     ///< Number of free blocks
     void* memory_pool_;          ///< Pointer to the allocated memory pool
-    void** free_list_;           ///< Free list of available blocks
+    void* free_list_;            ///< First free block; each links to the next
+    char* next_unused_;          ///< First block never handed out
+    std::unique_ptr<uint64_t[]> used_bits_; ///< One bit per allocated block, if checking
 };
 
 } // namespace memory_pool
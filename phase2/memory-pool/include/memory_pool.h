@@ -1,25 +1,48 @@
 #ifndef MEMORY_POOL_H
 #define MEMORY_POOL_H
 
+#include <array>
 #include <cstddef>
-#include <memory>
+#include <cstdint>
 #include <vector>
-#include <map>
 
 namespace memory_pool {
 
 /**
  * @brief A general-purpose memory pool allocator.
- * 
- * This allocator manages a pool of memory and can allocate blocks of
- * different sizes. It uses a simple segregated fits approach where
- * it has multiple fixed-block allocators for different size classes.
+ *
+ * This allocator manages one region of initial_pool_size bytes and can
+ * allocate blocks of different sizes from it, in two tiers:
+ *
+ * - Small requests (up to kMaxSmallSize bytes) are rounded up to one of a
+ *   few size classes, four per doubling as in jemalloc (16, 32, ..., 128,
+ *   160, 192, 224, 256, 320, ...). Each class hands out blocks from slabs
+ *   of kSlabSize bytes that work like FixedBlockAllocator: an intrusive
+ *   free list plus a bump pointer, no per-block header. A slab that
+ *   becomes empty goes back to the large tier. If no slab can be had, a
+ *   small request is served by the large tier instead.
+ *
+ * - Large requests are carved from the region with boundary tags: every
+ *   block has a 16-byte header holding its size and whether it and its
+ *   predecessor are in use, and free blocks repeat their size in a footer.
+ *   Freeing a block merges it with free neighbours in O(1) by reading the
+ *   next block's header and the previous block's footer. Free blocks sit in
+ *   segregated lists, one per power of two, with a bitmap of non-empty
+ *   lists, so finding a fit is a bit scan plus a short first-fit walk.
+ *
+ * All blocks are 16-byte aligned. Used and free sizes count requested
+ * bytes; headers, footers and rounding are not included.
  */
 class MemoryPool {
 public:
+    /// Largest request served from a size class
+    static constexpr size_t kMaxSmallSize = 512;
+    /// Bytes per size-class slab
+    static constexpr size_t kSlabSize = 8192;
+
     /**
      * @brief Constructs a MemoryPool.
-     * 
+     *
      * @param initial_pool_size The initial size of the memory pool in bytes.
      */
     explicit MemoryPool(size_t initial_pool_size);
@@ -29,9 +52,12 @@ public:
      */
     ~MemoryPool();
 
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
     /**
      * @brief Allocates a block of memory.
-     * 
+     *
      * @param size The size of the block to allocate.
      * @return Pointer to the allocated block, or nullptr if allocation fails.
      */
@@ -39,45 +65,94 @@ public:
 
     /**
      * @brief Deallocates a block of memory.
-     * 
+     *
      * @param ptr Pointer to the block to deallocate.
      * @param size The size of the block to deallocate.
      */
     void Deallocate(void* ptr, size_t size);
 
+    /**
+     * @brief Whether a pointer lies inside this pool's region.
+     *
+     * @param ptr The pointer to check.
+     * @return True if ptr could have been returned by Allocate().
+     */
+    bool Owns(const void* ptr) const {
+        return ptr >= memory_pool_ && static_cast<const char*>(ptr) < region_end_;
+    }
+
     /**
      * @brief Gets the total size of the memory pool.
-     * 
+     *
      * @return The total size in bytes.
      */
     size_t GetTotalSize() const { return total_size_; }
 
     /**
      * @brief Gets the used size of the memory pool.
-     * 
+     *
      * @return The used size in bytes.
      */
     size_t GetUsedSize() const { return used_size_; }
 
     /**
      * @brief Gets the free size of the memory pool.
-     * 
+     *
      * @return The free size in bytes.
      */
     size_t GetFreeSize() const { return total_size_ - used_size_; }
 
+    /**
+     * @brief Gets the largest request the large tier could serve right now.
+     *
+     * Comparing it with GetFreeSize() shows how fragmented the pool is.
+     *
+     * @return The payload size of the largest free block in bytes.
+     */
+    size_t GetLargestFreeBlock() const;
+
+    /**
+     * @brief Gets the number of size-class slabs currently carved from the pool.
+     *
+     * @return The number of live slabs.
+     */
+    size_t GetNumSlabs() const { return num_slabs_; }
+
 private:
+    struct Slab;
+    struct FreeBlock;
+
+    /// Number of small size classes
+    static constexpr size_t kNumSizeClasses = 16;
+    /// Number of segregated free lists for the large tier
+    static constexpr size_t kNumBins = 64;
+
+    // Large tier (boundary tags)
+    void* AllocateLarge(size_t size);
+    void DeallocateLarge(void* ptr);
+    void InsertFree(char* block, size_t block_size);
+    void RemoveFree(char* block, size_t block_size);
+
+    // Small tier (size-class slabs)
+    void* AllocateSmall(size_t size_class);
+    void DeallocateSmall(Slab* slab, void* ptr);
+    void ReleaseSlab(Slab* slab);
+    Slab* FindSlab(const void* ptr) const;
+    void MapSlab(Slab* slab, bool add);
+    bool ReleaseEmptySlabs();
+
     size_t total_size_;          ///< Total size of the memory pool
     size_t used_size_;           ///< Used size of the memory pool
     void* memory_pool_;          ///< Pointer to the allocated memory pool
-    std::map<size_t, void*> free_blocks_; ///< Map of free blocks by size
+    char* region_end_;           ///< End of the managed region (the sentinel header)
 
-    /**
-     * @brief Coalesces adjacent free blocks.
-     * 
-     * This function merges adjacent free blocks to reduce fragmentation.
-     */
-    void CoalesceBlocks();
+    std::array<FreeBlock*, kNumBins> bins_{};  ///< Free blocks by floor(log2(size))
+    uint64_t bin_bitmap_ = 0;                  ///< Bit i set if bins_[i] is non-empty
+
+    std::array<Slab*, kNumSizeClasses> partial_slabs_{};  ///< Slabs with a free block, per class
+    /// Slabs overlapping each kSlabSize-sized granule of the region (at most two)
+    std::vector<std::array<Slab*, 2>> slab_map_;
+    size_t num_slabs_ = 0;
 };
 
 } // namespace memory_pool
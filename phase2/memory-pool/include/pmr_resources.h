@@ -0,0 +1,121 @@
+#ifndef PMR_RESOURCES_H
+#define PMR_RESOURCES_H
+
+#include "arena.h"
+#include "fixed_block_allocator.h"
+#include "memory_pool.h"
+#include <cstddef>
+#include <memory_resource>
+
+namespace memory_pool {
+
+/**
+ * @brief std::pmr::memory_resource backed by an Arena.
+ *
+ * Deallocation does nothing. Memory comes back when the arena is reset or
+ * rewound, so containers using this resource must be destroyed (or simply
+ * abandoned, if their elements need no destructor) before that happens.
+ *
+ * Example:
+ *   Arena arena;
+ *   ArenaResource resource(arena);
+ *   std::pmr::vector<int> values(&resource);
+ */
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Constructs an ArenaResource.
+     *
+     * @param arena The arena to allocate from; must outlive the resource.
+     */
+    explicit ArenaResource(Arena& arena) : arena_(arena) {}
+
+    /**
+     * @brief Gets the underlying arena.
+     *
+     * @return The arena.
+     */
+    Arena& GetArena() const { return arena_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    Arena& arena_;
+};
+
+/**
+ * @brief std::pmr::memory_resource backed by a MemoryPool.
+ *
+ * Requests the pool cannot serve (alignment above 16 bytes, or the pool is
+ * full) go to the upstream resource; deallocation routes each block back
+ * to whichever side it came from.
+ */
+class MemoryPoolResource : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Constructs a MemoryPoolResource.
+     *
+     * @param pool The pool to allocate from; must outlive the resource.
+     * @param upstream Fallback resource for requests the pool cannot serve.
+     */
+    explicit MemoryPoolResource(MemoryPool& pool,
+                                std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : pool_(pool), upstream_(upstream) {}
+
+    /**
+     * @brief Gets the underlying pool.
+     *
+     * @return The pool.
+     */
+    MemoryPool& GetPool() const { return pool_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    MemoryPool& pool_;
+    std::pmr::memory_resource* upstream_;
+};
+
+/**
+ * @brief std::pmr::memory_resource backed by a FixedBlockAllocator.
+ *
+ * Meant for node-based containers (std::pmr::list, std::pmr::map, ...)
+ * whose nodes fit in one block. Larger or more strictly aligned requests,
+ * and requests made while the allocator is exhausted, go to the upstream
+ * resource.
+ */
+class FixedBlockResource : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Constructs a FixedBlockResource.
+     *
+     * @param allocator The allocator to allocate from; must outlive the resource.
+     * @param upstream Fallback resource for requests the allocator cannot serve.
+     */
+    explicit FixedBlockResource(FixedBlockAllocator& allocator,
+                                std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : allocator_(allocator), upstream_(upstream) {}
+
+    /**
+     * @brief Gets the underlying allocator.
+     *
+     * @return The allocator.
+     */
+    FixedBlockAllocator& GetAllocator() const { return allocator_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    FixedBlockAllocator& allocator_;
+    std::pmr::memory_resource* upstream_;
+};
+
+} // namespace memory_pool
+
+#endif // PMR_RESOURCES_H
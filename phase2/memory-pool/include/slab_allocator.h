@@ -0,0 +1,154 @@
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace memory_pool {
+
+/**
+ * @brief Counters describing a SlabAllocator's memory use.
+ */
+struct SlabStats {
+    size_t chunk_count = 0;        ///< Slabs currently mapped
+    size_t empty_chunks = 0;       ///< Mapped slabs with no block in use
+    size_t bytes_mapped = 0;       ///< chunk_count * slab size
+    size_t blocks_in_use = 0;      ///< Blocks currently allocated
+    size_t block_capacity = 0;     ///< Blocks the mapped slabs can hold
+    size_t high_water_blocks = 0;  ///< Most blocks ever in use at once
+    size_t high_water_chunks = 0;  ///< Most slabs ever mapped at once
+    /// Share of the mapped bytes not holding a live block's payload:
+    /// 1 - blocks_in_use * block_size / bytes_mapped (0 when nothing is mapped)
+    double fragmentation = 0.0;
+};
+
+/**
+ * @brief A growable fixed-size block allocator built from mmap'd slabs.
+ *
+ * Unlike FixedBlockAllocator, which hands out blocks from one region and
+ * fails once it is exhausted, a SlabAllocator maps another slab (a chunk of
+ * slab_size bytes, aligned to its own size) whenever all existing ones are
+ * full. Each slab starts with a small header followed by its blocks, and
+ * keeps its own intrusive free list, so the slab owning a block is found by
+ * masking the block's address: Allocate() and Deallocate() are O(1).
+ *
+ * Allocation prefers partially used slabs, then cached empty ones, so
+ * live blocks pack into as few slabs as possible. A slab whose last block
+ * is freed is kept as a cached empty slab; only when more than
+ * max_empty_slabs are cached is one returned to the OS with munmap. That
+ * hysteresis keeps a workload oscillating around a slab boundary from
+ * mapping and unmapping on every call.
+ *
+ * Any block size is supported: blocks are spaced at the block size rounded
+ * up to the requested alignment (itself a power of two).
+ *
+ * Not thread-safe; see ConcurrentBlockAllocator for sharing between threads.
+ */
+class SlabAllocator {
+public:
+    /// Default bytes per slab
+    static constexpr size_t kDefaultSlabSize = 64 * 1024;
+
+    /**
+     * @brief Constructs a SlabAllocator. No memory is mapped until the first Allocate().
+     *
+     * @param block_size The size of each block in bytes.
+     * @param alignment Alignment of every block; a power of two.
+     * @param slab_size Bytes per slab; rounded up to a power of two of at
+     *        least one page, and enlarged so a slab holds at least 8 blocks.
+     * @param max_empty_slabs Empty slabs kept mapped before returning one to the OS.
+     */
+    explicit SlabAllocator(size_t block_size, size_t alignment = alignof(std::max_align_t),
+                           size_t slab_size = kDefaultSlabSize, size_t max_empty_slabs = 2);
+
+    /**
+     * @brief Destructor. Unmaps every slab, including ones with live blocks.
+     */
+    ~SlabAllocator();
+
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+    /**
+     * @brief Allocates a block, mapping a new slab if every slab is full.
+     *
+     * @return Pointer to the allocated block, or nullptr if mmap fails.
+     */
+    void* Allocate();
+
+    /**
+     * @brief Deallocates a block.
+     *
+     * @param ptr Pointer returned by Allocate() on this allocator, or nullptr.
+     */
+    void Deallocate(void* ptr);
+
+    /**
+     * @brief Returns every cached empty slab to the OS.
+     */
+    void ReleaseEmptySlabs();
+
+    /**
+     * @brief Gets the size of each block.
+     *
+     * @return The block size in bytes, as requested.
+     */
+    size_t GetBlockSize() const { return block_size_; }
+
+    /**
+     * @brief Gets the distance between consecutive blocks in a slab.
+     *
+     * @return The block size rounded up to the alignment.
+     */
+    size_t GetStride() const { return stride_; }
+
+    /**
+     * @brief Gets the size of each slab.
+     *
+     * @return The slab size in bytes.
+     */
+    size_t GetSlabSize() const { return slab_size_; }
+
+    /**
+     * @brief Gets the number of blocks each slab holds.
+     *
+     * @return The blocks per slab.
+     */
+    size_t GetBlocksPerSlab() const { return blocks_per_slab_; }
+
+    /**
+     * @brief Gets the current memory use statistics.
+     *
+     * @return A snapshot of the counters.
+     */
+    SlabStats GetStats() const;
+
+private:
+    struct Slab;
+
+    Slab* MapSlab();
+    void UnmapSlab(Slab* slab);
+    static void PushFront(Slab*& head, Slab* slab);
+    static void Unlink(Slab*& head, Slab* slab);
+
+    size_t block_size_;           ///< Requested block size
+    size_t stride_;               ///< Distance between blocks
+    size_t slab_size_;            ///< Bytes per slab (power of two)
+    size_t first_block_offset_;   ///< Offset of the first block from the slab start
+    size_t blocks_per_slab_;      ///< Blocks per slab
+    size_t max_empty_slabs_;      ///< Empty slabs kept before unmapping
+
+    Slab* partial_ = nullptr;     ///< Slabs with both free and used blocks
+    Slab* empty_ = nullptr;       ///< Mapped slabs with no used blocks
+    Slab* full_ = nullptr;        ///< Slabs with no free blocks
+
+    size_t chunk_count_ = 0;
+    size_t empty_count_ = 0;
+    size_t blocks_in_use_ = 0;
+    size_t high_water_blocks_ = 0;
+    size_t high_water_chunks_ = 0;
+};
+
+} // namespace memory_pool
+
+#endif // SLAB_ALLOCATOR_H
@@ -0,0 +1,87 @@
+#include "arena.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace memory_pool {
+
+/// Header at the start of every chunk; the usable bytes follow it
+struct Arena::Chunk {
+    Chunk* next;   ///< Next chunk in the chain
+    size_t size;   ///< Usable bytes after the header
+
+    char* Begin() { return reinterpret_cast<char*>(this) + sizeof(Chunk); }
+    char* End() { return Begin() + size; }
+};
+
+Arena::Arena(size_t initial_chunk_size)
+    : next_chunk_size_(std::max<size_t>(initial_chunk_size, 64)) {}
+
+Arena::~Arena() {
+    Release();
+}
+
+void Arena::Enter(Chunk* chunk) {
+    current_ = chunk;
+    position_ = chunk ? chunk->Begin() : nullptr;
+    end_ = chunk ? chunk->End() : nullptr;
+}
+
+void* Arena::AllocateSlow(size_t size, size_t alignment) {
+    if (size == 0 || (alignment & (alignment - 1)) != 0) {
+        return nullptr;
+    }
+    // Enough for the block wherever the chunk's data happens to start
+    const size_t needed = size + alignment - 1;
+    if (needed < size) {
+        return nullptr;
+    }
+
+    // Reuse the next chunk kept from before a reset if the block fits;
+    // otherwise put a new chunk in front of it, so the chain stays in
+    // allocation order and rewinding never has to search
+    Chunk* next = current_ ? current_->next : first_;
+    if (!next || next->size < needed) {
+        const size_t chunk_size = std::max(next_chunk_size_, needed);
+        Chunk* chunk = static_cast<Chunk*>(std::malloc(sizeof(Chunk) + chunk_size));
+        if (!chunk) {
+            return nullptr;
+        }
+        chunk->size = chunk_size;
+        chunk->next = next;
+        if (current_) {
+            current_->next = chunk;
+        } else {
+            first_ = chunk;
+        }
+        next = chunk;
+        ++num_chunks_;
+        capacity_ += chunk_size;
+        next_chunk_size_ = std::min(next_chunk_size_ * 2, std::max(kMaxChunkSize, next_chunk_size_));
+    }
+
+    Enter(next);
+    return Allocate(size, alignment);
+}
+
+void Arena::Rewind(const Marker& marker) {
+    if (!marker.chunk) {
+        Enter(first_);
+        return;
+    }
+    current_ = static_cast<Chunk*>(marker.chunk);
+    position_ = marker.position;
+    end_ = current_->End();
+}
+
+void Arena::Release() {
+    while (first_) {
+        Chunk* next = first_->next;
+        std::free(first_);
+        first_ = next;
+    }
+    Enter(nullptr);
+    num_chunks_ = 0;
+    capacity_ = 0;
+}
+
+} // namespace memory_pool
@@ -0,0 +1,206 @@
+#include "concurrent_block_allocator.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace memory_pool {
+
+/// A stack of free blocks, owned either by a thread cache or by the depot
+struct ConcurrentBlockAllocator::Magazine {
+    size_t count = 0;
+    void* blocks[kMagazineSize];
+};
+
+/// Magazines shared by all threads, and the part of the region not yet handed out
+struct ConcurrentBlockAllocator::Depot {
+    std::mutex mutex;
+    std::atomic<bool> alive{true};                  ///< Cleared when the allocator is destroyed
+    std::vector<std::unique_ptr<Magazine>> loaded;  ///< Magazines holding at least one block
+    std::vector<std::unique_ptr<Magazine>> empty;   ///< Magazines ready to be filled
+    size_t loaded_blocks = 0;                       ///< Blocks held by the loaded magazines
+    char* next_block = nullptr;                     ///< First block never handed out
+    char* end = nullptr;
+    size_t stride = 0;
+
+    /// Fill magazine with blocks never handed out before. Caller holds mutex.
+    void Carve(Magazine& magazine) {
+        while (magazine.count < kMagazineSize && next_block < end) {
+            magazine.blocks[magazine.count++] = next_block;
+            next_block += stride;
+        }
+    }
+
+    /// Take back a thread's magazines. Caller holds mutex.
+    void Return(std::unique_ptr<Magazine> magazine) {
+        if (!magazine) {
+            return;
+        }
+        if (magazine->count > 0) {
+            loaded_blocks += magazine->count;
+            loaded.push_back(std::move(magazine));
+        } else {
+            empty.push_back(std::move(magazine));
+        }
+    }
+};
+
+/// One thread's magazines for one allocator
+struct ConcurrentBlockAllocator::ThreadCache {
+    uint64_t owner_id = 0;
+    std::shared_ptr<Depot> depot;
+    std::unique_ptr<Magazine> current = std::make_unique<Magazine>();
+    std::unique_ptr<Magazine> previous = std::make_unique<Magazine>();
+
+    ~ThreadCache() {
+        std::lock_guard<std::mutex> lock(depot->mutex);
+        depot->Return(std::move(current));
+        depot->Return(std::move(previous));
+    }
+};
+
+namespace {
+
+std::atomic<uint64_t> next_allocator_id{1};
+
+// The cache used last by this thread; plain pointer, so checking it needs no
+// TLS initialisation guard
+thread_local ConcurrentBlockAllocator::ThreadCache* last_cache = nullptr;
+
+// All of this thread's caches. Destroying it at thread exit hands every
+// magazine back to its depot.
+struct ThreadCacheList {
+    std::vector<std::unique_ptr<ConcurrentBlockAllocator::ThreadCache>> caches;
+
+    ~ThreadCacheList() { last_cache = nullptr; }
+};
+
+thread_local ThreadCacheList thread_caches;
+
+size_t RoundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+ConcurrentBlockAllocator::ConcurrentBlockAllocator(size_t block_size, size_t num_blocks)
+    : block_size_(block_size), num_blocks_(num_blocks), id_(next_allocator_id.fetch_add(1)) {
+    // Space blocks out so each one has malloc-like alignment
+    const size_t stride = RoundUp(std::max<size_t>(block_size_, 1), alignof(std::max_align_t));
+    const size_t total_size = RoundUp(std::max<size_t>(stride * num_blocks_, 1), 64);
+    memory_pool_ = std::aligned_alloc(64, total_size);
+    if (!memory_pool_) {
+        throw std::bad_alloc();
+    }
+
+    depot_ = std::make_shared<Depot>();
+    depot_->stride = stride;
+    depot_->next_block = static_cast<char*>(memory_pool_);
+    depot_->end = depot_->next_block + stride * num_blocks_;
+}
+
+ConcurrentBlockAllocator::~ConcurrentBlockAllocator() {
+    {
+        std::lock_guard<std::mutex> lock(depot_->mutex);
+        depot_->alive.store(false, std::memory_order_release);
+        depot_->loaded.clear();
+        depot_->empty.clear();
+        depot_->loaded_blocks = 0;
+        depot_->next_block = depot_->end = nullptr;
+    }
+    std::free(memory_pool_);
+}
+
+ConcurrentBlockAllocator::ThreadCache& ConcurrentBlockAllocator::GetThreadCache() {
+    ThreadCache* cache = last_cache;
+    if (cache && cache->owner_id == id_) {
+        return *cache;
+    }
+
+    auto& caches = thread_caches.caches;
+    auto it = std::find_if(caches.begin(), caches.end(),
+                           [this](const std::unique_ptr<ThreadCache>& c) { return c->owner_id == id_; });
+    if (it == caches.end()) {
+        // Drop caches of allocators that no longer exist before adding one
+        std::erase_if(caches, [](const std::unique_ptr<ThreadCache>& c) {
+            return !c->depot->alive.load(std::memory_order_acquire);
+        });
+        auto fresh = std::make_unique<ThreadCache>();
+        fresh->owner_id = id_;
+        fresh->depot = depot_;
+        caches.push_back(std::move(fresh));
+        it = std::prev(caches.end());
+    }
+    last_cache = it->get();
+    return *last_cache;
+}
+
+void* ConcurrentBlockAllocator::Allocate() {
+    ThreadCache& cache = GetThreadCache();
+    Magazine* magazine = cache.current.get();
+    if (magazine->count > 0) {
+        return magazine->blocks[--magazine->count];
+    }
+    if (cache.previous->count == 0) {
+        // Both magazines are empty: trade one for a loaded magazine, or fill
+        // it from the untouched part of the region
+        Depot& depot = *depot_;
+        std::lock_guard<std::mutex> lock(depot.mutex);
+        if (!depot.loaded.empty()) {
+            depot.empty.push_back(std::move(cache.previous));
+            cache.previous = std::move(depot.loaded.back());
+            depot.loaded.pop_back();
+            depot.loaded_blocks -= cache.previous->count;
+        } else {
+            depot.Carve(*cache.previous);
+        }
+        if (cache.previous->count == 0) {
+            return nullptr;
+        }
+    }
+    std::swap(cache.current, cache.previous);
+    magazine = cache.current.get();
+    return magazine->blocks[--magazine->count];
+}
+
+void ConcurrentBlockAllocator::Deallocate(void* ptr) {
+    char* block = static_cast<char*>(ptr);
+    char* pool_start = static_cast<char*>(memory_pool_);
+    if (block < pool_start || block >= pool_start + depot_->stride * num_blocks_) {
+        // nullptr or not from this pool
+        return;
+    }
+
+    ThreadCache& cache = GetThreadCache();
+    Magazine* magazine = cache.current.get();
+    if (magazine->count < kMagazineSize) {
+        magazine->blocks[magazine->count++] = ptr;
+        return;
+    }
+    if (cache.previous->count == kMagazineSize) {
+        // Both magazines are full: hand one to the depot for an empty one
+        Depot& depot = *depot_;
+        std::lock_guard<std::mutex> lock(depot.mutex);
+        depot.loaded_blocks += cache.previous->count;
+        depot.loaded.push_back(std::move(cache.previous));
+        if (!depot.empty.empty()) {
+            cache.previous = std::move(depot.empty.back());
+            depot.empty.pop_back();
+        } else {
+            cache.previous = std::make_unique<Magazine>();
+        }
+    }
+    std::swap(cache.current, cache.previous);
+    magazine = cache.current.get();
+    magazine->blocks[magazine->count++] = ptr;
+}
+
+size_t ConcurrentBlockAllocator::GetNumDepotBlocks() const {
+    std::lock_guard<std::mutex> lock(depot_->mutex);
+    return depot_->loaded_blocks + static_cast<size_t>(depot_->end - depot_->next_block) / depot_->stride;
+}
+
+} // namespace memory_pool
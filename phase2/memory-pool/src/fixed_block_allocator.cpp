@@ -1,37 +1,39 @@
 #include "fixed_block_allocator.h"
 #include <cstdlib>
 #include <new>
-#include <iostream>
 #include <algorithm>
-#include <cassert>
 
 namespace memory_pool {
 
-FixedBlockAllocator::FixedBlockAllocator(size_t block_size, size_t num_blocks)
-    : block_size_(block_size), num_blocks_(num_blocks), num_free_blocks_(num_blocks) {
-    // Allocate memory pool with alignment
-    size_t total_size = block_size_ * num_blocks_;
-    memory_pool_ = std::aligned_alloc(block_size_, total_size);
+FixedBlockAllocator::FixedBlockAllocator(size_t block_size, size_t num_blocks, bool check_double_free)
+    : block_size_(block_size),
+      stride_(std::max((block_size + alignof(void*) - 1) / alignof(void*) * alignof(void*), sizeof(void*))),
+      num_blocks_(num_blocks),
+      num_free_blocks_(num_blocks),
+      free_list_(nullptr) {
+    // Allocate memory pool with alignment. The stride is a multiple of
+    // alignof(void*), so the free-list link stored in a free block is always
+    // aligned. Power-of-two strides are aligned to their own size as before;
+    // any other stride gets the largest power of two dividing it (capped at
+    // max_align_t), which every type of the block size satisfies.
+    // aligned_alloc needs a power-of-two alignment and a size that is a
+    // multiple of it.
+    size_t lowest_bit = stride_ & (~stride_ + 1);
+    block_alignment_ = lowest_bit == stride_ ? stride_ : std::min(lowest_bit, alignof(std::max_align_t));
+    size_t total_size =
+        (std::max<size_t>(stride_ * num_blocks_, 1) + block_alignment_ - 1) / block_alignment_ * block_alignment_;
+    memory_pool_ = std::aligned_alloc(block_alignment_, total_size);
     if (!memory_pool_) {
         throw std::bad_alloc();
     }
+    next_unused_ = static_cast<char*>(memory_pool_);
 
-    // Initialize free list
-    free_list_ = static_cast<void**>(std::malloc(num_blocks_ * sizeof(void*)));
-    if (!free_list_) {
-        std::free(memory_pool_);
-        throw std::bad_alloc();
-    }
-
-    // Populate free list with pointers to each block
-    char* pool_ptr = static_cast<char*>(memory_pool_);
-    for (size_t i = 0; i < num_blocks_; ++i) {
-        free_list_[i] = pool_ptr + i * block_size_;
+    if (check_double_free) {
+        used_bits_ = std::make_unique<uint64_t[]>((num_blocks_ + 63) / 64);
     }
 }
 
 FixedBlockAllocator::~FixedBlockAllocator() {
-    std::free(free_list_);
     std::free(memory_pool_);
 }
 
@@ -40,8 +42,20 @@ void* FixedBlockAllocator::Allocate() {
         return nullptr; // No free blocks available
     }
 
-    // Get a block from the free list
-    void* block = free_list_[--num_free_blocks_];
+    // Pop the head of the free list, or take a block never handed out before
+    void* block = free_list_;
+    if (block) {
+        free_list_ = *static_cast<void**>(block);
+    } else {
+        block = next_unused_;
+        next_unused_ += stride_;
+    }
+    --num_free_blocks_;
+
+    if (used_bits_) {
+        size_t index = static_cast<size_t>(static_cast<char*>(block) - static_cast<char*>(memory_pool_)) / stride_;
+        used_bits_[index / 64] |= uint64_t{1} << (index % 64);
+    }
     return block;
 }
 
@@ -52,7 +66,7 @@ void FixedBlockAllocator::Deallocate(void* ptr) {
 
     // Check if the pointer is within the pool
     char* pool_start = static_cast<char*>(memory_pool_);
-    char* pool_end = pool_start + (block_size_ * num_blocks_);
+    char* pool_end = pool_start + (stride_ * num_blocks_);
     char* ptr_char = static_cast<char*>(ptr);
 
     if (ptr_char < pool_start || ptr_char >= pool_end) {
@@ -62,23 +76,26 @@ void FixedBlockAllocator::Deallocate(void* ptr) {
 
     // Check if the pointer is properly aligned to a block boundary
     size_t offset = ptr_char - pool_start;
-    if (offset % block_size_ != 0) {
+    if (offset % stride_ != 0) {
         // Pointer is not aligned to a block boundary
         return;
     }
 
-    // Check if the block is already free (double free detection)
-    // This is a simplified check - in a production implementation, 
-    // you might want a more robust mechanism
-    for (size_t i = 0; i < num_free_blocks_; ++i) {
-        if (free_list_[i] == ptr) {
+    // Double free detection: the block's bit must be set
+    if (used_bits_) {
+        size_t index = offset / stride_;
+        uint64_t mask = uint64_t{1} << (index % 64);
+        if (!(used_bits_[index / 64] & mask)) {
             // Block is already free
             return;
         }
+        used_bits_[index / 64] &= ~mask;
     }
 
-    // Add the block back to the free list
-    free_list_[num_free_blocks_++] = ptr;
+    // Push the block onto the free list, storing the link inside it
+    *static_cast<void**>(ptr) = free_list_;
+    free_list_ = ptr;
+    ++num_free_blocks_;
 }
 
 } // namespace memory_pool
@@ -44,12 +44,18 @@
  *   5. Press F5 to build and debug inside the container.
  */
 
+#include "arena.h"
 #include "fixed_block_allocator.h"
 #include "memory_pool.h"
+#include "pmr_resources.h"
+#include "slab_allocator.h"
+#include <cstdio>
 #include <iostream>
 #include <vector>
 #include <chrono>
 #include <memory>
+#include <memory_resource>
+#include <string>
 
 // Function to demonstrate FixedBlockAllocator
 void DemonstrateFixedBlockAllocator() {
@@ -117,6 +123,76 @@ void DemonstrateFixedBlockAllocator() {
     std::cout << std::endl;
 }
 
+// Function to demonstrate SlabAllocator
+void DemonstrateSlabAllocator() {
+    std::cout << "=== Slab Allocator Demonstration ===" << std::endl;
+
+    auto print_stats = [](const memory_pool::SlabAllocator& allocator) {
+        memory_pool::SlabStats stats = allocator.GetStats();
+        std::cout << "Slabs: " << stats.chunk_count << " (" << stats.empty_chunks << " empty), blocks in use: "
+                  << stats.blocks_in_use << "/" << stats.block_capacity
+                  << ", high-water mark: " << stats.high_water_blocks
+                  << ", fragmentation: " << stats.fragmentation * 100 << "%" << std::endl;
+    };
+
+    try {
+        // 40-byte blocks: not a power of two, still 16-byte aligned
+        memory_pool::SlabAllocator allocator(40, 16, 4096, 1);
+        std::cout << "Allocator created with block size " << allocator.GetBlockSize() << ", stride "
+                  << allocator.GetStride() << " and " << allocator.GetBlocksPerSlab() << " blocks per "
+                  << allocator.GetSlabSize() << "-byte slab." << std::endl;
+
+        // Allocate past several slabs; new ones are mapped on demand
+        std::vector<void*> blocks;
+        for (size_t i = 0; i < 4 * allocator.GetBlocksPerSlab(); ++i) {
+            blocks.push_back(allocator.Allocate());
+        }
+        print_stats(allocator);
+
+        // Free everything; one empty slab stays cached, the rest go back to the OS
+        for (void* block : blocks) {
+            allocator.Deallocate(block);
+        }
+        print_stats(allocator);
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+// Function to demonstrate Arena
+void DemonstrateArena() {
+    std::cout << "=== Arena Demonstration ===" << std::endl;
+
+    memory_pool::Arena arena(4096);
+    memory_pool::ArenaResource resource(arena);
+
+    // Allocations made for the whole session stay below the marker
+    auto* session_id = static_cast<char*>(arena.Allocate(32, 8));
+    std::snprintf(session_id, 32, "session-42");
+    memory_pool::Arena::Marker marker = arena.GetMarker();
+
+    for (int request = 0; request < 3; ++request) {
+        {
+            // Request-scoped containers; their frees are no-ops
+            std::pmr::vector<std::pmr::string> headers(&resource);
+            for (int i = 0; i < 100; ++i) {
+                headers.emplace_back("X-Request-Header-" + std::to_string(i) + ": some value");
+            }
+            std::cout << "Request " << request << " of " << session_id << ": " << headers.size()
+                      << " headers, arena has " << arena.GetNumChunks() << " chunk(s), " << arena.GetCapacity()
+                      << " bytes" << std::endl;
+        }
+
+        // Throw away everything since the marker; the chunks are reused
+        arena.Rewind(marker);
+    }
+
+    std::cout << std::endl;
+}
+
 // Function to demonstrate MemoryPool
 void DemonstrateMemoryPool() {
     std::cout << "=== General Memory Pool Demonstration ===" << std::endl;
@@ -181,44 +257,45 @@ void PerformanceComparison() {
 
     const size_t num_allocations = 10000;
     const size_t block_size = 64;
+    const size_t rounds = 100;
+    const double total_ops = static_cast<double>(num_allocations * rounds);
+    std::vector<void*> blocks(num_allocations);
 
     // Test std::malloc
     auto start = std::chrono::high_resolution_clock::now();
-    std::vector<void*> malloc_blocks;
-    for (size_t i = 0; i < num_allocations; ++i) {
-        void* block = std::malloc(block_size);
-        if (block) {
-            malloc_blocks.push_back(block);
+    for (size_t round = 0; round < rounds; ++round) {
+        for (size_t i = 0; i < num_allocations; ++i) {
+            blocks[i] = std::malloc(block_size);
+        }
+        for (void* block : blocks) {
+            std::free(block);
         }
-    }
-
-    for (void* block : malloc_blocks) {
-        std::free(block);
     }
     auto end = std::chrono::high_resolution_clock::now();
     auto malloc_duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
 
-    // Test FixedBlockAllocator
-    start = std::chrono::high_resolution_clock::now();
+    // Test FixedBlockAllocator (the pool is set up once, outside the timing,
+    // as a long-lived allocator would be)
     memory_pool::FixedBlockAllocator allocator(block_size, num_allocations);
-    std::vector<void*> pool_blocks;
-    for (size_t i = 0; i < num_allocations; ++i) {
-        void* block = allocator.Allocate();
-        if (block) {
-            pool_blocks.push_back(block);
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t round = 0; round < rounds; ++round) {
+        for (size_t i = 0; i < num_allocations; ++i) {
+            blocks[i] = allocator.Allocate();
+        }
+        for (void* block : blocks) {
+            allocator.Deallocate(block);
         }
-    }
-
-    for (void* block : pool_blocks) {
-        allocator.Deallocate(block);
     }
     end = std::chrono::high_resolution_clock::now();
     auto pool_duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
 
-    std::cout << "std::malloc time for " << num_allocations << " allocations/deallocations: " 
-              << malloc_duration.count() << " microseconds" << std::endl;
-    std::cout << "FixedBlockAllocator time for " << num_allocations << " allocations/deallocations: " 
-              << pool_duration.count() << " microseconds" << std::endl;
+    std::cout << "std::malloc time for " << rounds << " x " << num_allocations << " allocations/deallocations: "
+              << malloc_duration.count() << " microseconds ("
+              << malloc_duration.count() * 1000.0 / total_ops << " ns per pair)" << std::endl;
+    std::cout << "FixedBlockAllocator time for " << rounds << " x " << num_allocations
+              << " allocations/deallocations: " << pool_duration.count() << " microseconds ("
+              << pool_duration.count() * 1000.0 / total_ops << " ns per pair"
+              << (allocator.ChecksDoubleFree() ? ", with double-free checks" : "") << ")" << std::endl;
 
     std::cout << std::endl;
 }
@@ -226,7 +303,9 @@ void PerformanceComparison() {
 int main() {
     try {
         DemonstrateFixedBlockAllocator();
+        DemonstrateSlabAllocator();
         DemonstrateMemoryPool();
+        DemonstrateArena();
         PerformanceComparison();
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -1,22 +1,101 @@
 #include "memory_pool.h"
+#include <algorithm>
+#include <bit>
 #include <cstdlib>
 #include <new>
-#include <iostream>
-#include <algorithm>
-#include <cassert>
 
 namespace memory_pool {
 
+/// Header at the start of every size-class slab; the blocks follow it
+struct MemoryPool::Slab {
+    Slab* prev;            ///< Neighbours in the class's partial list
+    Slab* next;
+    void* free_list;       ///< Freed blocks, linked through their first bytes
+    char* next_unused;     ///< First block never handed out
+    uint32_t size_class;   ///< Index into kSizeClasses
+    uint32_t in_use;       ///< Blocks currently allocated from this slab
+    uint32_t capacity;     ///< Blocks the slab holds
+};
+
+/// Layout of a free large-tier block; the footer sits in its last word
+struct MemoryPool::FreeBlock {
+    size_t header;         ///< Block size | kUsed | kPrevUsed
+    size_t reserved;       ///< Keeps the payload 16-byte aligned
+    FreeBlock* prev;       ///< Neighbours in the block's bin
+    FreeBlock* next;
+};
+
+namespace {
+
+constexpr size_t kAlignment = 16;
+constexpr size_t kHeaderSize = 16;
+/// Header, two links and a footer, rounded up to the alignment
+constexpr size_t kMinBlockSize = 48;
+
+// Header flags; block sizes are multiples of kAlignment, so the low bits are free
+constexpr size_t kUsed = 1;
+constexpr size_t kPrevUsed = 2;
+constexpr size_t kFlagMask = kAlignment - 1;
+
+constexpr std::array<size_t, 16> kSizeClasses = {
+    16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512,
+};
+
+/// Size class for each request size rounded up to a multiple of 16, indexed by size / 16
+constexpr std::array<uint8_t, MemoryPool::kMaxSmallSize / kAlignment + 1> kClassIndex = [] {
+    std::array<uint8_t, MemoryPool::kMaxSmallSize / kAlignment + 1> table{};
+    size_t size_class = 0;
+    for (size_t i = 0; i < table.size(); ++i) {
+        while (kSizeClasses[size_class] < i * kAlignment) {
+            ++size_class;
+        }
+        table[i] = static_cast<uint8_t>(size_class);
+    }
+    return table;
+}();
+
+size_t RoundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+size_t& Header(char* block) {
+    return *reinterpret_cast<size_t*>(block);
+}
+
+size_t& Footer(char* block, size_t block_size) {
+    return *reinterpret_cast<size_t*>(block + block_size - sizeof(size_t));
+}
+
+size_t BlockSize(size_t header) {
+    return header & ~kFlagMask;
+}
+
+size_t BinIndex(size_t block_size) {
+    return static_cast<size_t>(std::bit_width(block_size)) - 1;
+}
+
+} // namespace
+
 MemoryPool::MemoryPool(size_t initial_pool_size)
     : total_size_(initial_pool_size), used_size_(0) {
     // Allocate memory pool
-    memory_pool_ = std::malloc(total_size_);
+    memory_pool_ = std::aligned_alloc(kAlignment, RoundUp(std::max(total_size_, kAlignment), kAlignment));
     if (!memory_pool_) {
         throw std::bad_alloc();
     }
 
-    // Initially, the entire pool is one free block
-    free_blocks_[total_size_] = memory_pool_;
+    // Initially, the entire pool is one free block, followed by a sentinel
+    // header marked used so that coalescing never runs off the end
+    char* base = static_cast<char*>(memory_pool_);
+    const size_t capacity = total_size_ / kAlignment * kAlignment;
+    region_end_ = base;
+    if (capacity >= kMinBlockSize + kHeaderSize) {
+        region_end_ = base + capacity - kHeaderSize;
+        Header(region_end_) = kUsed;
+        Header(base) = static_cast<size_t>(region_end_ - base) | kPrevUsed;
+        InsertFree(base, static_cast<size_t>(region_end_ - base));
+    }
+    slab_map_.resize(capacity / kSlabSize + 1);
 }
 
 MemoryPool::~MemoryPool() {
@@ -28,92 +107,271 @@ void* MemoryPool::Allocate(size_t size) {
         return nullptr;
     }
 
-    // Find the smallest free block that can accommodate the requested size
-    auto it = free_blocks_.lower_bound(size);
-    if (it == free_blocks_.end()) {
-        // No suitable block found
+    void* ptr = nullptr;
+    if (size <= kMaxSmallSize) {
+        ptr = AllocateSmall(kClassIndex[(size + kAlignment - 1) / kAlignment]);
+    }
+    if (!ptr) {
+        // Large request, or no room for another slab of its class
+        ptr = AllocateLarge(size);
+    }
+    if (ptr) {
+        used_size_ += size;
+    }
+    return ptr;
+}
+
+void MemoryPool::Deallocate(void* ptr, size_t size) {
+    if (!ptr || size == 0) {
+        return;
+    }
+
+    // Check if the pointer is within the pool
+    if (!Owns(ptr)) {
+        // Pointer is not from this pool
+        return;
+    }
+
+    Slab* slab = size <= kMaxSmallSize ? FindSlab(ptr) : nullptr;
+    if (slab) {
+        DeallocateSmall(slab, ptr);
+    } else {
+        DeallocateLarge(ptr);
+    }
+    used_size_ -= size;
+}
+
+size_t MemoryPool::GetLargestFreeBlock() const {
+    if (bin_bitmap_ == 0) {
+        return 0;
+    }
+    size_t largest = 0;
+    for (FreeBlock* block = bins_[63 - std::countl_zero(bin_bitmap_)]; block; block = block->next) {
+        largest = std::max(largest, BlockSize(block->header));
+    }
+    return largest - kHeaderSize;
+}
+
+void MemoryPool::InsertFree(char* block, size_t block_size) {
+    Footer(block, block_size) = block_size;
+
+    const size_t bin = BinIndex(block_size);
+    FreeBlock* free_block = reinterpret_cast<FreeBlock*>(block);
+    free_block->prev = nullptr;
+    free_block->next = bins_[bin];
+    if (bins_[bin]) {
+        bins_[bin]->prev = free_block;
+    }
+    bins_[bin] = free_block;
+    bin_bitmap_ |= uint64_t{1} << bin;
+}
+
+void MemoryPool::RemoveFree(char* block, size_t block_size) {
+    const size_t bin = BinIndex(block_size);
+    FreeBlock* free_block = reinterpret_cast<FreeBlock*>(block);
+    if (free_block->prev) {
+        free_block->prev->next = free_block->next;
+    } else {
+        bins_[bin] = free_block->next;
+        if (!bins_[bin]) {
+            bin_bitmap_ &= ~(uint64_t{1} << bin);
+        }
+    }
+    if (free_block->next) {
+        free_block->next->prev = free_block->prev;
+    }
+}
+
+void* MemoryPool::AllocateLarge(size_t size) {
+    if (size > total_size_) {
         return nullptr;
     }
+    const size_t needed = std::max(RoundUp(size + kHeaderSize, kAlignment), kMinBlockSize);
 
-    // Get the block
-    size_t block_size = it->first;
-    void* block_ptr = it->second;
-    free_blocks_.erase(it);
+    // First fit in the bin the request falls in; any block in a higher bin
+    // is large enough, so the bitmap finds one without walking
+    const size_t bin = BinIndex(needed);
+    FreeBlock* found = nullptr;
+    for (FreeBlock* block = bins_[bin]; block; block = block->next) {
+        if (BlockSize(block->header) >= needed) {
+            found = block;
+            break;
+        }
+    }
+    if (!found) {
+        const uint64_t higher = bin + 1 < kNumBins ? bin_bitmap_ & (~uint64_t{0} << (bin + 1)) : 0;
+        if (higher == 0) {
+            // Cached empty slabs may be all that stands in the way
+            return ReleaseEmptySlabs() ? AllocateLarge(size) : nullptr;
+        }
+        found = bins_[std::countr_zero(higher)];
+    }
+
+    char* block = reinterpret_cast<char*>(found);
+    size_t block_size = BlockSize(found->header);
+    const size_t prev_used = found->header & kPrevUsed;
+    RemoveFree(block, block_size);
 
     // If the block is larger than needed, split it
-    size_t remaining_size = block_size - size;
-    if (remaining_size > 0) {
-        // Add the remaining part back to free blocks
-        free_blocks_[remaining_size] = static_cast<char*>(block_ptr) + size;
+    if (block_size - needed >= kMinBlockSize) {
+        char* rest = block + needed;
+        Header(rest) = (block_size - needed) | kPrevUsed;
+        InsertFree(rest, block_size - needed);
+        block_size = needed;
+    } else {
+        Header(block + block_size) |= kPrevUsed;
+    }
+    Header(block) = block_size | kUsed | prev_used;
+    return block + kHeaderSize;
+}
+
+void MemoryPool::DeallocateLarge(void* ptr) {
+    char* block = static_cast<char*>(ptr) - kHeaderSize;
+    const size_t header = Header(block);
+    size_t block_size = BlockSize(header);
+
+    // Merge with the next block if it is free; the sentinel never is
+    char* next = block + block_size;
+    if (!(Header(next) & kUsed)) {
+        const size_t next_size = BlockSize(Header(next));
+        RemoveFree(next, next_size);
+        block_size += next_size;
+    }
+    // Merge with the previous block if it is free, found through its footer
+    if (!(header & kPrevUsed)) {
+        const size_t prev_size = *reinterpret_cast<size_t*>(block - sizeof(size_t));
+        block -= prev_size;
+        RemoveFree(block, prev_size);
+        block_size += prev_size;
     }
 
-    used_size_ += size;
-    return block_ptr;
+    // A free block's predecessor is always in use, or they would have merged
+    Header(block) = block_size | kPrevUsed;
+    Header(block + block_size) &= ~kPrevUsed;
+    InsertFree(block, block_size);
 }
 
-// Helper function to coalesce adjacent free blocks
-void MemoryPool::CoalesceBlocks() {
-    if (free_blocks_.empty()) {
-        return;
+void* MemoryPool::AllocateSmall(size_t size_class) {
+    constexpr size_t kFirstBlockOffset = (sizeof(Slab) + kAlignment - 1) / kAlignment * kAlignment;
+
+    Slab* slab = partial_slabs_[size_class];
+    if (!slab) {
+        void* memory = AllocateLarge(kSlabSize);
+        if (!memory) {
+            return nullptr;
+        }
+        slab = static_cast<Slab*>(memory);
+        slab->prev = slab->next = nullptr;
+        slab->free_list = nullptr;
+        slab->next_unused = static_cast<char*>(memory) + kFirstBlockOffset;
+        slab->size_class = static_cast<uint32_t>(size_class);
+        slab->in_use = 0;
+        slab->capacity = static_cast<uint32_t>((kSlabSize - kFirstBlockOffset) / kSizeClasses[size_class]);
+        MapSlab(slab, true);
+        partial_slabs_[size_class] = slab;
+        ++num_slabs_;
+    }
+
+    void* block = slab->free_list;
+    if (block) {
+        slab->free_list = *static_cast<void**>(block);
+    } else {
+        block = slab->next_unused;
+        slab->next_unused += kSizeClasses[size_class];
     }
 
-    // Create a new map to store coalesced blocks
-    std::map<size_t, void*> coalesced_blocks;
-    
-    // Sort free blocks by address
-    std::vector<std::pair<void*, size_t>> sorted_blocks;
-    for (const auto& pair : free_blocks_) {
-        sorted_blocks.push_back({pair.second, pair.first});
-    }
-    std::sort(sorted_blocks.begin(), sorted_blocks.end());
-    
-    // Coalesce adjacent blocks
-    auto it = sorted_blocks.begin();
-    while (it != sorted_blocks.end()) {
-        void* current_ptr = it->first;
-        size_t current_size = it->second;
-        
-        // Check if next block is adjacent
-        auto next_it = std::next(it);
-        while (next_it != sorted_blocks.end() && 
-               static_cast<char*>(current_ptr) + current_size == next_it->first) {
-            // Merge with next block
-            current_size += next_it->second;
-            ++next_it;
+    // Full slabs leave the partial list until one of their blocks is freed
+    if (++slab->in_use == slab->capacity) {
+        partial_slabs_[size_class] = slab->next;
+        if (slab->next) {
+            slab->next->prev = nullptr;
         }
-        
-        // Add coalesced block to new map
-        coalesced_blocks[current_size] = current_ptr;
-        
-        // Move to next unprocessed block
-        it = next_it;
+        slab->next = nullptr;
     }
-    
-    // Replace free_blocks_ with coalesced_blocks
-    free_blocks_ = std::move(coalesced_blocks);
+    return block;
 }
 
-void MemoryPool::Deallocate(void* ptr, size_t size) {
-    if (!ptr || size == 0) {
-        return;
+void MemoryPool::DeallocateSmall(Slab* slab, void* ptr) {
+    *static_cast<void**>(ptr) = slab->free_list;
+    slab->free_list = ptr;
+
+    Slab*& head = partial_slabs_[slab->size_class];
+    if (slab->in_use-- == slab->capacity) {
+        // A cached empty slab must stay its class's sole partial slab, or
+        // ReleaseEmptySlabs() could not find it; the class no longer needs it
+        if (head && head->in_use == 0) {
+            Slab* empty = head;
+            head = nullptr;
+            ReleaseSlab(empty);
+        }
+        slab->prev = nullptr;
+        slab->next = head;
+        if (head) {
+            head->prev = slab;
+        }
+        head = slab;
     }
 
-    // Check if the pointer is within the pool
-    char* pool_start = static_cast<char*>(memory_pool_);
-    char* pool_end = pool_start + total_size_;
-    char* ptr_char = static_cast<char*>(ptr);
+    // Keep the class's last slab when it empties, so a workload hovering
+    // around zero live blocks does not carve and release a slab every call;
+    // it is still released if a large request needs the room
+    if (slab->in_use == 0 && (slab->prev || slab->next)) {
+        if (slab->prev) {
+            slab->prev->next = slab->next;
+        } else {
+            head = slab->next;
+        }
+        if (slab->next) {
+            slab->next->prev = slab->prev;
+        }
+        ReleaseSlab(slab);
+    }
+}
 
-    if (ptr_char < pool_start || ptr_char + size > pool_end) {
-        // Pointer is not from this pool
-        return;
+void MemoryPool::ReleaseSlab(Slab* slab) {
+    MapSlab(slab, false);
+    --num_slabs_;
+    DeallocateLarge(slab);
+}
+
+bool MemoryPool::ReleaseEmptySlabs() {
+    bool released = false;
+    for (Slab*& head : partial_slabs_) {
+        // An empty slab is only ever cached as its class's sole partial slab
+        if (head && head->in_use == 0 && !head->next) {
+            Slab* slab = head;
+            head = nullptr;
+            ReleaseSlab(slab);
+            released = true;
+        }
     }
+    return released;
+}
 
-    // Add the block back to free blocks
-    free_blocks_[size] = ptr;
-    used_size_ -= size;
+MemoryPool::Slab* MemoryPool::FindSlab(const void* ptr) const {
+    // Slabs are not aligned to their size within the pool, so each
+    // kSlabSize granule records the (at most two) slabs overlapping it
+    const char* ptr_char = static_cast<const char*>(ptr);
+    const size_t granule = static_cast<size_t>(ptr_char - static_cast<const char*>(memory_pool_)) / kSlabSize;
+    for (Slab* slab : slab_map_[granule]) {
+        const char* start = reinterpret_cast<const char*>(slab);
+        if (slab && ptr_char >= start && ptr_char < start + kSlabSize) {
+            return slab;
+        }
+    }
+    return nullptr;
+}
 
-    // Coalesce adjacent free blocks
-    CoalesceBlocks();
+void MemoryPool::MapSlab(Slab* slab, bool add) {
+    const size_t offset = static_cast<size_t>(reinterpret_cast<char*>(slab) - static_cast<char*>(memory_pool_));
+    for (size_t granule = offset / kSlabSize; granule <= (offset + kSlabSize - 1) / kSlabSize; ++granule) {
+        for (Slab*& entry : slab_map_[granule]) {
+            if (add ? entry == nullptr : entry == slab) {
+                entry = add ? slab : nullptr;
+                break;
+            }
+        }
+    }
 }
 
 } // namespace memory_pool
@@ -0,0 +1,153 @@
+/**
+ * @file memory_pool_bench.cpp
+ * @brief Multi-threaded throughput of the fixed-size block allocators.
+ *
+ * Every thread repeatedly allocates a batch of blocks, writes to each one,
+ * and frees the batch again. Reports allocate+free pairs per second for:
+ *   - std::malloc / std::free
+ *   - one FixedBlockAllocator shared by all threads behind a std::mutex
+ *     (the only way to share the single-threaded allocator)
+ *   - one FixedBlockAllocator per thread, without a lock (an upper bound
+ *     for what the single-threaded allocator can do; nothing is shared)
+ *   - one ConcurrentBlockAllocator shared by all threads
+ * for 1, 2, 4, ... up to the given number of threads.
+ *
+ * How to Compile without Docker (from project root):
+ *   1. cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+ *   2. cmake --build build --target memory_pool_bench -- -j
+ *
+ * How to Run without Docker:
+ *   ./build/phase2/memory-pool/memory_pool_bench [max_threads] [rounds] [batch] [block_size]
+ *
+ * Examples:
+ *   # Default run (up to 4 threads, 2000 rounds of 256 blocks of 64 bytes)
+ *   ./build/phase2/memory-pool/memory_pool_bench
+ *
+ *   # More threads, bigger blocks
+ *   ./build/phase2/memory-pool/memory_pool_bench 16 1000 256 256
+ */
+
+#include "concurrent_block_allocator.h"
+#include "fixed_block_allocator.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct BenchConfig {
+    size_t rounds = 2000;
+    size_t batch = 256;
+    size_t block_size = 64;
+};
+
+// Run `threads` threads of config.rounds batches each; make_worker(t)
+// returns the allocate/free pair thread t uses. Returns pairs per second.
+double Run(int threads, const BenchConfig& config,
+           const std::function<std::pair<std::function<void*()>, std::function<void(void*)>>(int)>& make_worker) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&config, &make_worker, t] {
+            auto [allocate, deallocate] = make_worker(t);
+            std::vector<void*> blocks(config.batch);
+            for (size_t round = 0; round < config.rounds; ++round) {
+                for (size_t i = 0; i < config.batch; ++i) {
+                    blocks[i] = allocate();
+                    std::memset(blocks[i], static_cast<int>(i), 8);
+                }
+                for (size_t i = 0; i < config.batch; ++i) {
+                    deallocate(blocks[i]);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(threads) * config.rounds * config.batch / seconds;
+}
+
+void Report(const std::string& name, double pairs_per_second) {
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << pairs_per_second / 1e6 << " M alloc+free/s" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int max_threads = 4;
+    BenchConfig config;
+    if (argc > 1) {
+        max_threads = std::stoi(argv[1]);
+    }
+    if (argc > 2) {
+        config.rounds = std::stoul(argv[2]);
+    }
+    if (argc > 3) {
+        config.batch = std::stoul(argv[3]);
+    }
+    if (argc > 4) {
+        config.block_size = std::stoul(argv[4]);
+    }
+    std::cout << config.rounds << " rounds x " << config.batch << " blocks of " << config.block_size
+              << " bytes per thread" << std::endl;
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        std::cout << threads << " thread(s):" << std::endl;
+
+        Report("std::malloc / std::free", Run(threads, config, [&config](int) {
+                   return std::make_pair(std::function<void*()>([&config] { return std::malloc(config.block_size); }),
+                                         std::function<void(void*)>([](void* p) { std::free(p); }));
+               }));
+
+        {
+            memory_pool::FixedBlockAllocator shared(config.block_size, config.batch * threads);
+            std::mutex mutex;
+            Report("FixedBlockAllocator + std::mutex", Run(threads, config, [&shared, &mutex](int) {
+                       return std::make_pair(std::function<void*()>([&shared, &mutex] {
+                                                 std::lock_guard<std::mutex> lock(mutex);
+                                                 return shared.Allocate();
+                                             }),
+                                             std::function<void(void*)>([&shared, &mutex](void* p) {
+                                                 std::lock_guard<std::mutex> lock(mutex);
+                                                 shared.Deallocate(p);
+                                             }));
+                   }));
+        }
+
+        {
+            std::vector<std::unique_ptr<memory_pool::FixedBlockAllocator>> own;
+            for (int t = 0; t < threads; ++t) {
+                own.push_back(std::make_unique<memory_pool::FixedBlockAllocator>(config.block_size, config.batch));
+            }
+            Report("FixedBlockAllocator per thread", Run(threads, config, [&own](int t) {
+                       memory_pool::FixedBlockAllocator* mine = own[t].get();
+                       return std::make_pair(std::function<void*()>([mine] { return mine->Allocate(); }),
+                                             std::function<void(void*)>([mine](void* p) { mine->Deallocate(p); }));
+                   }));
+        }
+
+        {
+            // Room for every thread's batch plus the magazines it may hold on to
+            const size_t per_thread = config.batch + 2 * memory_pool::ConcurrentBlockAllocator::kMagazineSize;
+            memory_pool::ConcurrentBlockAllocator concurrent(config.block_size, per_thread * threads);
+            Report("ConcurrentBlockAllocator", Run(threads, config, [&concurrent](int) {
+                       return std::make_pair(std::function<void*()>([&concurrent] { return concurrent.Allocate(); }),
+                                             std::function<void(void*)>([&concurrent](void* p) {
+                                                 concurrent.Deallocate(p);
+                                             }));
+                   }));
+        }
+    }
+    return 0;
+}
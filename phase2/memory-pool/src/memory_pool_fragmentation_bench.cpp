@@ -0,0 +1,232 @@
+/**
+ * @file memory_pool_fragmentation_bench.cpp
+ * @brief Throughput and fragmentation of MemoryPool under a mixed-size workload.
+ *
+ * Runs the same random sequence of allocations and frees against:
+ *   - std::malloc / std::free
+ *   - a copy of the previous MemoryPool, which kept free blocks in a
+ *     std::map keyed by size and rebuilt it sorted by address on every free
+ *   - the current MemoryPool (size classes + boundary-tag coalescing)
+ * Sizes are mostly small (1-512 bytes) with a tail of large ones (up to
+ * 16 KiB); the number of live blocks wanders around the given target.
+ *
+ * Reports operations per second and allocations that failed. For the
+ * pools it also reports fragmentation once the workload is done:
+ * 1 - largest free block / free bytes, i.e. how much of the free space a
+ * single request could not use.
+ *
+ * How to Compile without Docker (from project root):
+ *   1. cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+ *   2. cmake --build build --target memory_pool_fragmentation_bench -- -j
+ *
+ * How to Run without Docker:
+ *   ./build/phase2/memory-pool/memory_pool_fragmentation_bench [ops] [live_blocks] [pool_mb]
+ *
+ * Examples:
+ *   # Default run (200000 operations, ~2000 live blocks, 64 MiB pools)
+ *   ./build/phase2/memory-pool/memory_pool_fragmentation_bench
+ *
+ *   # Longer run with a bigger working set
+ *   ./build/phase2/memory-pool/memory_pool_fragmentation_bench 1000000 10000 256
+ */
+
+#include "memory_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The MemoryPool implementation this one replaced, kept for comparison
+class MapMemoryPool {
+public:
+    explicit MapMemoryPool(size_t size) : total_size_(size), memory_pool_(std::malloc(size)) {
+        free_blocks_[total_size_] = memory_pool_;
+    }
+    ~MapMemoryPool() { std::free(memory_pool_); }
+
+    void* Allocate(size_t size) {
+        auto it = free_blocks_.lower_bound(size);
+        if (it == free_blocks_.end()) {
+            return nullptr;
+        }
+        size_t block_size = it->first;
+        void* block_ptr = it->second;
+        free_blocks_.erase(it);
+        if (block_size > size) {
+            free_blocks_[block_size - size] = static_cast<char*>(block_ptr) + size;
+        }
+        used_size_ += size;
+        return block_ptr;
+    }
+
+    void Deallocate(void* ptr, size_t size) {
+        free_blocks_[size] = ptr;
+        used_size_ -= size;
+
+        std::vector<std::pair<void*, size_t>> sorted_blocks;
+        for (const auto& pair : free_blocks_) {
+            sorted_blocks.push_back({pair.second, pair.first});
+        }
+        std::sort(sorted_blocks.begin(), sorted_blocks.end());
+        std::map<size_t, void*> coalesced_blocks;
+        for (auto it = sorted_blocks.begin(); it != sorted_blocks.end();) {
+            void* current_ptr = it->first;
+            size_t current_size = it->second;
+            for (++it; it != sorted_blocks.end() && static_cast<char*>(current_ptr) + current_size == it->first; ++it) {
+                current_size += it->second;
+            }
+            coalesced_blocks[current_size] = current_ptr;
+        }
+        free_blocks_ = std::move(coalesced_blocks);
+    }
+
+    size_t GetFreeSize() const { return total_size_ - used_size_; }
+    size_t GetLargestFreeBlock() const { return free_blocks_.empty() ? 0 : free_blocks_.rbegin()->first; }
+
+private:
+    size_t total_size_;
+    size_t used_size_ = 0;
+    void* memory_pool_;
+    std::map<size_t, void*> free_blocks_;
+};
+
+struct Op {
+    bool allocate;
+    size_t value;  ///< Size to allocate, or which live block to free
+};
+
+// Build the operation sequence up front so every allocator sees the same one
+std::vector<Op> MakeWorkload(size_t ops, size_t live_target) {
+    std::vector<Op> workload;
+    workload.reserve(ops);
+    uint64_t seed = 42;
+    auto next_random = [&seed] {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return seed >> 33;
+    };
+    size_t live = 0;
+    for (size_t i = 0; i < ops; ++i) {
+        // Grow while below the target, then hover around it
+        bool allocate = live == 0 || (live < live_target ? next_random() % 100 < 75 : next_random() % 100 < 50);
+        if (allocate) {
+            size_t size = next_random() % 10 < 8 ? 1 + next_random() % 512 : 513 + next_random() % 16384;
+            workload.push_back({true, size});
+            ++live;
+        } else {
+            workload.push_back({false, next_random()});
+            --live;
+        }
+    }
+    return workload;
+}
+
+struct Result {
+    double ops_per_second = 0.0;
+    size_t failures = 0;
+    double fragmentation = -1.0;  ///< Negative when not measured
+};
+
+// Replays the workload; frees pick a live block by index (swap-and-pop).
+// measure() is called while the last live blocks are still allocated.
+template <typename Allocate, typename Deallocate, typename Measure>
+Result Replay(const std::vector<Op>& workload, Allocate allocate, Deallocate deallocate, Measure measure) {
+    struct Live {
+        void* ptr;
+        size_t size;
+    };
+    std::vector<Live> live;
+    live.reserve(workload.size());
+    Result result;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const Op& op : workload) {
+        if (op.allocate) {
+            void* ptr = allocate(op.value);
+            if (!ptr) {
+                ++result.failures;
+                continue;
+            }
+            std::memset(ptr, 0xAB, std::min<size_t>(op.value, 16));
+            live.push_back({ptr, op.value});
+        } else if (!live.empty()) {
+            size_t index = op.value % live.size();
+            deallocate(live[index].ptr, live[index].size);
+            live[index] = live.back();
+            live.pop_back();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.ops_per_second = static_cast<double>(workload.size()) / seconds;
+    result.fragmentation = measure();
+
+    for (const Live& block : live) {
+        deallocate(block.ptr, block.size);
+    }
+    return result;
+}
+
+void Report(const std::string& name, const Result& result) {
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(8) << result.ops_per_second / 1e6 << " M ops/s" << std::setw(8) << result.failures
+              << " failed";
+    if (result.fragmentation >= 0.0) {
+        std::cout << std::setw(8) << result.fragmentation * 100.0 << "% fragmented";
+    }
+    std::cout << std::endl;
+}
+
+double Fragmentation(size_t free_size, size_t largest_free_block) {
+    return free_size == 0 ? 0.0 : 1.0 - static_cast<double>(largest_free_block) / static_cast<double>(free_size);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t ops = 200000;
+    size_t live_target = 2000;
+    size_t pool_size = 64u << 20;
+    if (argc > 1) {
+        ops = std::stoul(argv[1]);
+    }
+    if (argc > 2) {
+        live_target = std::stoul(argv[2]);
+    }
+    if (argc > 3) {
+        pool_size = std::stoul(argv[3]) << 20;
+    }
+    std::cout << ops << " operations, ~" << live_target << " live blocks, " << (pool_size >> 20) << " MiB pools"
+              << std::endl;
+
+    const std::vector<Op> workload = MakeWorkload(ops, live_target);
+
+    Report("std::malloc / std::free",
+           Replay(workload, [](size_t size) { return std::malloc(size); }, [](void* p, size_t) { std::free(p); },
+                  [] { return -1.0; }));
+
+    {
+        MapMemoryPool pool(pool_size);
+        Report("std::map free list (previous)",
+               Replay(
+                   workload, [&pool](size_t size) { return pool.Allocate(size); },
+                   [&pool](void* p, size_t size) { pool.Deallocate(p, size); },
+                   [&pool] { return Fragmentation(pool.GetFreeSize(), pool.GetLargestFreeBlock()); }));
+    }
+
+    {
+        memory_pool::MemoryPool pool(pool_size);
+        Report("MemoryPool (size classes)",
+               Replay(
+                   workload, [&pool](size_t size) { return pool.Allocate(size); },
+                   [&pool](void* p, size_t size) { pool.Deallocate(p, size); },
+                   [&pool] { return Fragmentation(pool.GetFreeSize(), pool.GetLargestFreeBlock()); }));
+    }
+    return 0;
+}
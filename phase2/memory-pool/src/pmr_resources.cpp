@@ -0,0 +1,67 @@
+#include "pmr_resources.h"
+#include <algorithm>
+#include <new>
+
+namespace memory_pool {
+
+void* ArenaResource::do_allocate(size_t bytes, size_t alignment) {
+    // memory_resource allows zero-byte requests; they still need a unique pointer
+    void* ptr = arena_.Allocate(std::max<size_t>(bytes, 1), alignment);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void ArenaResource::do_deallocate(void*, size_t, size_t) {
+    // Monotonic: memory comes back with Arena::Reset() or Arena::Rewind()
+}
+
+bool ArenaResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void* MemoryPoolResource::do_allocate(size_t bytes, size_t alignment) {
+    // MemoryPool hands out 16-byte aligned blocks
+    if (alignment <= 16) {
+        if (void* ptr = pool_.Allocate(std::max<size_t>(bytes, 1))) {
+            return ptr;
+        }
+    }
+    return upstream_->allocate(bytes, alignment);
+}
+
+void MemoryPoolResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+    if (pool_.Owns(ptr)) {
+        pool_.Deallocate(ptr, std::max<size_t>(bytes, 1));
+    } else {
+        upstream_->deallocate(ptr, bytes, alignment);
+    }
+}
+
+bool MemoryPoolResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void* FixedBlockResource::do_allocate(size_t bytes, size_t alignment) {
+    if (bytes <= allocator_.GetBlockSize() && alignment <= allocator_.GetBlockAlignment()) {
+        if (void* ptr = allocator_.Allocate()) {
+            return ptr;
+        }
+    }
+    return upstream_->allocate(bytes, alignment);
+}
+
+void FixedBlockResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+    if (allocator_.Owns(ptr)) {
+        allocator_.Deallocate(ptr);
+    } else {
+        upstream_->deallocate(ptr, bytes, alignment);
+    }
+}
+
+bool FixedBlockResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+} // namespace memory_pool
@@ -0,0 +1,201 @@
+#include "slab_allocator.h"
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace memory_pool {
+
+/// Header at the start of every slab; the blocks follow it
+struct SlabAllocator::Slab {
+    SlabAllocator* owner;  ///< Allocator the slab belongs to
+    Slab* prev;            ///< Neighbours in the partial, empty or full list
+    Slab* next;
+    void* free_list;       ///< Freed blocks, linked through their first bytes
+    char* next_unused;     ///< First block never handed out
+    size_t in_use;         ///< Blocks currently allocated from this slab
+};
+
+namespace {
+
+size_t RoundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool IsPowerOfTwo(size_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+} // namespace
+
+SlabAllocator::SlabAllocator(size_t block_size, size_t alignment, size_t slab_size, size_t max_empty_slabs)
+    : block_size_(block_size), max_empty_slabs_(max_empty_slabs) {
+    if (!IsPowerOfTwo(alignment)) {
+        throw std::invalid_argument("SlabAllocator alignment must be a power of two");
+    }
+    // Free blocks hold the free-list link, so they need room and alignment for a pointer
+    alignment = std::max(alignment, alignof(void*));
+    stride_ = RoundUp(std::max(block_size_, sizeof(void*)), alignment);
+    first_block_offset_ = RoundUp(sizeof(Slab), alignment);
+
+    const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    slab_size_ = page_size;
+    while (slab_size_ < slab_size || slab_size_ < first_block_offset_ + 8 * stride_) {
+        slab_size_ *= 2;
+    }
+    blocks_per_slab_ = (slab_size_ - first_block_offset_) / stride_;
+}
+
+SlabAllocator::~SlabAllocator() {
+    for (Slab* list : {partial_, empty_, full_}) {
+        while (list) {
+            Slab* next = list->next;
+            UnmapSlab(list);
+            list = next;
+        }
+    }
+}
+
+SlabAllocator::Slab* SlabAllocator::MapSlab() {
+    // Map twice the size and trim, so the slab is aligned to its own size
+    // and a block's slab can be found by masking its address
+    const size_t length = slab_size_ * 2;
+    void* raw = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    const uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = RoundUp(start, slab_size_);
+    if (aligned > start) {
+        ::munmap(raw, aligned - start);
+    }
+    const uintptr_t tail = aligned + slab_size_;
+    if (start + length > tail) {
+        ::munmap(reinterpret_cast<void*>(tail), start + length - tail);
+    }
+
+    Slab* slab = reinterpret_cast<Slab*>(aligned);
+    slab->owner = this;
+    slab->prev = slab->next = nullptr;
+    slab->free_list = nullptr;
+    slab->next_unused = reinterpret_cast<char*>(aligned) + first_block_offset_;
+    slab->in_use = 0;
+
+    ++chunk_count_;
+    high_water_chunks_ = std::max(high_water_chunks_, chunk_count_);
+    return slab;
+}
+
+void SlabAllocator::UnmapSlab(Slab* slab) {
+    ::munmap(slab, slab_size_);
+    --chunk_count_;
+}
+
+void SlabAllocator::PushFront(Slab*& head, Slab* slab) {
+    slab->prev = nullptr;
+    slab->next = head;
+    if (head) {
+        head->prev = slab;
+    }
+    head = slab;
+}
+
+void SlabAllocator::Unlink(Slab*& head, Slab* slab) {
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        head = slab->next;
+    }
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+    slab->prev = slab->next = nullptr;
+}
+
+void* SlabAllocator::Allocate() {
+    // Fill partially used slabs first, then reuse a cached empty one, and
+    // only map a new slab when there is neither
+    Slab* slab = partial_;
+    if (!slab) {
+        if (empty_) {
+            slab = empty_;
+            Unlink(empty_, slab);
+            --empty_count_;
+        } else {
+            slab = MapSlab();
+            if (!slab) {
+                return nullptr;
+            }
+        }
+        PushFront(partial_, slab);
+    }
+
+    void* block = slab->free_list;
+    if (block) {
+        slab->free_list = *static_cast<void**>(block);
+    } else {
+        block = slab->next_unused;
+        slab->next_unused += stride_;
+    }
+
+    if (++slab->in_use == blocks_per_slab_) {
+        Unlink(partial_, slab);
+        PushFront(full_, slab);
+    }
+    high_water_blocks_ = std::max(high_water_blocks_, ++blocks_in_use_);
+    return block;
+}
+
+void SlabAllocator::Deallocate(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    Slab* slab = reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) & ~(slab_size_ - 1));
+    assert(slab->owner == this && "block was not allocated by this SlabAllocator");
+
+    *static_cast<void**>(ptr) = slab->free_list;
+    slab->free_list = ptr;
+    --blocks_in_use_;
+
+    if (slab->in_use-- == blocks_per_slab_) {
+        Unlink(full_, slab);
+        PushFront(partial_, slab);
+    }
+    if (slab->in_use == 0) {
+        Unlink(partial_, slab);
+        if (empty_count_ < max_empty_slabs_) {
+            PushFront(empty_, slab);
+            ++empty_count_;
+        } else {
+            UnmapSlab(slab);
+        }
+    }
+}
+
+void SlabAllocator::ReleaseEmptySlabs() {
+    while (empty_) {
+        Slab* slab = empty_;
+        Unlink(empty_, slab);
+        UnmapSlab(slab);
+    }
+    empty_count_ = 0;
+}
+
+SlabStats SlabAllocator::GetStats() const {
+    SlabStats stats;
+    stats.chunk_count = chunk_count_;
+    stats.empty_chunks = empty_count_;
+    stats.bytes_mapped = chunk_count_ * slab_size_;
+    stats.blocks_in_use = blocks_in_use_;
+    stats.block_capacity = chunk_count_ * blocks_per_slab_;
+    stats.high_water_blocks = high_water_blocks_;
+    stats.high_water_chunks = high_water_chunks_;
+    if (stats.bytes_mapped > 0) {
+        stats.fragmentation =
+            1.0 - static_cast<double>(blocks_in_use_ * block_size_) / static_cast<double>(stats.bytes_mapped);
+    }
+    return stats;
+}
+
+} // namespace memory_pool
@@ -20,14 +20,32 @@
  * - NoMatchInText: Tests behavior when pattern is not found
  * - MatchesWithLineNumbers: Tests grep with line number display
  * - HandlesNonExistentFile: Tests error handling for non-existent files
+ * - MmapMatchesGrepFile: Verifies the mmap search path produces the same output as grep_file
+ * - MmapHandlesEmptyFileAndMissingNewline: Tests mmap edge cases (empty file, unterminated last line)
+ * - MmapFallsBackToStreamingForFifo: Tests that pipes/FIFOs (e.g. <(cmd)) are read as a stream
+ * - BufferMatchesGrepText: Compares grep_buffer with grep_text on tricky inputs
+ * - FindSubstringMatchesStdFind: Cross-checks the SIMD substring kernel against std::string::find
+ * - ParallelMatchesSerialOnSmallChunks: Verifies chunked parallel search keeps order and line numbers
+ * - ParallelPrefixesFileNamesInInputOrder: Tests multi-file output order and file name prefixes
+ * - ParallelReportsMissingFileAndContinues: Tests error reporting for one missing file among several
+ * - LiteralSetMatchesAnyPattern: Cross-checks the Aho-Corasick matcher against std::string::find
+ * - RegexMatchesExpectedLines: Table-driven checks of the regex DFA syntax
+ * - RegexRejectsInvalidSyntax: Tests that malformed expressions throw std::invalid_argument
+ * - MatcherReusedAcrossBuffersAndFiles: Tests grep_buffer/grep_files_parallel with one compiled matcher
  */
 
 #include "gtest/gtest.h"
 #include "grep.h"
+#include "multi_matcher.h"
+#include "simd_search.h"
+#include <random>
+#include <stdexcept>
 #include <sstream>
 #include <string>
 #include <fstream>
 #include <filesystem>
+#include <thread>
+#include <sys/stat.h>
 
 class GrepTest : public ::testing::Test {
 protected:
@@ -165,6 +183,267 @@ TEST(GrepTextTest, HandlesEmptyText) {
     EXPECT_TRUE(result.empty());
 }
 
+TEST_F(GrepTest, MmapMatchesGrepFile) {
+    for (bool show_line_numbers : {false, true}) {
+        for (const std::string pattern : {"pattern", "line", "e", "", "not present"}) {
+            std::stringstream expected;
+            std::stringstream actual;
+            EXPECT_TRUE(grep_file(pattern, test_file, expected, show_line_numbers));
+            EXPECT_TRUE(grep_file_mmap(pattern, test_file, actual, show_line_numbers));
+            EXPECT_EQ(actual.str(), expected.str()) << "pattern: \"" << pattern << "\"";
+        }
+    }
+}
+
+TEST_F(GrepTest, MmapHandlesEmptyFileAndMissingNewline) {
+    std::filesystem::path empty_file = test_dir / "empty.txt";
+    std::ofstream(empty_file).close();
+    std::stringstream empty_out;
+    EXPECT_TRUE(grep_file_mmap("pattern", empty_file, empty_out, true));
+    EXPECT_TRUE(empty_out.str().empty());
+
+    std::filesystem::path tail_file = test_dir / "tail.txt";
+    std::ofstream(tail_file) << "one\n\ntwo pattern";
+    std::stringstream tail_out;
+    EXPECT_TRUE(grep_file_mmap("pattern", tail_file, tail_out, true));
+    EXPECT_EQ(tail_out.str(), "3:two pattern\n");
+
+    std::stringstream missing_out;
+    EXPECT_FALSE(grep_file_mmap("pattern", test_dir / "missing.txt", missing_out));
+    EXPECT_NE(missing_out.str().find("Error: File does not exist"), std::string::npos);
+}
+
+TEST_F(GrepTest, MmapFallsBackToStreamingForFifo) {
+    // Larger than one read block, with a line split across blocks, and no trailing newline
+    std::string content;
+    for (int i = 0; i < 20000; ++i) {
+        content += (i % 7 == 0 ? "line with pattern " : "plain line ") + std::to_string(i) + "\n";
+    }
+    content += "last pattern";
+    std::filesystem::path regular = test_dir / "fifo_content.txt";
+    std::ofstream(regular, std::ios::binary) << content;
+
+    std::filesystem::path fifo = test_dir / "input.fifo";
+    ASSERT_EQ(::mkfifo(fifo.c_str(), 0600), 0);
+
+    // Every read of the FIFO needs its own writer
+    auto feed = [&] {
+        return std::thread([&] { std::ofstream(fifo, std::ios::binary) << content; });
+    };
+
+    std::stringstream expected;
+    EXPECT_TRUE(grep_file("pattern", regular, expected, true));
+
+    std::stringstream actual;
+    std::thread writer = feed();
+    EXPECT_TRUE(grep_file_mmap("pattern", fifo, actual, true));
+    writer.join();
+    EXPECT_EQ(actual.str(), expected.str());
+
+    std::stringstream parallel;
+    writer = feed();
+    EXPECT_TRUE(grep_files_parallel("pattern", {fifo}, parallel, true, 2, 4096));
+    writer.join();
+    EXPECT_EQ(parallel.str(), expected.str());
+}
+
+TEST(GrepBufferTest, BufferMatchesGrepText) {
+    const std::string texts[] = {
+        "abc\n\nabcabc\nxabc",
+        "\n\n\n",
+        "no newline at all abc",
+        "abab\nbaba\naabb\n",
+    };
+    for (const auto& text : texts) {
+        for (const std::string pattern : {"abc", "ab", "a", "", "\n", "zzz"}) {
+            std::stringstream expected;
+            std::stringstream actual;
+            grep_text(pattern, text, expected, true);
+            grep_buffer(pattern, text.data(), text.size(), actual, true);
+            EXPECT_EQ(actual.str(), expected.str()) << "pattern: \"" << pattern << "\"";
+        }
+    }
+}
+
+TEST(SimdSearchTest, FindSubstringMatchesStdFind) {
+    // A small alphabet makes partial first/last byte hits frequent
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> letter('a', 'd');
+    std::string haystack(1000, ' ');
+    for (auto& c : haystack) {
+        c = static_cast<char>(letter(rng));
+    }
+
+    for (size_t len = 1; len <= 40; ++len) {
+        for (size_t start = 0; start + len <= haystack.size(); start += 97) {
+            std::string needle = haystack.substr(start, len);
+            for (size_t offset : {size_t{0}, size_t{1}, size_t{17}, size_t{500}}) {
+                const char* hit = find_substring(haystack.data() + offset, haystack.size() - offset, needle);
+                size_t expected = haystack.find(needle, offset);
+                if (expected == std::string::npos) {
+                    EXPECT_EQ(hit, nullptr);
+                } else {
+                    ASSERT_NE(hit, nullptr);
+                    EXPECT_EQ(static_cast<size_t>(hit - haystack.data()), expected);
+                }
+            }
+        }
+    }
+
+    EXPECT_EQ(count_newlines("a\nb\n\nc", 7), 3u);
+}
+
+TEST_F(GrepTest, ParallelMatchesSerialOnSmallChunks) {
+    // Build a file large enough to be split into many chunks
+    std::filesystem::path big_file = test_dir / "big.txt";
+    {
+        std::ofstream file(big_file);
+        for (int i = 0; i < 2000; ++i) {
+            file << "line " << i << (i % 7 == 0 ? " has the pattern" : " is plain") << "\n";
+        }
+        file << "unterminated pattern line";
+    }
+
+    std::stringstream expected;
+    ASSERT_TRUE(grep_file("pattern", big_file, expected, true));
+
+    // Chunk sizes smaller than a line, around a line and much larger than one
+    for (size_t chunk_size : {size_t{1}, size_t{25}, size_t{4096}, DEFAULT_GREP_CHUNK_SIZE}) {
+        for (size_t num_threads : {size_t{1}, size_t{4}}) {
+            std::stringstream actual;
+            EXPECT_TRUE(grep_files_parallel("pattern", {big_file}, actual, true, num_threads, chunk_size));
+            EXPECT_EQ(actual.str(), expected.str()) << "chunk_size=" << chunk_size
+                                                    << " num_threads=" << num_threads;
+        }
+    }
+}
+
+TEST_F(GrepTest, ParallelPrefixesFileNamesInInputOrder) {
+    std::filesystem::path second_file = test_dir / "second.txt";
+    std::ofstream(second_file) << "no match\nanother pattern here\n";
+
+    std::stringstream ss;
+    EXPECT_TRUE(grep_files_parallel("pattern", {second_file, test_file, second_file}, ss, true, 3, 8));
+
+    const std::string second = second_file.string();
+    const std::string first = test_file.string();
+    EXPECT_EQ(ss.str(), second + ":2:another pattern here\n" +
+                        first + ":2:This line contains the pattern\n" +
+                        second + ":2:another pattern here\n");
+}
+
+TEST_F(GrepTest, ParallelReportsMissingFileAndContinues) {
+    std::stringstream ss;
+    EXPECT_FALSE(grep_files_parallel("pattern", {test_dir / "missing.txt", test_file}, ss, false, 2));
+
+    std::string result = ss.str();
+    size_t error_pos = result.find("Error: File does not exist");
+    size_t match_pos = result.find("This line contains the pattern");
+    ASSERT_NE(error_pos, std::string::npos);
+    ASSERT_NE(match_pos, std::string::npos);
+    EXPECT_LT(error_pos, match_pos);
+}
+
+TEST(MultiPatternMatcherTest, LiteralSetMatchesAnyPattern) {
+    const std::vector<std::string> patterns = {"he", "she", "his", "hers", "ushers", "x"};
+    MultiPatternMatcher matcher = MultiPatternMatcher::from_literals(patterns);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> letter(0, 5);
+    const char alphabet[] = {'h', 'e', 's', 'r', 'u', 'i'};
+    for (int round = 0; round < 2000; ++round) {
+        std::string line(rng() % 12, ' ');
+        for (auto& c : line) {
+            c = alphabet[letter(rng)];
+        }
+        bool expected = false;
+        for (const auto& pattern : patterns) {
+            expected = expected || line.find(pattern) != std::string::npos;
+        }
+        EXPECT_EQ(matcher.matches(line), expected) << "line: " << line;
+    }
+
+    EXPECT_TRUE(MultiPatternMatcher::from_literals({"", "zzz"}).matches("anything"));
+    EXPECT_FALSE(MultiPatternMatcher::from_literals({}).matches("anything"));
+    EXPECT_FALSE(MultiPatternMatcher().matches("anything"));
+}
+
+TEST(MultiPatternMatcherTest, RegexMatchesExpectedLines) {
+    struct Case {
+        const char* regex;
+        const char* line;
+        bool expected;
+    };
+    const Case cases[] = {
+        {"abc", "xxabcxx", true},
+        {"a.c", "abc", true},
+        {"a.c", "ac", false},
+        {"ab*c", "ac", true},
+        {"ab+c", "ac", false},
+        {"ab+c", "abbbc", true},
+        {"colou?r", "color", true},
+        {"colou?r", "colour", true},
+        {"(cat|dog)s", "hotdogs", true},
+        {"(cat|dog)s", "cows", false},
+        {"^start", "start here", true},
+        {"^start", "not start", false},
+        {"end$", "the end", true},
+        {"end$", "end of it", false},
+        {"^$", "", true},
+        {"^$", " ", false},
+        {"status=5[0-9][0-9]", "status=503 x", true},
+        {"status=5[0-9][0-9]", "status=200 x", false},
+        {"[^a-z]", "abc", false},
+        {"[^a-z]", "abC", true},
+        {"\\d+ms", "took 15ms", true},
+        {"\\d+ms", "took ms", false},
+        {"\\w+@\\w+\\.com", "mail bob@example.com now", true},
+        {"a\\.b", "axb", false},
+        {"a\\.b", "a.b", true},
+        {"[]x]", "]", true},
+        {"[a-]", "-", true},
+        {"x*", "anything", true},
+    };
+    for (const auto& c : cases) {
+        MultiPatternMatcher matcher = MultiPatternMatcher::from_regex({c.regex});
+        EXPECT_EQ(matcher.matches(c.line), c.expected) << "regex: " << c.regex << " line: " << c.line;
+    }
+
+    // Several expressions compile into one automaton
+    MultiPatternMatcher combined = MultiPatternMatcher::from_regex({"^ERROR", "timeout$", "code=4\\d\\d"});
+    EXPECT_TRUE(combined.matches("ERROR disk full"));
+    EXPECT_TRUE(combined.matches("upstream timeout"));
+    EXPECT_TRUE(combined.matches("GET / code=404"));
+    EXPECT_FALSE(combined.matches("INFO timeout reached code=200"));
+}
+
+TEST(MultiPatternMatcherTest, RegexRejectsInvalidSyntax) {
+    for (const char* regex : {"(abc", "abc)", "[abc", "*a", "a\\", "[z-a]"}) {
+        EXPECT_THROW(MultiPatternMatcher::from_regex({regex}), std::invalid_argument) << regex;
+    }
+}
+
+TEST_F(GrepTest, MatcherReusedAcrossBuffersAndFiles) {
+    MultiPatternMatcher matcher = MultiPatternMatcher::from_literals({"first", "Pattern"});
+
+    std::stringstream from_file;
+    EXPECT_TRUE(grep_file_mmap(matcher, test_file, from_file, true));
+    EXPECT_EQ(from_file.str(), "1:This is the first line\n4:Pattern appears here too\n");
+
+    const std::string text = "no\nfirst\nPattern\n";
+    std::stringstream from_buffer;
+    EXPECT_TRUE(grep_buffer(matcher, text.data(), text.size(), from_buffer, true));
+    EXPECT_EQ(from_buffer.str(), "2:first\n3:Pattern\n");
+
+    MultiPatternMatcher regex = MultiPatternMatcher::from_regex({"^(This|Final) .*line$"});
+    std::stringstream serial;
+    std::stringstream parallel;
+    EXPECT_TRUE(grep_file_mmap(regex, test_file, serial, true));
+    EXPECT_TRUE(grep_files_parallel(regex, {test_file}, parallel, true, 3, 16));
+    EXPECT_EQ(serial.str(), "1:This is the first line\n5:Final line\n");
+    EXPECT_EQ(parallel.str(), serial.str());
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
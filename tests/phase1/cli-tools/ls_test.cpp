@@ -20,6 +20,14 @@
  * - ListsEmptyDirectory: Tests behavior with an empty directory
  * - ListsSingleFile: Tests listing a single file
  * - HandlesNonExistentPath: Tests error handling for non-existent paths
+ * - RecursiveListsAllPathsSorted: walk_directory_tree prints every nested path in byte order
+ * - RecursiveParallelUnsortedListsSamePaths: Unsorted multi-threaded walks list the same set of paths
+ * - RecursiveHandlesNonExistentPath: The recursive walk reports a missing root
+ * - LongFormatShowsModeSizeAndLinks: -l lines carry the permission string, size and link target
+ * - SortsBySizeAndMtime: Size and mtime orders are largest/newest first with ties broken by name
+ * - LongFormatParallelStatMatchesSerial: Batched statx on several threads prints the same listing
+ * - DetailedHandlesNonExistentPath: list_directory_detailed reports a missing path
+ * - DetailedReportsStatErrorReason: Other statx failures (here ELOOP) carry strerror, not "does not exist"
  */
 
 #include "gtest/gtest.h"
@@ -28,7 +36,10 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <cerrno>
+#include <cstring>
 
 // Helper function to split string by newline
 std::vector<std::string> split_lines(const std::string& str) {
@@ -110,6 +121,176 @@ TEST(LsSimpleTest, HandlesNonExistentPath) {
     EXPECT_FALSE(success);
 }
 
+TEST_F(LsTest, RecursiveListsAllPathsSorted) {
+    std::filesystem::create_directories(test_dir / "subdir_b" / "deep");
+    std::ofstream(test_dir / "subdir_b" / "inner.txt").close();
+    std::ofstream(test_dir / "subdir_b" / "deep" / "leaf.txt").close();
+    std::filesystem::create_directory(test_dir / ".hidden");
+
+    std::stringstream ss;
+    WalkStats stats;
+    bool success = walk_directory_tree(test_dir, ss, WalkOptions(), &stats);
+
+    const std::string root = test_dir.string();
+    std::vector<std::string> expected = {
+        root + "/.hidden",
+        root + "/file_a.txt",
+        root + "/file_z.txt",
+        root + "/subdir_b",
+        root + "/subdir_b/deep",
+        root + "/subdir_b/deep/leaf.txt",
+        root + "/subdir_b/inner.txt",
+    };
+    EXPECT_EQ(split_lines(ss.str()), expected);
+    EXPECT_TRUE(success);
+    EXPECT_EQ(stats.entries, 7u);
+    EXPECT_EQ(stats.directories, 4u);
+    EXPECT_EQ(stats.errors, 0u);
+}
+
+TEST_F(LsTest, RecursiveParallelUnsortedListsSamePaths) {
+    // A tree wide and deep enough for the workers to steal from each other
+    for (int a = 0; a < 6; ++a) {
+        for (int b = 0; b < 6; ++b) {
+            auto dir = test_dir / ("d" + std::to_string(a)) / ("e" + std::to_string(b));
+            std::filesystem::create_directories(dir);
+            for (int f = 0; f < 5; ++f) {
+                std::ofstream(dir / ("f" + std::to_string(f))).close();
+            }
+        }
+    }
+
+    std::stringstream sorted_out;
+    ASSERT_TRUE(walk_directory_tree(test_dir, sorted_out));
+    std::vector<std::string> expected = split_lines(sorted_out.str());
+    ASSERT_EQ(expected.size(), 3u + 6u + 36u + 180u);
+
+    for (size_t threads : {1u, 2u, 4u, 8u}) {
+        std::stringstream ss;
+        EXPECT_TRUE(walk_directory_tree(test_dir, ss, WalkOptions{threads, false}));
+        std::vector<std::string> lines = split_lines(ss.str());
+        std::sort(lines.begin(), lines.end());
+        EXPECT_EQ(lines, expected) << threads << " threads";
+
+        std::stringstream sorted_parallel;
+        EXPECT_TRUE(walk_directory_tree(test_dir, sorted_parallel, WalkOptions{threads, true}));
+        EXPECT_EQ(sorted_parallel.str(), sorted_out.str()) << threads << " threads";
+    }
+}
+
+TEST(LsSimpleTest, RecursiveHandlesNonExistentPath) {
+    std::stringstream ss;
+    bool success = walk_directory_tree("non_existent_dir_12345", ss);
+
+    auto lines = split_lines(ss.str());
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_EQ(lines[0], "Error: Path does not exist.");
+    EXPECT_FALSE(success);
+}
+
+TEST_F(LsTest, LongFormatShowsModeSizeAndLinks) {
+    std::ofstream(test_dir / "file_a.txt") << "hello";
+    std::filesystem::permissions(test_dir / "file_a.txt", std::filesystem::perms::owner_read |
+                                 std::filesystem::perms::owner_write | std::filesystem::perms::group_read);
+    std::filesystem::create_symlink("file_a.txt", test_dir / "link");
+
+    std::stringstream ss;
+    ListOptions options;
+    options.long_format = true;
+    EXPECT_TRUE(list_directory_detailed(test_dir, ss, options));
+
+    auto lines = split_lines(ss.str());
+    ASSERT_EQ(lines.size(), 5u);
+    EXPECT_EQ(lines[0].rfind("total ", 0), 0u);
+    EXPECT_EQ(lines[1].substr(0, 10), "-rw-r-----");
+    EXPECT_NE(lines[1].find(" 5 "), std::string::npos);
+    EXPECT_EQ(lines[1].substr(lines[1].size() - 11), " file_a.txt");
+    EXPECT_EQ(lines[2].substr(lines[2].size() - 11), " file_z.txt");
+    EXPECT_EQ(lines[3][0], 'l');
+    EXPECT_EQ(lines[3].substr(lines[3].size() - 19), " link -> file_a.txt");
+    EXPECT_EQ(lines[4][0], 'd');
+    EXPECT_EQ(lines[4].substr(lines[4].size() - 9), " subdir_b");
+
+    // Columns line up: every name starts at the same offset after the date
+    EXPECT_EQ(lines[1].find("file_a.txt"), lines[2].find("file_z.txt"));
+}
+
+TEST_F(LsTest, SortsBySizeAndMtime) {
+    auto dir = test_dir / "sorted";
+    std::filesystem::create_directory(dir);
+    const auto now = std::filesystem::file_time_type::clock::now();
+    const struct {
+        const char* name;
+        size_t size;
+        int age_hours;
+    } files[] = {{"b_small", 1, 1}, {"a_large", 300, 3}, {"c_medium", 20, 2}, {"d_medium", 20, 4}};
+    for (const auto& file : files) {
+        std::ofstream(dir / file.name) << std::string(file.size, 'x');
+        std::filesystem::last_write_time(dir / file.name, now - std::chrono::hours(file.age_hours));
+    }
+
+    std::stringstream by_size;
+    EXPECT_TRUE(list_directory_detailed(dir, by_size, ListOptions{false, SortOrder::Size, 1}));
+    EXPECT_EQ(split_lines(by_size.str()),
+              (std::vector<std::string>{"a_large", "c_medium", "d_medium", "b_small"}));
+
+    std::stringstream by_mtime;
+    EXPECT_TRUE(list_directory_detailed(dir, by_mtime, ListOptions{false, SortOrder::Mtime, 1}));
+    EXPECT_EQ(split_lines(by_mtime.str()),
+              (std::vector<std::string>{"b_small", "c_medium", "a_large", "d_medium"}));
+
+    std::stringstream by_name;
+    EXPECT_TRUE(list_directory_detailed(dir, by_name, ListOptions{false, SortOrder::Name, 1}));
+    EXPECT_EQ(split_lines(by_name.str()),
+              (std::vector<std::string>{"a_large", "b_small", "c_medium", "d_medium"}));
+}
+
+TEST_F(LsTest, LongFormatParallelStatMatchesSerial) {
+    // Several statx batches
+    auto dir = test_dir / "many";
+    std::filesystem::create_directory(dir);
+    for (int i = 0; i < 2000; ++i) {
+        std::ofstream(dir / ("f" + std::to_string(i))) << std::string(i % 97, 'x');
+    }
+
+    std::stringstream serial;
+    ASSERT_TRUE(list_directory_detailed(dir, serial, ListOptions{true, SortOrder::Size, 1}));
+    EXPECT_EQ(split_lines(serial.str()).size(), 2001u);
+    for (size_t threads : {2u, 4u, 0u}) {
+        std::stringstream parallel;
+        EXPECT_TRUE(list_directory_detailed(dir, parallel, ListOptions{true, SortOrder::Size, threads}));
+        EXPECT_EQ(parallel.str(), serial.str()) << threads << " threads";
+    }
+}
+
+TEST(LsSimpleTest, DetailedHandlesNonExistentPath) {
+    std::stringstream ss;
+    ListOptions options;
+    options.long_format = true;
+    bool success = list_directory_detailed("non_existent_dir_12345", ss, options);
+
+    auto lines = split_lines(ss.str());
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_EQ(lines[0], "Error: Path does not exist.");
+    EXPECT_FALSE(success);
+}
+
+TEST_F(LsTest, DetailedReportsStatErrorReason) {
+    // Two symlinks pointing at each other: statx fails with ELOOP
+    std::filesystem::create_symlink("loop_b", test_dir / "loop_a");
+    std::filesystem::create_symlink("loop_a", test_dir / "loop_b");
+
+    std::stringstream ss;
+    ListOptions options;
+    options.long_format = true;
+    const std::filesystem::path path = test_dir / "loop_a";
+    EXPECT_FALSE(list_directory_detailed(path, ss, options));
+
+    auto lines = split_lines(ss.str());
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0], "Error: Could not access: " + path.string() + " (" + std::strerror(ELOOP) + ")");
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
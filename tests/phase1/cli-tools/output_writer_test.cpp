@@ -0,0 +1,132 @@
+/*
+ * output_writer_test.cpp - Unit tests for the buffered output sink
+ *
+ * How to run these tests:
+ *
+ * 1. Build the project:
+ *    mkdir -p build && cd build && cmake .. && make
+ *
+ * 2. Run all tests:
+ *    ctest
+ *
+ * 3. Run the test executable directly:
+ *    ./tests/phase1/cli-tools/output_writer_test
+ *
+ * 4. Run a specific test case:
+ *    ./tests/phase1/cli-tools/output_writer_test --gtest_filter=OutputWriterTest.BatchesUntilFlush
+ *
+ * Test cases covered:
+ * - BatchesUntilFlush: Output reaches the target only on flush() with the WhenFull policy
+ * - StreamFlushHonoredOnSync: std::flush drains the buffer with the OnSync policy
+ * - EveryLineDrainsPerLine: Each completed line is handed over with the EveryLine policy
+ * - DrainsWhenBufferFills: A small buffer drains in capacity-sized batches without losing bytes
+ * - FileDescriptorModeWritesEverything: Mixed small and large writes arrive intact through a pipe
+ * - FlushesOnDestruction: Pending output is written when the writer goes out of scope
+ */
+
+#include "gtest/gtest.h"
+#include "output_writer.h"
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+TEST(OutputWriterTest, BatchesUntilFlush) {
+    std::ostringstream target;
+    OutputWriter writer(target, FlushPolicy::WhenFull);
+    writer.stream() << "line 1" << std::endl << "line 2\n" << std::flush;
+
+    EXPECT_EQ(target.str(), "");
+    EXPECT_EQ(writer.write_calls(), 0u);
+
+    EXPECT_TRUE(writer.flush());
+    EXPECT_EQ(target.str(), "line 1\nline 2\n");
+    EXPECT_EQ(writer.write_calls(), 1u);
+}
+
+TEST(OutputWriterTest, StreamFlushHonoredOnSync) {
+    std::ostringstream target;
+    OutputWriter writer(target, FlushPolicy::OnSync);
+    writer.stream() << "a\nb\n";
+    EXPECT_EQ(target.str(), "");
+
+    writer.stream() << std::flush;
+    EXPECT_EQ(target.str(), "a\nb\n");
+}
+
+TEST(OutputWriterTest, EveryLineDrainsPerLine) {
+    std::ostringstream target;
+    OutputWriter writer(target, FlushPolicy::EveryLine);
+    writer.stream() << "partial";
+    EXPECT_EQ(target.str(), "");
+
+    writer.stream() << " line\n";
+    EXPECT_EQ(target.str(), "partial line\n");
+
+    writer.stream() << 42 << '\n';
+    EXPECT_EQ(target.str(), "partial line\n42\n");
+}
+
+TEST(OutputWriterTest, DrainsWhenBufferFills) {
+    std::ostringstream target;
+    std::string expected;
+    {
+        OutputWriter writer(target, FlushPolicy::WhenFull, 16);
+        for (int i = 0; i < 100; ++i) {
+            std::string line = "entry " + std::to_string(i) + "\n";
+            writer.stream() << line;
+            expected += line;
+        }
+        EXPECT_LT(writer.write_calls(), 100u);
+        EXPECT_GT(writer.write_calls(), 1u);
+    }
+    EXPECT_EQ(target.str(), expected);
+}
+
+TEST(OutputWriterTest, FileDescriptorModeWritesEverything) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    // Drain the pipe concurrently so large writes cannot block
+    std::string received;
+    std::thread reader([&] {
+        char chunk[4096];
+        ssize_t n;
+        while ((n = read(fds[0], chunk, sizeof(chunk))) > 0) {
+            received.append(chunk, static_cast<size_t>(n));
+        }
+    });
+
+    std::string expected;
+    {
+        OutputWriter writer(fds[1], FlushPolicy::WhenFull, 1024);
+        for (int i = 0; i < 200; ++i) {
+            std::string line = std::to_string(i) + ":small\n";
+            writer.stream() << line;
+            expected += line;
+            if (i % 50 == 0) {
+                // Larger than half the buffer: goes out through writev
+                std::string big(3000, static_cast<char>('a' + i % 26));
+                big += '\n';
+                writer.stream() << big;
+                expected += big;
+            }
+        }
+        EXPECT_TRUE(writer.flush());
+        EXPECT_FALSE(writer.failed());
+    }
+    close(fds[1]);
+    reader.join();
+    close(fds[0]);
+
+    EXPECT_EQ(received, expected);
+}
+
+TEST(OutputWriterTest, FlushesOnDestruction) {
+    std::ostringstream target;
+    {
+        OutputWriter writer(target, FlushPolicy::WhenFull);
+        writer.stream() << "pending";
+    }
+    EXPECT_EQ(target.str(), "pending");
+}
@@ -0,0 +1,196 @@
+/*
+ * utf8_test.cpp - Unit tests for UTF-8 validation and code point counting
+ *
+ * How to run these tests:
+ *
+ * 1. Build the project:
+ *    mkdir -p build && cd build && cmake .. && make
+ *
+ * 2. Run all tests:
+ *    ctest
+ *
+ * 3. Run the test executable directly:
+ *    ./tests/phase1/cli-tools/utf8_test
+ *
+ * 4. Run a specific test case:
+ *    ./tests/phase1/cli-tools/utf8_test --gtest_filter=Utf8Test.CountsValidSequences
+ *
+ * Test cases covered:
+ * - CountsValidSequences: ASCII and 2-, 3- and 4-byte sequences count one code point each
+ * - ReportsInvalidSequences: Overlong forms, surrogates, out-of-range and stray bytes are errors
+ * - MatchesReferenceDecoder: Random valid and corrupted text agrees with a byte-by-byte decoder,
+ *   across vector block and run boundaries
+ * - SplitInvariant: Decoding in two pieces gives the same counts at every split point
+ * - WcCountsCodePoints: wc_text and wc_parallel report code points and invalid sequences
+ */
+
+#include "gtest/gtest.h"
+#include "utf8.h"
+#include "wc.h"
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+
+Utf8Counts count_all(const std::string& text) {
+    Utf8State state;
+    Utf8Counts counts = count_utf8(text.data(), text.size(), state);
+    counts.invalid += finish_utf8(state).invalid;
+    return counts;
+}
+
+// Byte-by-byte decoder: one error per maximal invalid subpart
+Utf8Counts reference_counts(const std::string& text) {
+    Utf8Counts counts;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    size_t i = 0;
+    while (i < text.size()) {
+        const unsigned char b = p[i];
+        size_t need = 0;
+        unsigned char lo = 0x80, hi = 0xBF;
+        if (b < 0x80) {
+            ++counts.code_points;
+            ++i;
+            continue;
+        } else if (b >= 0xC2 && b <= 0xDF) {
+            need = 1;
+        } else if (b >= 0xE0 && b <= 0xEF) {
+            need = 2;
+            lo = b == 0xE0 ? 0xA0 : 0x80;
+            hi = b == 0xED ? 0x9F : 0xBF;
+        } else if (b >= 0xF0 && b <= 0xF4) {
+            need = 3;
+            lo = b == 0xF0 ? 0x90 : 0x80;
+            hi = b == 0xF4 ? 0x8F : 0xBF;
+        } else {
+            ++counts.invalid;
+            ++i;
+            continue;
+        }
+        size_t k = 1;
+        for (; k <= need && i + k < text.size(); ++k) {
+            if (p[i + k] < lo || p[i + k] > hi) {
+                break;
+            }
+            lo = 0x80;
+            hi = 0xBF;
+        }
+        if (k > need) {
+            ++counts.code_points;
+        } else {
+            ++counts.invalid;
+        }
+        i += k;
+    }
+    return counts;
+}
+
+// Mostly valid text built from ASCII, Latin, CJK and emoji, with occasional corruption
+std::string make_text(size_t target, unsigned seed, bool corrupt) {
+    static const char* const pieces[] = {"a", "word ", "\n", "\xC3\xA9", "\xE4\xB8\xAD", "\xE6\x96\x87",
+                                         "\xF0\x9F\x98\x80", "\xD0\x96"};
+    static const char* const bad[] = {"\x80", "\xC0\xAF", "\xE0\x80\x80", "\xED\xA0\x80",
+                                      "\xF4\x90\x80\x80", "\xF5", "\xE4\xB8", "\xFF"};
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> pick(0, 7);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::string text;
+    while (text.size() < target) {
+        text += corrupt && percent(rng) < 2 ? bad[pick(rng)] : pieces[pick(rng)];
+    }
+    return text;
+}
+
+} // anonymous namespace
+
+TEST(Utf8Test, CountsValidSequences) {
+    Utf8Counts counts = count_all("abc \xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80");
+    EXPECT_EQ(counts.code_points, 7u);
+    EXPECT_EQ(counts.invalid, 0u);
+
+    EXPECT_EQ(count_all("").code_points, 0u);
+    // Boundary code points: U+0080, U+07FF, U+0800, U+FFFF, U+10000, U+10FFFF
+    counts = count_all("\xC2\x80\xDF\xBF\xE0\xA0\x80\xEF\xBF\xBF\xF0\x90\x80\x80\xF4\x8F\xBF\xBF");
+    EXPECT_EQ(counts.code_points, 6u);
+    EXPECT_EQ(counts.invalid, 0u);
+}
+
+TEST(Utf8Test, ReportsInvalidSequences) {
+    struct Case {
+        const char* text;
+        uint64_t code_points;
+        uint64_t invalid;
+    };
+    const Case cases[] = {
+        {"\x80", 0, 1},                  // Stray continuation byte
+        {"\xC0\xAF", 0, 2},              // Overlong lead byte, then a stray continuation
+        {"\xE0\x80\x80", 0, 3},          // Overlong 3-byte form
+        {"\xED\xA0\x80", 0, 3},          // Surrogate
+        {"\xF4\x90\x80\x80", 0, 4},      // Above U+10FFFF
+        {"\xF5\x80", 0, 2},              // Invalid lead byte
+        {"\xE4\xB8", 0, 1},              // Truncated at end of input
+        {"\xE4\xB8" "a", 1, 1},          // Truncated by an ASCII byte
+        {"a\xF0\x9F\x98" "b\xFF", 2, 2}, // Truncated 4-byte sequence and an invalid byte
+    };
+    for (const Case& c : cases) {
+        Utf8Counts counts = count_all(c.text);
+        EXPECT_EQ(counts.code_points, c.code_points) << "input " << ::testing::PrintToString(c.text);
+        EXPECT_EQ(counts.invalid, c.invalid) << "input " << ::testing::PrintToString(c.text);
+    }
+}
+
+TEST(Utf8Test, MatchesReferenceDecoder) {
+    for (size_t size : {1u, 31u, 32u, 33u, 100u, 4095u, 4097u, 20000u}) {
+        for (unsigned seed = 0; seed < 3; ++seed) {
+            for (bool corrupt : {false, true}) {
+                std::string text = make_text(size, seed, corrupt);
+                Utf8Counts expected = reference_counts(text);
+                Utf8Counts counts = count_all(text);
+                EXPECT_EQ(counts.code_points, expected.code_points) << "size " << size << " seed " << seed;
+                EXPECT_EQ(counts.invalid, expected.invalid) << "size " << size << " seed " << seed;
+            }
+        }
+    }
+}
+
+TEST(Utf8Test, SplitInvariant) {
+    std::string text = make_text(300, 9, true);
+    Utf8Counts expected = reference_counts(text);
+    for (size_t split = 0; split <= text.size(); ++split) {
+        Utf8State state;
+        Utf8Counts first = count_utf8(text.data(), split, state);
+        Utf8Counts second = count_utf8(text.data() + split, text.size() - split, state);
+        Utf8Counts end = finish_utf8(state);
+        EXPECT_EQ(first.code_points + second.code_points, expected.code_points) << "split " << split;
+        EXPECT_EQ(first.invalid + second.invalid + end.invalid, expected.invalid) << "split " << split;
+    }
+}
+
+TEST(Utf8Test, WcCountsCodePoints) {
+    WcResult result = wc_text("h\xC3\xA9llo w\xC3\xB6rld\n\xE4\xB8\xAD\xE6\x96\x87\xFF\n", true);
+    EXPECT_EQ(result.lines, 2u);
+    EXPECT_EQ(result.words, 3u);
+    EXPECT_EQ(result.characters, 22u);
+    EXPECT_EQ(result.code_points, 15u);
+    EXPECT_EQ(result.invalid_utf8, 1u);
+
+    // Byte mode leaves the code point fields alone
+    EXPECT_EQ(wc_text("\xC3\xA9").code_points, 0u);
+
+    // Chunks far smaller than a sequence still count every code point once
+    std::string text = make_text(5000, 3, true);
+    auto path = std::filesystem::temp_directory_path() / "utf8_test_wc.txt";
+    std::ofstream(path, std::ios::binary) << text;
+    std::stringstream errors;
+    for (size_t chunk_size : {1u, 2u, 5u, 333u}) {
+        WcResult parallel = wc_parallel({path}, errors, 3, chunk_size, true).at(0);
+        WcResult serial = wc_text(text, true);
+        EXPECT_EQ(parallel.code_points, serial.code_points) << "chunk " << chunk_size;
+        EXPECT_EQ(parallel.invalid_utf8, serial.invalid_utf8) << "chunk " << chunk_size;
+        EXPECT_EQ(parallel.words, serial.words) << "chunk " << chunk_size;
+    }
+    std::filesystem::remove(path);
+}
@@ -22,6 +22,14 @@
  * - CountsCharactersOnly: Tests wc with -c option
  * - HandlesEmptyFile: Tests behavior with an empty file
  * - HandlesNonExistentFile: Tests error handling for non-existent files
+ * - KernelMatchesStreamExtraction: The vectorized counter agrees with std::count and operator>>
+ *   on random text containing every whitespace byte
+ * - CounterIsSplitInvariant: Feeding the input in pieces gives the same counts as one piece
+ * - MergeMatchesWholeText: wc_merge of the two halves equals wc_text of the whole, at every split
+ * - MergeIsAssociative: Merging three pieces in either grouping gives the same result
+ * - ParallelMatchesSerial: wc_parallel over small chunks and many threads equals wc_text exactly
+ * - ParallelReportsMissingFileAndContinues: A missing file fails alone and is reported
+ * - ParallelCountsMoreFilesThanDescriptorLimit: Files are opened per chunk, not all up front
  */
 
 #include "gtest/gtest.h"
@@ -30,6 +38,10 @@
 #include <string>
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <sys/resource.h>
 
 class WcTest : public ::testing::Test {
 protected:
@@ -114,6 +126,169 @@ TEST(WcTextTest, CountsLinesWordsCharactersNoTrailingNewline) {
     EXPECT_EQ(result.characters, 49);
 }
 
+namespace {
+
+// Random text mixing words, every whitespace byte and high-bit bytes
+std::string make_random_text(size_t size, unsigned seed) {
+    static const char alphabet[] = "ab xyz\t\n\v\f\r  \n\x80\xff-09";
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 2);
+    std::string text(size, ' ');
+    for (char& c : text) {
+        c = alphabet[pick(rng)];
+    }
+    return text;
+}
+
+// Reference counts computed the way wc_text used to
+WcResult reference_counts(const std::string& text) {
+    WcResult result;
+    result.characters = text.size();
+    result.lines = std::count(text.begin(), text.end(), '\n');
+    if (!text.empty() && text.back() != '\n') {
+        result.lines++;
+    }
+    std::istringstream stream(text);
+    std::string word;
+    while (stream >> word) {
+        result.words++;
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+TEST(WcTextTest, KernelMatchesStreamExtraction) {
+    for (size_t size : {0u, 1u, 63u, 64u, 65u, 127u, 1000u, 4099u}) {
+        for (unsigned seed = 0; seed < 4; ++seed) {
+            std::string text = make_random_text(size, seed);
+            WcResult expected = reference_counts(text);
+            WcResult result = wc_text(text);
+            EXPECT_EQ(result.lines, expected.lines) << "size " << size << " seed " << seed;
+            EXPECT_EQ(result.words, expected.words) << "size " << size << " seed " << seed;
+            EXPECT_EQ(result.characters, expected.characters);
+        }
+    }
+}
+
+TEST(WcTextTest, CounterIsSplitInvariant) {
+    std::string text = make_random_text(5000, 7);
+    WcResult whole = wc_text(text);
+
+    for (size_t piece : {1u, 3u, 64u, 100u, 4096u}) {
+        WcCounter counter;
+        for (size_t pos = 0; pos < text.size(); pos += piece) {
+            counter.update(text.data() + pos, std::min(piece, text.size() - pos));
+        }
+        WcResult result = counter.result();
+        EXPECT_EQ(result.lines, whole.lines) << "piece " << piece;
+        EXPECT_EQ(result.words, whole.words) << "piece " << piece;
+        EXPECT_EQ(result.characters, whole.characters) << "piece " << piece;
+    }
+}
+
+namespace {
+
+void expect_same_result(const WcResult& actual, const WcResult& expected, const std::string& context) {
+    EXPECT_EQ(actual.lines, expected.lines) << context;
+    EXPECT_EQ(actual.words, expected.words) << context;
+    EXPECT_EQ(actual.characters, expected.characters) << context;
+    EXPECT_EQ(actual.success, expected.success) << context;
+    EXPECT_EQ(actual.starts_in_word, expected.starts_in_word) << context;
+    EXPECT_EQ(actual.ends_in_word, expected.ends_in_word) << context;
+    EXPECT_EQ(actual.ends_with_newline, expected.ends_with_newline) << context;
+}
+
+} // anonymous namespace
+
+TEST(WcMergeTest, MergeMatchesWholeText) {
+    for (unsigned seed = 0; seed < 3; ++seed) {
+        std::string text = make_random_text(300, seed);
+        WcResult whole = wc_text(text);
+        for (size_t split = 0; split <= text.size(); ++split) {
+            WcResult merged = wc_merge(wc_text(text.substr(0, split)), wc_text(text.substr(split)));
+            expect_same_result(merged, whole, "split " + std::to_string(split));
+        }
+    }
+}
+
+TEST(WcMergeTest, MergeIsAssociative) {
+    std::string text = "one two\nthree four\n\nfive";
+    for (size_t a = 0; a <= text.size(); ++a) {
+        for (size_t b = a; b <= text.size(); ++b) {
+            WcResult x = wc_text(text.substr(0, a));
+            WcResult y = wc_text(text.substr(a, b - a));
+            WcResult z = wc_text(text.substr(b));
+            expect_same_result(wc_merge(wc_merge(x, y), z), wc_merge(x, wc_merge(y, z)),
+                               "splits " + std::to_string(a) + "," + std::to_string(b));
+        }
+    }
+}
+
+TEST_F(WcTest, ParallelMatchesSerial) {
+    std::vector<std::filesystem::path> files;
+    std::vector<std::string> contents;
+    for (unsigned seed = 0; seed < 4; ++seed) {
+        contents.push_back(make_random_text(1000 + seed * 777, seed));
+        files.push_back(test_dir / ("random" + std::to_string(seed) + ".txt"));
+        std::ofstream(files.back(), std::ios::binary) << contents.back();
+    }
+    contents.push_back("");
+    files.push_back(test_dir / "empty.txt");
+    std::ofstream(files.back()).close();
+
+    for (size_t chunk_size : {1u, 7u, 64u, 1000u, 0u}) {
+        std::stringstream errors;
+        std::vector<WcResult> results = wc_parallel(files, errors, 4, chunk_size);
+        ASSERT_EQ(results.size(), files.size());
+        for (size_t i = 0; i < files.size(); ++i) {
+            expect_same_result(results[i], wc_text(contents[i]),
+                               files[i].filename().string() + " chunk " + std::to_string(chunk_size));
+        }
+        EXPECT_EQ(errors.str(), "");
+    }
+}
+
+TEST_F(WcTest, ParallelReportsMissingFileAndContinues) {
+    std::stringstream errors;
+    std::vector<WcResult> results = wc_parallel({test_dir / "missing.txt", test_file}, errors, 2, 16);
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_FALSE(results[0].success);
+    EXPECT_EQ(results[0].lines, 0u);
+    EXPECT_TRUE(results[1].success);
+    EXPECT_EQ(results[1].lines, 3u);
+    EXPECT_EQ(results[1].words, 18u);
+    EXPECT_EQ(results[1].characters, 86u);
+    EXPECT_NE(errors.str().find("Error: File does not exist"), std::string::npos);
+}
+
+TEST_F(WcTest, ParallelCountsMoreFilesThanDescriptorLimit) {
+    std::vector<std::filesystem::path> files;
+    for (int i = 0; i < 300; ++i) {
+        files.push_back(test_dir / ("many" + std::to_string(i) + ".txt"));
+        std::ofstream(files.back()) << "a b\nc\n";
+    }
+
+    // Fewer descriptors than files; restored before any assertion can bail out
+    struct rlimit saved;
+    ASSERT_EQ(::getrlimit(RLIMIT_NOFILE, &saved), 0);
+    struct rlimit limited = saved;
+    limited.rlim_cur = std::min<rlim_t>(saved.rlim_cur, 64);
+    ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &limited), 0);
+    std::stringstream errors;
+    std::vector<WcResult> results = wc_parallel(files, errors, 2, 2);
+    ::setrlimit(RLIMIT_NOFILE, &saved);
+
+    EXPECT_EQ(errors.str(), "");
+    ASSERT_EQ(results.size(), files.size());
+    for (const WcResult& result : results) {
+        EXPECT_TRUE(result.success);
+        EXPECT_EQ(result.lines, 2u);
+        EXPECT_EQ(result.words, 3u);
+    }
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
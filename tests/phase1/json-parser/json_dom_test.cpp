@@ -0,0 +1,167 @@
+/**
+ * @file json_dom_test.cpp
+ * @brief Unit tests for the zero-copy, arena-backed JSON DOM parser.
+ */
+
+#include "json.h"
+#include "json_dom.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <variant>
+
+// Test to check that scalars parse and accessors enforce the node type
+TEST(JsonDomTest, ParsesScalars) {
+    EXPECT_TRUE(parse_json_document("null").root().is_null());
+    EXPECT_TRUE(parse_json_document(" true ").root().as_bool());
+    EXPECT_FALSE(parse_json_document("false").root().as_bool());
+    EXPECT_DOUBLE_EQ(parse_json_document("-12.5e1").root().as_number(), -125.0);
+    EXPECT_EQ(parse_json_document("\"text\"").root().as_string(), "text");
+
+    JsonDocument document = parse_json_document("42");
+    EXPECT_THROW(document.root().as_string(), std::bad_variant_access);
+    EXPECT_EQ(document.root().size(), 0u);
+}
+
+// Test to check that integers beyond 2^53 keep every digit
+TEST(JsonDomTest, KeepsExactIntegers) {
+    JsonDocument document = parse_json_document("[9007199254740993, -9223372036854775808, 1.0, -0, 1e2, "
+                                                "9223372036854775808]");
+    const JsonNode& root = document.root();
+    EXPECT_TRUE(root[0].is_integer());
+    EXPECT_EQ(root[0].as_int64(), 9007199254740993);
+    EXPECT_EQ(root[1].as_int64(), INT64_MIN);
+    EXPECT_DOUBLE_EQ(root[0].as_number(), 9007199254740992.0);
+    for (size_t i = 2; i < root.size(); ++i) {
+        EXPECT_TRUE(root[i].is_number());
+        EXPECT_FALSE(root[i].is_integer()) << i;
+        EXPECT_THROW(root[i].as_int64(), std::bad_variant_access);
+    }
+    EXPECT_EQ(root.to_value()[0].as_int64(), 9007199254740993);
+}
+
+// Test to check that unescaped strings are views into the input
+TEST(JsonDomTest, StringsWithoutEscapesPointIntoInput) {
+    std::string text = R"({"key": "value", "escaped": "a\"b"})";
+    JsonDocument document = parse_json_document(text);
+    const JsonNode& root = document.root();
+
+    std::string_view key = root.as_object()[0].key;
+    std::string_view value = root["key"].as_string();
+    EXPECT_EQ(key.data(), text.data() + 2);
+    EXPECT_EQ(value.data(), text.data() + 9);
+    EXPECT_EQ(value, "value");
+
+    // Escaped strings are unescaped into the arena
+    std::string_view escaped = root["escaped"].as_string();
+    EXPECT_EQ(escaped, "a\"b");
+    EXPECT_TRUE(escaped.data() < text.data() || escaped.data() >= text.data() + text.size());
+}
+
+// Test to check that objects keep members in document order and look up keys
+TEST(JsonDomTest, ObjectsAreFlatMemberArrays) {
+    JsonDocument document = parse_json_document(R"({"b": 1, "a": [true, null, {"x": "y"}], "b": 2})");
+    const JsonNode& root = document.root();
+
+    ASSERT_EQ(root.size(), 3u);
+    EXPECT_EQ(root.as_object()[0].key, "b");
+    EXPECT_EQ(root.as_object()[1].key, "a");
+    // The last duplicate wins, as in parse_json
+    EXPECT_DOUBLE_EQ(root["b"].as_number(), 2.0);
+    EXPECT_EQ(root.find("missing"), nullptr);
+    EXPECT_THROW(root["missing"], std::out_of_range);
+
+    const JsonNode& array = root["a"];
+    ASSERT_EQ(array.size(), 3u);
+    EXPECT_TRUE(array[0].as_bool());
+    EXPECT_TRUE(array[1].is_null());
+    EXPECT_EQ(array[2]["x"].as_string(), "y");
+    EXPECT_THROW(array[3], std::out_of_range);
+}
+
+// Test to check that escapes, including \u and surrogate pairs, decode to UTF-8
+TEST(JsonDomTest, DecodesEscapes) {
+    JsonDocument document = parse_json_document(R"("tab\tnl\nq\"bs\\sl\/ \u00e9\u4e2d\ud83d\ude00")");
+    EXPECT_EQ(document.root().as_string(), "tab\tnl\nq\"bs\\sl/ \xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80");
+
+    // An unpaired surrogate becomes U+FFFD
+    EXPECT_EQ(parse_json_document(R"("\ud800x")").root().as_string(), "\xEF\xBF\xBDx");
+}
+
+// Test to check that converting back gives the same value as parse_json
+TEST(JsonDomTest, MatchesParseJson) {
+    std::string text = R"({"name": "John", "age": 30, "scores": [1.5, -2, 3e2], "nested": {"ok": true,
+                          "none": null, "list": [[], {}, ["a\nb"]]}})";
+    JsonDocument document = parse_json_document(text);
+    EXPECT_EQ(document.root().to_value().to_string(), parse_json(text).to_string());
+}
+
+// Test to check that malformed input throws like parse_json
+TEST(JsonDomTest, RejectsMalformedInput) {
+    for (const char* text : {"", "{", "[1,]", "{\"a\" 1}", "{\"a\":1,}", "\"open", "tru", "01x", "-", "1e",
+                             "[1] 2", "{1: 2}", "\"\\q\"", "\"\\u12g4\""}) {
+        EXPECT_THROW(parse_json_document(text), std::runtime_error) << text;
+    }
+    EXPECT_THROW(parse_json_document(std::string(2000, '[') + std::string(2000, ']')), std::runtime_error);
+}
+
+// Test to check that a memory-mapped file parses and outlives a move
+TEST(JsonDomTest, ParsesFromFile) {
+    auto path = std::filesystem::temp_directory_path() / "json_dom_test.json";
+    std::ofstream(path) << R"({"key": "value", "list": [1, 2, 3]})";
+
+    JsonDocument document;
+    {
+        JsonDocument parsed = parse_json_document_file(path.string());
+        document = std::move(parsed);
+    }
+    EXPECT_EQ(document.root()["key"].as_string(), "value");
+    EXPECT_EQ(document.root()["list"].size(), 3u);
+    EXPECT_THROW(parse_json_document_file("non_existent_file_12345.json"), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+// Test to check that the arena serves large and small requests and resets
+TEST(JsonDomTest, ArenaAllocatesAlignedBlocks) {
+    JsonArena arena(256);
+    auto* small = static_cast<char*>(arena.allocate(3, 1));
+    auto* aligned = arena.allocate_array<double>(4);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % alignof(double), 0u);
+    EXPECT_NE(static_cast<void*>(small), static_cast<void*>(aligned));
+
+    void* big = arena.allocate(10000);
+    EXPECT_NE(big, nullptr);
+    EXPECT_EQ(arena.bytes_used(), 3u + 4 * sizeof(double) + 10000u);
+
+    arena.reset();
+    EXPECT_EQ(arena.bytes_used(), 0u);
+    EXPECT_NE(arena.allocate(16), nullptr);
+}
+
+// Test to check that a moved-from arena does not hand out the target's memory
+TEST(JsonDomTest, MovedFromArenaStartsFresh) {
+    JsonArena source(256);
+    auto* first = static_cast<char*>(source.allocate(16, 1));
+    JsonArena target(std::move(source));
+    EXPECT_EQ(target.bytes_used(), 16u);
+    EXPECT_EQ(source.bytes_used(), 0u);
+
+    auto* from_source = static_cast<char*>(source.allocate(16, 1));
+    auto* from_target = static_cast<char*>(target.allocate(16, 1));
+    EXPECT_EQ(from_target, first + 16);
+    EXPECT_NE(from_source, from_target);
+    EXPECT_NE(from_source, first + 16);
+
+    JsonArena assigned;
+    assigned = std::move(target);
+    EXPECT_EQ(assigned.bytes_used(), 32u);
+    EXPECT_EQ(target.bytes_used(), 0u);
+    EXPECT_NE(static_cast<char*>(target.allocate(16, 1)), first + 32);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,128 @@
+/**
+ * @file json_msgpack_test.cpp
+ * @brief Unit tests for the MessagePack encoding of JsonValue and the in-place reader.
+ */
+
+#include "json.h"
+#include "json_msgpack.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace {
+
+std::string bytes_of(std::initializer_list<int> values) {
+    std::string out;
+    for (int v : values) {
+        out += static_cast<char>(v);
+    }
+    return out;
+}
+
+const std::string kConfig = R"({
+    "service": "billing", "port": 8443, "ratio": 0.75, "precise": 0.1, "debug": false, "owner": null,
+    "limits": {"rps": 1200, "burst": -40000, "big": 9007199254740993, "min": -9223372036854775808},
+    "hosts": ["a.internal", "b.internal", "a string that is definitely longer than thirty-one bytes"],
+    "nested": [[], {}, [[1, 2], {"k": "v"}]], "escaped": "tab\tquote\"newline\n"
+})";
+
+} // anonymous namespace
+
+// Test to check that encoding round-trips through parse_json's values
+TEST(JsonMsgPackTest, RoundTripsParseJson) {
+    for (const std::string& text : {kConfig, std::string("[]"), std::string("\"\""), std::string("-1.5e300"),
+                                    std::string("[true, false, null, 0, -32, -33, 127, 128, 255, 256, 65535, 65536]")}) {
+        JsonValue value = parse_json(text);
+        std::string encoded = encode_msgpack(value);
+        EXPECT_EQ(decode_msgpack(encoded).to_string(), value.to_string()) << text;
+        EXPECT_LT(encoded.size(), value.to_string().size() + 2) << text;
+    }
+
+    // Integers keep their exact value and doubles their exact bits
+    JsonValue decoded = decode_msgpack(encode_msgpack(parse_json(kConfig)));
+    EXPECT_EQ(decoded["limits"]["big"].as_int64(), 9007199254740993);
+    EXPECT_EQ(decoded["limits"]["min"].as_int64(), INT64_MIN);
+    EXPECT_EQ(decoded["precise"].as_number(), 0.1);
+    EXPECT_FALSE(decoded["ratio"].is_integer());
+}
+
+// Test to check the bytes against the MessagePack specification
+TEST(JsonMsgPackTest, UsesSmallestEncodings) {
+    EXPECT_EQ(encode_msgpack(JsonValue(nullptr)), bytes_of({0xc0}));
+    EXPECT_EQ(encode_msgpack(JsonValue(true)), bytes_of({0xc3}));
+    EXPECT_EQ(encode_msgpack(JsonValue(5)), bytes_of({0x05}));
+    EXPECT_EQ(encode_msgpack(JsonValue(-1)), bytes_of({0xff}));
+    EXPECT_EQ(encode_msgpack(JsonValue(-33)), bytes_of({0xd0, 0xdf}));
+    EXPECT_EQ(encode_msgpack(JsonValue(300)), bytes_of({0xd1, 0x01, 0x2c}));
+    EXPECT_EQ(encode_msgpack(JsonValue(1.5)), bytes_of({0xca, 0x3f, 0xc0, 0x00, 0x00}));
+    EXPECT_EQ(encode_msgpack(JsonValue(0.1)).size(), 9u);
+    EXPECT_EQ(encode_msgpack(JsonValue("hi")), bytes_of({0xa2, 'h', 'i'}));
+    EXPECT_EQ(encode_msgpack(JsonValue(std::string(40, 'x'))).substr(0, 2), bytes_of({0xd9, 40}));
+    EXPECT_EQ(encode_msgpack(parse_json(R"({"a": [1]})")), bytes_of({0x81, 0xa1, 'a', 0x91, 0x01}));
+
+    // Unsigned forms from other encoders are accepted
+    EXPECT_EQ(decode_msgpack(bytes_of({0xcd, 0x01, 0x00})).as_int64(), 256);
+    EXPECT_DOUBLE_EQ(decode_msgpack(bytes_of({0xcf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff})).as_number(),
+                     18446744073709551615.0);
+}
+
+// Test to check in-place navigation and zero-copy strings
+TEST(JsonMsgPackTest, NavigatesInPlace) {
+    const std::string encoded = encode_msgpack(parse_json(kConfig));
+    MsgPackView root(encoded);
+    ASSERT_TRUE(root.is_object());
+
+    std::string_view service = root["service"].as_string();
+    EXPECT_EQ(service, "billing");
+    EXPECT_GE(service.data(), encoded.data());
+    EXPECT_LT(service.data(), encoded.data() + encoded.size());
+
+    EXPECT_EQ(root["port"].as_int64(), 8443);
+    EXPECT_DOUBLE_EQ(root["ratio"].as_number(), 0.75);
+    EXPECT_EQ(root["limits"]["burst"].as_int64(), -40000);
+    EXPECT_EQ(root["hosts"].size(), 3u);
+    EXPECT_EQ(root["hosts"][2].as_string().size(), 56u);
+    EXPECT_EQ(root["nested"][2][1]["k"].as_string(), "v");
+    EXPECT_EQ(root["escaped"].as_string(), "tab\tquote\"newline\n");
+    EXPECT_TRUE(root["owner"].is_null());
+
+    MsgPackView missing(encoded);
+    EXPECT_FALSE(root.find("absent", missing));
+    EXPECT_THROW(root["absent"], std::out_of_range);
+    EXPECT_THROW(root["hosts"][3], std::out_of_range);
+    EXPECT_THROW(root["port"].as_string(), std::bad_variant_access);
+    EXPECT_THROW(root["ratio"].as_int64(), std::bad_variant_access);
+
+    std::vector<std::string> keys;
+    root.for_each_member([&](std::string_view key, const MsgPackView&) { keys.emplace_back(key); });
+    EXPECT_EQ(keys.size(), 10u);
+    EXPECT_EQ(keys.front(), "debug");
+
+    std::vector<std::string> hosts;
+    root["hosts"].for_each_element([&](const MsgPackView& host) { hosts.emplace_back(host.as_string()); });
+    EXPECT_EQ(hosts[1], "b.internal");
+
+    EXPECT_EQ(root["limits"].bytes(), encode_msgpack(parse_json(kConfig)["limits"]));
+    EXPECT_EQ(root["nested"].to_value().to_string(), R"([[],{},[[1,2],{"k":"v"}]])");
+}
+
+// Test to check that truncated or malformed data throws instead of reading past the end
+TEST(JsonMsgPackTest, RejectsMalformedData) {
+    const std::string encoded = encode_msgpack(parse_json(kConfig));
+    for (size_t length = 0; length < encoded.size(); ++length) {
+        EXPECT_THROW(decode_msgpack(std::string_view(encoded.data(), length)), std::runtime_error) << length;
+    }
+    EXPECT_THROW(decode_msgpack(encoded + '\x01'), std::runtime_error);
+    EXPECT_THROW(decode_msgpack(bytes_of({0xc1})), std::runtime_error);
+    EXPECT_THROW(decode_msgpack(bytes_of({0x81, 0x01, 0x02})), std::runtime_error);
+    EXPECT_THROW(decode_msgpack(bytes_of({0xdd, 0xff, 0xff, 0xff, 0xff})), std::runtime_error);
+    EXPECT_THROW(decode_msgpack(std::string(5000, '\x91') + '\xc0'), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,95 @@
+/**
+ * @file json_query_test.cpp
+ * @brief Unit tests for lazy JSON Pointer / path queries.
+ */
+
+#include "json.h"
+#include "json_query.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::string kRequest = R"({
+    "request": {
+        "method": "GET",
+        "headers": {"host": "example.com", "accept": "*/*", "x-trace": "a\"b"},
+        "body": {"items": [{"id": 1, "tags": ["a", "]", "}"]}, {"id": 2, "name": "second"}]}
+    },
+    "a/b": {"m~n": true},
+    "escaped": 3.5,
+    "dup": 1, "dup": 2
+})";
+
+} // anonymous namespace
+
+// Test to check that JSON Pointers reach nested members and elements
+TEST(JsonQueryTest, FindsByPointer) {
+    EXPECT_EQ(JsonPointer("/request/headers/host").find(kRequest), "\"example.com\"");
+    EXPECT_EQ(JsonPointer("/request/headers/host").find_string(kRequest), "example.com");
+    EXPECT_EQ(JsonPointer("/request/body/items/1/name").find_string(kRequest), "second");
+    EXPECT_EQ(JsonPointer("/request/body/items/0/tags").find(kRequest), R"(["a", "]", "}"])");
+    EXPECT_EQ(JsonPointer("/request/body/items/1/id").find(kRequest), "2");
+    EXPECT_EQ(JsonPointer("/a~1b/m~0n").find(kRequest), "true");
+    EXPECT_EQ(JsonPointer("/escaped").find(kRequest), "3.5");
+    EXPECT_EQ(JsonPointer("/dup").find(kRequest), "1");
+    EXPECT_EQ(JsonPointer("").find(" [1] "), "[1]");
+
+    // Strings with escapes are not handed out as raw views
+    EXPECT_EQ(JsonPointer("/request/headers/x-trace").find(kRequest), R"("a\"b")");
+    EXPECT_FALSE(JsonPointer("/request/headers/x-trace").find_string(kRequest));
+}
+
+// Test to check that missing paths give nullopt rather than throwing
+TEST(JsonQueryTest, MissingPathsAreEmpty) {
+    for (const char* pointer : {"/nope", "/request/headers/host/more", "/request/body/items/2",
+                                "/request/body/items/01", "/request/body/items/-", "/request/method/0",
+                                "/request/body/items/x"}) {
+        EXPECT_FALSE(JsonPointer(pointer).find(kRequest)) << pointer;
+    }
+    EXPECT_FALSE(JsonPointer("/a").find("{}"));
+    EXPECT_FALSE(JsonPointer("/0").find("[]"));
+}
+
+// Test to check dotted paths and conversion to JsonValue
+TEST(JsonQueryTest, PathsAndValues) {
+    JsonPointer path = JsonPointer::from_path("request.body.items[1].name");
+    EXPECT_EQ(path.tokens(), (std::vector<std::string>{"request", "body", "items", "1", "name"}));
+    EXPECT_EQ(path.find_string(kRequest), "second");
+    EXPECT_EQ(JsonPointer::from_path("[0][1]").find("[[5, 6]]"), "6");
+
+    std::optional<JsonValue> headers = JsonPointer::from_path("request.headers").get(kRequest);
+    ASSERT_TRUE(headers);
+    EXPECT_EQ(headers->as_object().at("accept").as_string(), "*/*");
+    EXPECT_EQ(JsonPointer("/request/body/items/0/id").get(kRequest)->as_int64(), 1);
+    EXPECT_FALSE(JsonPointer("/missing").get(kRequest));
+
+    // Escaped keys and values decode the same way
+    const char* escaped = R"({"caf\u00e9":{"name":"caf\u00e9"}})";
+    std::optional<JsonValue> name = JsonPointer("/caf\u00e9/name").get(escaped);
+    ASSERT_TRUE(name);
+    EXPECT_EQ(name->as_string(), "caf\u00e9");
+
+    for (const char* bad : {"a..b", "a.", "a[]", "a[0]b", ".a"}) {
+        EXPECT_THROW(JsonPointer::from_path(bad), std::runtime_error) << bad;
+    }
+    EXPECT_THROW(JsonPointer("a/b"), std::runtime_error);
+    EXPECT_THROW(JsonPointer("/a~2"), std::runtime_error);
+}
+
+// Test to check that malformed text on the path throws, while skipped subtrees are not parsed
+TEST(JsonQueryTest, ValidatesOnlyThePath) {
+    EXPECT_EQ(JsonPointer("/b").find(R"({"a": [1, 2 3 {]}, "b": 1})"), "1");
+
+    for (const char* text : {R"({"a" 1})", R"({"a": 1 "b": 2})", R"({"a": "open)", R"({"a": [1, 2)",
+                             R"({"b": tru})", R"({"b": 1.})", R"({"a": 1,)"}) {
+        EXPECT_THROW(JsonPointer("/b").find(text), std::runtime_error) << text;
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,201 @@
+/**
+ * @file json_sax_test.cpp
+ * @brief Unit tests for the streaming (SAX-style) JSON reader.
+ */
+
+#include "json.h"
+#include "json_sax.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Records every event as a short token
+class RecordingHandler : public JsonHandler {
+public:
+    std::vector<std::string> events;
+
+    bool on_null() override { events.push_back("null"); return true; }
+    bool on_bool(bool value) override { events.push_back(value ? "true" : "false"); return true; }
+    bool on_number(double value) override { events.push_back("#" + JsonValue(value).to_string()); return true; }
+    bool on_string(std::string_view value) override { events.push_back("s:" + std::string(value)); return true; }
+    bool on_key(std::string_view key) override { events.push_back("k:" + std::string(key)); return true; }
+    bool on_start_object() override { events.push_back("{"); return true; }
+    bool on_end_object() override { events.push_back("}"); return true; }
+    bool on_start_array() override { events.push_back("["); return true; }
+    bool on_end_array() override { events.push_back("]"); return true; }
+    bool on_end_document() override { events.push_back("$"); return true; }
+};
+
+// Rebuilds a JsonValue from the events, for comparison with parse_json
+class BuildingHandler : public JsonHandler {
+public:
+    JsonValue result;
+
+    bool on_null() override { return add(JsonValue(nullptr)); }
+    bool on_bool(bool value) override { return add(JsonValue(value)); }
+    bool on_number(double value) override { return add(JsonValue(value)); }
+    bool on_integer(int64_t value) override { return add(JsonValue(value)); }
+    bool on_string(std::string_view value) override { return add(JsonValue(std::string(value))); }
+    bool on_key(std::string_view key) override { keys_.emplace_back(key); return true; }
+    bool on_start_object() override { open_.emplace_back(JsonObject()); return true; }
+    bool on_start_array() override { open_.emplace_back(JsonArray()); return true; }
+    bool on_end_object() override { return close(); }
+    bool on_end_array() override { return close(); }
+
+private:
+    std::vector<JsonValue> open_;
+    std::vector<std::string> keys_;
+
+    bool add(JsonValue value) {
+        if (open_.empty()) {
+            result = std::move(value);
+        } else if (open_.back().is_array()) {
+            open_.back().push_back(std::move(value));
+        } else {
+            open_.back().insert(keys_.back(), std::move(value));
+            keys_.pop_back();
+        }
+        return true;
+    }
+
+    bool close() {
+        JsonValue value = std::move(open_.back());
+        open_.pop_back();
+        return add(std::move(value));
+    }
+};
+
+std::vector<std::string> events_for(const std::string& text, size_t buffer_size = 64) {
+    std::istringstream in(text);
+    JsonStreamReader reader(in, buffer_size);
+    RecordingHandler handler;
+    reader.parse(handler);
+    return handler.events;
+}
+
+} // anonymous namespace
+
+// Test to check that events arrive in document order
+TEST(JsonSaxTest, EmitsEventsInOrder) {
+    std::vector<std::string> expected = {"{", "k:a", "#1", "k:b", "[", "true", "null", "s:x", "{", "}", "[", "]",
+                                         "]", "k:c", "#-2.5", "}", "$"};
+    EXPECT_EQ(events_for(R"({"a": 1, "b": [true, null, "x", {}, []], "c": -2.5})"), expected);
+    EXPECT_EQ(events_for(" \"only\" "), (std::vector<std::string>{"s:only", "$"}));
+}
+
+// Test to check that tokens split across buffer refills read the same as unsplit ones
+TEST(JsonSaxTest, BufferSizeDoesNotChangeEvents) {
+    std::string text = R"({"long key with spaces": "a string long enough to cross several refills",
+        "escaped": "tab\there \"quoted\" \u00e9\ud83d\ude00", "numbers": [12345678, -0.000125, 6.02e23, 0],
+        "literals": [true, false, null], "nested": {"deeper": [[1], [2, {"x": "y"}]]}})";
+    std::vector<std::string> expected = events_for(text, 4096);
+    for (size_t buffer_size : {1u, 2u, 3u, 5u, 7u, 16u}) {
+        EXPECT_EQ(events_for(text, buffer_size), expected) << "buffer " << buffer_size;
+    }
+}
+
+// Test to check that rebuilding a value from events matches parse_json
+TEST(JsonSaxTest, MatchesParseJson) {
+    std::string text = R"({"name": "John", "age": 30, "scores": [1.5, -2, 3e2], "nested": {"ok": true,
+                          "none": null, "list": [[], {}, ["a\nb"]]}})";
+    std::istringstream in(text);
+    JsonStreamReader reader(in, 8);
+    BuildingHandler handler;
+    EXPECT_TRUE(reader.parse(handler));
+    EXPECT_EQ(handler.result.to_string(), parse_json(text).to_string());
+}
+
+// Test to check that integers beyond 2^53 reach on_integer exactly and fall back to on_number otherwise
+TEST(JsonSaxTest, ReportsExactIntegers) {
+    class IntegerHandler : public JsonHandler {
+    public:
+        std::vector<int64_t> integers;
+        std::vector<double> numbers;
+        bool on_integer(int64_t value) override { integers.push_back(value); return true; }
+        bool on_number(double value) override { numbers.push_back(value); return true; }
+    };
+    std::istringstream in("[9007199254740993, -0, 2.5, 9223372036854775808]");
+    JsonStreamReader reader(in, 3);
+    IntegerHandler handler;
+    EXPECT_TRUE(reader.parse(handler));
+    EXPECT_EQ(handler.integers, (std::vector<int64_t>{9007199254740993}));
+    EXPECT_EQ(handler.numbers.size(), 3u);
+
+    // Handlers without on_integer still see every number
+    EXPECT_EQ(events_for("[9007199254740993]"), (std::vector<std::string>{"[", "#9007199254740992", "]", "$"}));
+}
+
+// Test to check that newline-delimited records are read one after another
+TEST(JsonSaxTest, ReadsNdjson) {
+    std::istringstream in("{\"id\": 1}\n\n{\"id\": 2}  \r\n[3]\n\"four\"");
+    JsonStreamReader reader(in, 5);
+    RecordingHandler handler;
+    EXPECT_EQ(reader.parse_ndjson(handler), 4u);
+    std::vector<std::string> expected = {"{", "k:id", "#1", "}", "$", "{", "k:id", "#2", "}", "$",
+                                         "[", "#3", "]", "$", "s:four", "$"};
+    EXPECT_EQ(handler.events, expected);
+
+    std::istringstream two_on_a_line("{\"id\": 1} {\"id\": 2}\n");
+    JsonStreamReader strict(two_on_a_line);
+    EXPECT_THROW(strict.parse_ndjson(handler), std::runtime_error);
+}
+
+// Test to check that a handler can stop reading early
+TEST(JsonSaxTest, HandlerCanStop) {
+    class FindKey : public JsonHandler {
+    public:
+        bool found = false;
+        bool on_key(std::string_view key) override {
+            found = key == "target";
+            return !found;
+        }
+    };
+
+    std::istringstream in(R"({"a": 1, "target": 2, "b": 3})");
+    JsonStreamReader reader(in);
+    FindKey handler;
+    EXPECT_FALSE(reader.parse(handler));
+    EXPECT_TRUE(handler.found);
+    // Stopped right after the key
+    EXPECT_EQ(reader.offset(), 17u);
+}
+
+// Test to check that malformed input throws and reports where
+TEST(JsonSaxTest, RejectsMalformedInput) {
+    for (const char* text : {"", "{", "[1,]", "{\"a\" 1}", "{\"a\":1,}", "\"open", "tru", "-", "1e", "1.2.3",
+                             "[1] 2", "{1: 2}", "\"\\q\"", "\"\\u12g4\"", "[1 2]"}) {
+        std::istringstream in(text);
+        JsonStreamReader reader(in, 3);
+        RecordingHandler handler;
+        EXPECT_THROW(reader.parse(handler), std::runtime_error) << text;
+    }
+
+    std::istringstream in("[1, 2, x]");
+    JsonStreamReader reader(in);
+    RecordingHandler handler;
+    try {
+        reader.parse(handler);
+        FAIL() << "expected an exception";
+    } catch (const std::runtime_error& e) {
+        EXPECT_EQ(std::string(e.what()), "Unexpected character: x at byte 7");
+    }
+}
+
+// Test to check that nesting depth is limited only by memory, not the call stack
+TEST(JsonSaxTest, HandlesDeepNesting) {
+    const size_t depth = 200000;
+    std::istringstream in(std::string(depth, '[') + std::string(depth, ']'));
+    JsonStreamReader reader(in);
+    RecordingHandler handler;
+    EXPECT_TRUE(reader.parse(handler));
+    EXPECT_EQ(handler.events.size(), 2 * depth + 1);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -5,9 +5,14 @@
 
 #include "json.h"
 #include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <random>
+#include <sstream>
 #include <string>
+#include <variant>
 
 // Test fixture for Json tests
 class JsonTest : public ::testing::Test {
@@ -57,6 +62,46 @@ TEST_F(JsonTest, ParsesNumber) {
     EXPECT_DOUBLE_EQ(value.as_number(), 42.5);
 }
 
+// Test to check that integers are held exactly, including 64-bit IDs
+TEST_F(JsonTest, ParsesIntegersExactly) {
+    JsonValue value = parse_json("[505874924095815681, -9223372036854775808, 0, 7]");
+    EXPECT_TRUE(value[0].is_integer());
+    EXPECT_TRUE(value[0].is_number());
+    EXPECT_EQ(value[0].as_int64(), 505874924095815681);
+    EXPECT_EQ(value[1].as_int64(), INT64_MIN);
+    EXPECT_DOUBLE_EQ(value[3].as_number(), 7.0);
+    EXPECT_EQ(value.to_string(), "[505874924095815681,-9223372036854775808,0,7]");
+
+    // Fractions, exponents, -0 and out-of-range integers are doubles
+    JsonValue doubles = parse_json("[1.0, 1e2, -0, 9223372036854775808]");
+    for (const JsonValue& element : doubles.as_array()) {
+        EXPECT_FALSE(element.is_integer());
+        EXPECT_TRUE(element.is_number());
+    }
+    EXPECT_THROW(doubles[0].as_int64(), std::bad_variant_access);
+    EXPECT_EQ(doubles.to_string(), "[1,100,-0,9223372036854775808]");
+}
+
+// Test to check that doubles serialize to the shortest text that round-trips
+TEST_F(JsonTest, NumbersRoundTrip) {
+    EXPECT_EQ(JsonValue(0.1 + 0.2).to_string(), "0.30000000000000004");
+    EXPECT_EQ(JsonValue(1e300).to_string(), "1e+300");
+    EXPECT_EQ(JsonValue(-2.5).to_string(), "-2.5");
+
+    std::mt19937_64 rng(5);
+    for (int i = 0; i < 10000; ++i) {
+        uint64_t bits = rng();
+        double number;
+        std::memcpy(&number, &bits, sizeof(number));
+        if (!std::isfinite(number)) {
+            continue;
+        }
+        std::string text = JsonValue(number).to_string();
+        EXPECT_EQ(parse_json(text).as_number(), number) << text;
+    }
+    EXPECT_THROW(JsonValue(std::nan("")).to_string(), std::runtime_error);
+}
+
 // Test to check if JsonValue can parse a string
 TEST_F(JsonTest, ParsesString) {
     std::string json_str = "\"Hello, World!\"";
@@ -125,6 +170,55 @@ TEST_F(JsonTest, SerializesValue) {
     EXPECT_EQ(serialized, "\"Hello, World!\"");
 }
 
+// Test to check that write appends to the caller's buffer and streams the same text
+TEST_F(JsonTest, WritesIntoBufferAndStream) {
+    JsonValue value = parse_json(R"({"name": "a\"b\\c", "list": [1, 2.5, true, null, {}, []]})");
+    std::string out = "prefix:";
+    value.write(out);
+    EXPECT_EQ(out, "prefix:" + value.to_string());
+    EXPECT_EQ(value.to_string(), R"({"list":[1,2.5,true,null,{},[]],"name":"a\"b\\c"})");
+
+    // Large enough to pass through several staging flushes
+    JsonValue big = JsonArray();
+    for (int i = 0; i < 20000; ++i) {
+        big.push_back(JsonValue("item " + std::to_string(i)));
+    }
+    std::ostringstream stream;
+    big.write(stream);
+    EXPECT_EQ(stream.str(), big.to_string());
+}
+
+// Test to check that control characters are escaped and other bytes copied as-is
+TEST_F(JsonTest, EscapesControlCharacters) {
+    std::string text = std::string("tab\there\x01\x1f caf\xc3\xa9 \"q\" \\ /") + '\0';
+    EXPECT_EQ(JsonValue(text).to_string(), "\"tab\\there\\u0001\\u001f caf\xc3\xa9 \\\"q\\\" \\\\ /\\u0000\"");
+}
+
+// Test to check the pretty-printed layout
+TEST_F(JsonTest, PrettyPrints) {
+    JsonValue value = parse_json(R"({"b": [1, {"c": null}], "a": {}, "d": []})");
+    JsonWriteOptions options;
+    options.pretty = true;
+    std::string out;
+    value.write(out, options);
+    EXPECT_EQ(out, "{\n"
+                   "  \"a\": {},\n"
+                   "  \"b\": [\n"
+                   "    1,\n"
+                   "    {\n"
+                   "      \"c\": null\n"
+                   "    }\n"
+                   "  ],\n"
+                   "  \"d\": []\n"
+                   "}");
+    EXPECT_EQ(parse_json(out).to_string(), value.to_string());
+
+    options.indent = 0;
+    out.clear();
+    JsonValue(JsonArray{JsonValue(1)}).write(out, options);
+    EXPECT_EQ(out, "[\n1\n]");
+}
+
 // Test to check if JsonValue can handle escaped characters
 TEST_F(JsonTest, HandlesEscapedCharacters) {
     std::string json_str = "\"Hello\\nWorld\"";
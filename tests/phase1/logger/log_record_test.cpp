@@ -0,0 +1,73 @@
+#include "gtest/gtest.h"
+#include "log_record.h"
+#include <string>
+
+namespace {
+
+template <typename... Args>
+std::string formatArgs(const char* format, const Args&... args) {
+    LogRecord record;
+    encodeLogRecord(record, LogLevel::INFO, format, args...);
+    std::string out;
+    formatLogArgs(record, out);
+    return out;
+}
+
+} // anonymous namespace
+
+TEST(LogRecordTest, FormatsTypedArguments) {
+    ASSERT_EQ(formatArgs("{} {} {} {} {}", -42, 7u, 2.5, true, 'x'), "-42 7 2.5 true x");
+    ASSERT_EQ(formatArgs("min {} max {}", INT64_MIN, UINT64_MAX),
+              "min -9223372036854775808 max 18446744073709551615");
+    ASSERT_EQ(formatArgs("{}", static_cast<const void*>(reinterpret_cast<void*>(0xff))), "0xff");
+}
+
+TEST(LogRecordTest, CopiesStringArguments) {
+    std::string owned = "owned";
+    LogRecord record;
+    encodeLogRecord(record, LogLevel::INFO, "{} {} {}", owned, "literal", std::string_view("view"));
+    owned.assign("overwritten");
+
+    std::string out;
+    formatLogArgs(record, out);
+    ASSERT_EQ(out, "owned literal view");
+}
+
+TEST(LogRecordTest, BracesAndMissingArguments) {
+    ASSERT_EQ(formatArgs("{{}} {}", 1), "{} 1");
+    ASSERT_EQ(formatArgs("{} and {}", 1), "1 and {}");
+    ASSERT_EQ(formatArgs("no placeholders"), "no placeholders");
+    ASSERT_EQ(formatArgs("{}", std::string("{} in an argument")), "{} in an argument");
+}
+
+TEST(LogRecordTest, LongArgumentsSpillOutOfTheInlineBuffer) {
+    const std::string long_message(LOG_RECORD_INLINE_BYTES * 4, 'a');
+    LogRecord record;
+    encodeLogRecord(record, LogLevel::INFO, "[{}] {}", long_message, 1);
+    ASSERT_GT(record.size, LOG_RECORD_INLINE_BYTES);
+
+    std::string out;
+    formatLogArgs(record, out);
+    ASSERT_EQ(out, "[" + long_message + "] 1");
+
+    // Reusing the record for a short message goes back to the inline buffer
+    encodeLogRecord(record, LogLevel::INFO, "{}", 2);
+    out.clear();
+    formatLogArgs(record, out);
+    ASSERT_EQ(out, "2");
+}
+
+TEST(LogRecordTest, FormatterWritesTimestampLevelAndThread) {
+    LogRecord record;
+    encodeLogRecord(record, LogLevel::WARN, "disk {}% full", 93);
+    LogFormatter formatter;
+    std::string line;
+    formatter.format(record, line);
+
+    // "YYYY-mm-dd HH:MM:SS " prefix
+    ASSERT_GT(line.size(), 20u);
+    ASSERT_EQ(line[4], '-');
+    ASSERT_EQ(line[13], ':');
+    ASSERT_NE(line.find(" [WARN] [Thread "), std::string::npos);
+    ASSERT_EQ(line.substr(line.size() - 13), "disk 93% full");
+}
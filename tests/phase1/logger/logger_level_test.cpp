@@ -0,0 +1,81 @@
+// Built with LOGGER_MIN_LEVEL=2, so LOG_DEBUG and LOG_INFO are compiled out
+#include "gtest/gtest.h"
+#include "logger.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace {
+
+std::string readFile(const std::string& filename) {
+    std::ifstream file(filename);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+// Points the logger at a fresh file for the rest of the scope, so this
+// test process does not race others on app.log under ctest -j
+class ScopedLogFile {
+public:
+    explicit ScopedLogFile(const std::string& path) : m_path(path), m_defaults(Logger::getInstance().options()) {
+        std::remove(m_path.c_str());
+        LoggerOptions options = m_defaults;
+        options.path = m_path;
+        Logger::getInstance().configure(options);
+    }
+    ~ScopedLogFile() {
+        Logger::getInstance().configure(m_defaults);
+        std::remove(m_path.c_str());
+    }
+    ScopedLogFile(const ScopedLogFile&) = delete;
+    ScopedLogFile& operator=(const ScopedLogFile&) = delete;
+
+    std::string read() const { return readFile(m_path); }
+
+private:
+    std::string m_path;
+    LoggerOptions m_defaults;
+};
+
+int evaluated = 0;
+
+int countEvaluation() {
+    return ++evaluated;
+}
+
+} // anonymous namespace
+
+TEST(LoggerLevelTest, CompiledOutLevelsDoNotEvaluateArguments) {
+    static_assert(LOGGER_COMPILED_MIN_LEVEL == LogLevel::WARN);
+    ScopedLogFile log_file("logger_compiled_level_test.log");
+
+    evaluated = 0;
+    LOG_DEBUG("debug {}", countEvaluation());
+    LOG_INFO("info {}", countEvaluation());
+    LOG_WARN("warn {}", countEvaluation());
+    Logger::getInstance().flush();
+
+    ASSERT_EQ(evaluated, 1);
+    std::string log_content = log_file.read();
+    ASSERT_EQ(log_content.find("debug"), std::string::npos);
+    ASSERT_EQ(log_content.find("info"), std::string::npos);
+    ASSERT_NE(log_content.find("[WARN] [Thread "), std::string::npos);
+    ASSERT_NE(log_content.find("warn 1\n"), std::string::npos);
+}
+
+TEST(LoggerLevelTest, RuntimeMinimumLevelFiltersMacrosAndCalls) {
+    ScopedLogFile log_file("logger_runtime_level_test.log");
+
+    Logger& logger = Logger::getInstance();
+    logger.setMinLevel(LogLevel::ERROR);
+    evaluated = 0;
+    LOG_WARN("warn {}", countEvaluation());
+    logger.log(LogLevel::WARN, "plain warn");
+    LOG_ERROR("error {}", countEvaluation());
+    logger.flush();
+    logger.setMinLevel(LogLevel::DEBUG);
+
+    ASSERT_EQ(evaluated, 1);
+    std::string log_content = log_file.read();
+    ASSERT_EQ(log_content.find("warn"), std::string::npos);
+    ASSERT_NE(log_content.find("error 1\n"), std::string::npos);
+}
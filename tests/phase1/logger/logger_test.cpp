@@ -5,6 +5,7 @@
 #include <fstream>
 #include <string>
 #include <algorithm>
+#include <cstdio>
 
 // Helper function to read file content
 std::string readFile(const std::string& filename) {
@@ -15,10 +16,33 @@ std::string readFile(const std::string& filename) {
     return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 }
 
+// Points the logger at a fresh file for the rest of the scope. ctest runs
+// every test as its own process, so tests sharing app.log would clobber
+// each other under ctest -j.
+class ScopedLogFile {
+public:
+    explicit ScopedLogFile(const std::string& path) : m_path(path), m_defaults(Logger::getInstance().options()) {
+        std::remove(m_path.c_str());
+        LoggerOptions options = m_defaults;
+        options.path = m_path;
+        Logger::getInstance().configure(options);
+    }
+    ~ScopedLogFile() {
+        Logger::getInstance().configure(m_defaults);
+        std::remove(m_path.c_str());
+    }
+    ScopedLogFile(const ScopedLogFile&) = delete;
+    ScopedLogFile& operator=(const ScopedLogFile&) = delete;
+
+    std::string read() const { return readFile(m_path); }
+
+private:
+    std::string m_path;
+    LoggerOptions m_defaults;
+};
+
 TEST(LoggerTest, MultiThreadedLogging) {
-    // Ensure the log file is clean before the test
-    std::ofstream ofs("app.log", std::ios::out | std::ios::trunc);
-    ofs.close();
+    ScopedLogFile log_file("logger_multithreaded_test.log");
 
     Logger::getInstance().log(LogLevel::INFO, "Test started.");
 
@@ -48,7 +72,7 @@ TEST(LoggerTest, MultiThreadedLogging) {
     // Another delay to ensure "Test finished" is written.
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
-    std::string log_content = readFile("app.log");
+    std::string log_content = log_file.read();
 
     // Check that the start and end messages are there.
     ASSERT_NE(log_content.find("Test started."), std::string::npos);
@@ -62,3 +86,127 @@ TEST(LoggerTest, MultiThreadedLogging) {
         }
     }
 }
+
+TEST(LoggerTest, FlushWritesPendingMessages) {
+    ScopedLogFile log_file("logger_flush_test.log");
+
+    for (int i = 0; i < 1000; ++i) {
+        Logger::getInstance().log(LogLevel::DEBUG, "Flushed message " + std::to_string(i) + ".");
+    }
+    Logger::getInstance().flush();
+
+    std::string log_content = log_file.read();
+    ASSERT_NE(log_content.find("Flushed message 0."), std::string::npos);
+    ASSERT_NE(log_content.find("Flushed message 999."), std::string::npos);
+    ASSERT_LT(log_content.find("Flushed message 0."), log_content.find("Flushed message 999."));
+}
+
+TEST(LoggerTest, DropPolicyAccountsForEveryMessage) {
+    ScopedLogFile log_file("logger_drop_test.log");
+
+    Logger& logger = Logger::getInstance();
+    logger.flush();
+    logger.setOverflowPolicy(OverflowPolicy::DROP);
+    const uint64_t dropped_before = logger.droppedCount();
+
+    // Flood the ring from several threads; whatever does not fit is dropped
+    const int threads_count = 4;
+    const int per_thread = 2 * static_cast<int>(LOGGER_RING_CAPACITY);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; ++t) {
+        threads.emplace_back([&logger] {
+            for (int i = 0; i < per_thread; ++i) {
+                logger.log(LogLevel::INFO, "flood");
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    logger.flush();
+    logger.setOverflowPolicy(OverflowPolicy::BLOCK);
+
+    std::string log_content = log_file.read();
+    uint64_t written = std::count(log_content.begin(), log_content.end(), '\n');
+    uint64_t dropped = logger.droppedCount() - dropped_before;
+    ASSERT_EQ(written + dropped, static_cast<uint64_t>(threads_count * per_thread));
+}
+
+TEST(LoggerTest, LogFormatWritesTypedArguments) {
+    ScopedLogFile log_file("logger_format_test.log");
+
+    std::string user = "alice";
+    Logger::getInstance().logFormat(LogLevel::INFO, "user {} logged in after {} attempts ({} s)", user, 3, 1.5);
+    user.assign("changed before the worker ran");
+    Logger::getInstance().flush();
+
+    std::string log_content = log_file.read();
+    ASSERT_NE(log_content.find("[INFO] [Thread "), std::string::npos);
+    ASSERT_NE(log_content.find("user alice logged in after 3 attempts (1.5 s)\n"), std::string::npos);
+}
+
+TEST(LoggerTest, RotatesBySizeAtLineBoundaries) {
+    const std::string path = "logger_rotation_test.log";
+    for (const std::string& name : {path, path + ".1", path + ".2", path + ".3"}) {
+        std::remove(name.c_str());
+    }
+
+    Logger& logger = Logger::getInstance();
+    const LoggerOptions defaults = logger.options();
+    LoggerOptions options;
+    options.path = path;
+    options.rotateBytes = 4096;
+    options.maxFiles = 2;
+    logger.configure(options);
+
+    for (int i = 0; i < 200; ++i) {
+        logger.logFormat(LogLevel::INFO, "rotation message {}", i);
+    }
+    logger.configure(defaults);
+
+    // 200 lines of ~70 bytes need more than three files; only two rotated
+    // ones are kept, and every kept file holds whole lines within the limit
+    std::string current = readFile(path);
+    std::string first = readFile(path + ".1");
+    std::string second = readFile(path + ".2");
+    ASSERT_FALSE(first.empty());
+    ASSERT_FALSE(second.empty());
+    ASSERT_TRUE(readFile(path + ".3").empty());
+    for (const std::string* content : {&current, &first, &second}) {
+        ASSERT_LE(content->size(), options.rotateBytes);
+        if (!content->empty()) {
+            ASSERT_EQ(content->back(), '\n');
+        }
+    }
+    ASSERT_NE(current.find("rotation message 199\n"), std::string::npos);
+}
+
+TEST(LoggerTest, BurstIsWrittenInBatches) {
+    Logger& logger = Logger::getInstance();
+    logger.flush();
+    const uint64_t writes_before = logger.writeCount();
+    for (int i = 0; i < 2000; ++i) {
+        logger.logFormat(LogLevel::INFO, "burst message {}", i);
+    }
+    logger.flush();
+    ASSERT_LT(logger.writeCount() - writes_before, 200u);
+}
+
+TEST(LoggerTest, MessagesFromExitedThreadsAreWritten) {
+    ScopedLogFile log_file("logger_exited_threads_test.log");
+
+    // Each short-lived thread gets its own staging buffer, which the worker
+    // drains and then frees after the thread has gone
+    for (int round = 0; round < 20; ++round) {
+        std::thread([round] {
+            LOG_INFO("short-lived thread {} says bye", round);
+        }).join();
+    }
+    Logger::getInstance().flush();
+
+    std::string log_content = log_file.read();
+    for (int round = 0; round < 20; ++round) {
+        std::string expected = "short-lived thread " + std::to_string(round) + " says bye\n";
+        ASSERT_NE(log_content.find(expected), std::string::npos);
+    }
+}
@@ -0,0 +1,60 @@
+#include "gtest/gtest.h"
+#include "spsc_ring.h"
+#include <cstdint>
+#include <string>
+#include <thread>
+
+TEST(SpscRingTest, RoundsCapacityUpToPowerOfTwo) {
+    SpscRing<int> ring(100);
+    ASSERT_EQ(ring.capacity(), 128u);
+}
+
+TEST(SpscRingTest, FullRingRejectsEmplaceUntilConsumed) {
+    SpscRing<std::string> ring(4);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.tryEmplace([i](std::string& slot) { slot = "message " + std::to_string(i); }));
+    }
+    bool called = false;
+    ASSERT_FALSE(ring.tryEmplace([&called](std::string&) { called = true; }));
+    ASSERT_FALSE(called);
+
+    std::string value;
+    ASSERT_TRUE(ring.tryConsume([&value](std::string& slot) { value = slot; }));
+    ASSERT_EQ(value, "message 0");
+    ASSERT_TRUE(ring.tryEmplace([](std::string& slot) { slot = "message 4"; }));
+
+    for (int i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(ring.tryConsume([&value](std::string& slot) { value = slot; }));
+        ASSERT_EQ(value, "message " + std::to_string(i));
+    }
+    ASSERT_TRUE(ring.empty());
+    ASSERT_FALSE(ring.tryConsume([](std::string&) {}));
+    ASSERT_EQ(ring.pushed(), 5u);
+    ASSERT_EQ(ring.popped(), 5u);
+}
+
+TEST(SpscRingTest, ConsumerSeesEveryValueInOrder) {
+    SpscRing<uint64_t> ring(64);
+    const uint64_t total = 200000;
+
+    std::thread producer([&ring] {
+        for (uint64_t i = 0; i < total; ++i) {
+            while (!ring.tryEmplace([i](uint64_t& slot) { slot = i; })) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0;
+    while (expected < total) {
+        bool consumed = ring.tryConsume([&expected](uint64_t value) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        });
+        if (!consumed) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    ASSERT_TRUE(ring.empty());
+}
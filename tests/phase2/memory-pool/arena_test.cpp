@@ -0,0 +1,149 @@
+/**
+ * @file arena_test.cpp
+ * @brief Unit tests for the bump-pointer arena and the std::pmr adapters using Google Test.
+ */
+
+#include "arena.h"
+#include "pmr_resources.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using memory_pool::Arena;
+
+// Test that blocks honour the requested alignment and do not overlap
+TEST(ArenaTest, AllocatesAlignedNonOverlappingBlocks) {
+    Arena arena(1024);
+    EXPECT_EQ(arena.GetNumChunks(), 0u);
+
+    char* previous_end = nullptr;
+    for (size_t alignment : {1, 2, 8, 16, 64, 256}) {
+        auto* block = static_cast<char*>(arena.Allocate(24, alignment));
+        ASSERT_NE(block, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % alignment, 0u);
+        if (previous_end) {
+            EXPECT_GE(block, previous_end);
+        }
+        std::memset(block, 0xab, 24);
+        previous_end = block + 24;
+    }
+    EXPECT_EQ(arena.GetNumChunks(), 1u);
+    EXPECT_EQ(arena.Allocate(0), nullptr);
+}
+
+// Test that full chunks chain to new, growing ones, including oversized requests
+TEST(ArenaTest, ChainsChunksWhenFull) {
+    Arena arena(1024);
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_NE(arena.Allocate(100), nullptr);
+    }
+    EXPECT_GT(arena.GetNumChunks(), 1u);
+    EXPECT_GE(arena.GetCapacity(), 6400u);
+
+    size_t chunks = arena.GetNumChunks();
+    auto* big = static_cast<char*>(arena.Allocate(1 << 20));
+    ASSERT_NE(big, nullptr);
+    std::memset(big, 0, 1 << 20);
+    EXPECT_EQ(arena.GetNumChunks(), chunks + 1);
+}
+
+// Test that rewinding to a marker hands the same memory out again
+TEST(ArenaTest, RewindsToMarker) {
+    Arena arena(1024);
+    void* kept = arena.Allocate(64);
+    Arena::Marker marker = arena.GetMarker();
+
+    void* first = arena.Allocate(64);
+    for (int i = 0; i < 50; ++i) {
+        arena.Allocate(100);  // spills into further chunks
+    }
+    size_t chunks = arena.GetNumChunks();
+
+    arena.Rewind(marker);
+    EXPECT_EQ(arena.Allocate(64), first);
+    EXPECT_NE(arena.Allocate(64), kept);
+
+    // The chunks after the marker are reused, not allocated again
+    for (int i = 0; i < 49; ++i) {
+        arena.Allocate(100);
+    }
+    EXPECT_EQ(arena.GetNumChunks(), chunks);
+}
+
+// Test that Reset() reuses every chunk and Release() frees them
+TEST(ArenaTest, ResetReusesChunksAndReleaseFreesThem) {
+    Arena arena(4096);
+    std::vector<void*> round1;
+    for (int i = 0; i < 200; ++i) {
+        round1.push_back(arena.Allocate(48));
+    }
+    size_t chunks = arena.GetNumChunks();
+    size_t capacity = arena.GetCapacity();
+
+    for (int round = 0; round < 3; ++round) {
+        arena.Reset();
+        for (int i = 0; i < 200; ++i) {
+            ASSERT_EQ(arena.Allocate(48), round1[i]);
+        }
+    }
+    EXPECT_EQ(arena.GetNumChunks(), chunks);
+    EXPECT_EQ(arena.GetCapacity(), capacity);
+
+    arena.Release();
+    EXPECT_EQ(arena.GetNumChunks(), 0u);
+    EXPECT_EQ(arena.GetCapacity(), 0u);
+    EXPECT_NE(arena.Allocate(48), nullptr);
+}
+
+// Test pmr containers on an arena
+TEST(ArenaTest, BacksPmrContainers) {
+    Arena arena;
+    memory_pool::ArenaResource resource(arena);
+    {
+        std::pmr::vector<std::pmr::string> words(&resource);
+        for (int i = 0; i < 1000; ++i) {
+            words.emplace_back("a string long enough to skip the small-string buffer " + std::to_string(i));
+        }
+        EXPECT_EQ(words[999].get_allocator().resource(), &resource);
+        EXPECT_EQ(words[999], "a string long enough to skip the small-string buffer 999");
+    }
+    EXPECT_GE(arena.GetCapacity(), 1000u * 56);
+    EXPECT_TRUE(resource.is_equal(resource));
+    arena.Reset();
+}
+
+// Test the MemoryPool and FixedBlockAllocator adapters, including the upstream fallback
+TEST(ArenaTest, PoolAdaptersFallBackUpstream) {
+    memory_pool::MemoryPool pool(1 << 16);
+    memory_pool::MemoryPoolResource pool_resource(pool);
+    {
+        std::pmr::vector<int> values(&pool_resource);
+        for (int i = 0; i < 1000; ++i) {
+            values.push_back(i);
+        }
+        EXPECT_TRUE(pool.Owns(values.data()));
+        EXPECT_GT(pool.GetUsedSize(), 0u);
+
+        // Too big for the pool: served upstream and freed there
+        std::pmr::vector<char> huge(1 << 17, 'x', &pool_resource);
+        EXPECT_FALSE(pool.Owns(huge.data()));
+    }
+    EXPECT_EQ(pool.GetUsedSize(), 0u);
+
+    memory_pool::FixedBlockAllocator allocator(64, 8);
+    memory_pool::FixedBlockResource block_resource(allocator);
+    {
+        std::pmr::list<int> nodes(&block_resource);
+        for (int i = 0; i < 16; ++i) {
+            nodes.push_back(i);
+        }
+        // The first eight nodes fill the allocator, the rest go upstream
+        EXPECT_EQ(allocator.GetNumFreeBlocks(), 0u);
+        EXPECT_EQ(nodes.size(), 16u);
+    }
+    EXPECT_EQ(allocator.GetNumFreeBlocks(), 8u);
+}
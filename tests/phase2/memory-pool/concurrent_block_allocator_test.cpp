@@ -0,0 +1,129 @@
+/**
+ * @file concurrent_block_allocator_test.cpp
+ * @brief Unit tests for the thread-caching block allocator using Google Test.
+ */
+
+#include "concurrent_block_allocator.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+using memory_pool::ConcurrentBlockAllocator;
+
+// Test that every block can be handed out exactly once
+TEST(ConcurrentBlockAllocatorTest, HandsOutEveryBlockOnce) {
+    const size_t block_size = 48;
+    const size_t num_blocks = 300;
+    ConcurrentBlockAllocator allocator(block_size, num_blocks);
+
+    std::set<void*> blocks;
+    for (size_t i = 0; i < num_blocks; ++i) {
+        void* block = allocator.Allocate();
+        ASSERT_NE(block, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % alignof(std::max_align_t), 0u);
+        blocks.insert(block);
+    }
+    EXPECT_EQ(blocks.size(), num_blocks);
+    EXPECT_EQ(allocator.Allocate(), nullptr);
+    EXPECT_EQ(allocator.GetNumDepotBlocks(), 0u);
+
+    // Freed blocks are reused, and freeing foreign pointers is ignored
+    int not_ours = 0;
+    allocator.Deallocate(&not_ours);
+    allocator.Deallocate(nullptr);
+    for (void* block : blocks) {
+        allocator.Deallocate(block);
+    }
+    for (size_t i = 0; i < num_blocks; ++i) {
+        EXPECT_EQ(blocks.count(allocator.Allocate()), 1u);
+    }
+}
+
+// Test that magazines go back to the depot when a thread exits
+TEST(ConcurrentBlockAllocatorTest, ExitingThreadReturnsItsMagazines) {
+    const size_t num_blocks = 4 * ConcurrentBlockAllocator::kMagazineSize;
+    ConcurrentBlockAllocator allocator(32, num_blocks);
+
+    std::thread([&allocator] {
+        std::vector<void*> blocks;
+        for (size_t i = 0; i < num_blocks; ++i) {
+            blocks.push_back(allocator.Allocate());
+        }
+        for (void* block : blocks) {
+            allocator.Deallocate(block);
+        }
+    }).join();
+
+    EXPECT_EQ(allocator.GetNumDepotBlocks(), num_blocks);
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < num_blocks; ++i) {
+        void* block = allocator.Allocate();
+        ASSERT_NE(block, nullptr);
+        blocks.push_back(block);
+    }
+    EXPECT_EQ(allocator.Allocate(), nullptr);
+}
+
+// Test concurrent allocation with blocks freed by other threads
+TEST(ConcurrentBlockAllocatorTest, ConcurrentAllocateAndCrossThreadFree) {
+    const int num_threads = 4;
+    const size_t per_thread = 2000;
+    // Headroom for the magazines each thread may keep cached
+    ConcurrentBlockAllocator allocator(64, num_threads * (per_thread + 4 * ConcurrentBlockAllocator::kMagazineSize));
+
+    std::vector<std::vector<void*>> allocated(num_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&allocator, &allocated, t] {
+            for (size_t i = 0; i < per_thread; ++i) {
+                void* block = allocator.Allocate();
+                ASSERT_NE(block, nullptr);
+                *static_cast<uint64_t*>(block) = (static_cast<uint64_t>(t) << 32) | i;
+                allocated[t].push_back(block);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // No block was handed to two owners
+    std::set<void*> unique;
+    for (int t = 0; t < num_threads; ++t) {
+        for (size_t i = 0; i < per_thread; ++i) {
+            void* block = allocated[t][i];
+            EXPECT_EQ(*static_cast<uint64_t*>(block), (static_cast<uint64_t>(t) << 32) | i);
+            unique.insert(block);
+        }
+    }
+    EXPECT_EQ(unique.size(), num_threads * per_thread);
+
+    // Each thread frees another thread's blocks
+    threads.clear();
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&allocator, &allocated, t] {
+            for (void* block : allocated[(t + 1) % num_threads]) {
+                allocator.Deallocate(block);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(allocator.GetNumDepotBlocks(), allocator.GetNumBlocks());
+}
+
+// Test that a thread can outlive an allocator it used, and use a new one
+TEST(ConcurrentBlockAllocatorTest, ThreadOutlivesAllocator) {
+    auto first = std::make_unique<ConcurrentBlockAllocator>(64, 100);
+    void* block = first->Allocate();
+    ASSERT_NE(block, nullptr);
+    first->Deallocate(block);
+    first.reset();
+
+    ConcurrentBlockAllocator second(64, 100);
+    EXPECT_NE(second.Allocate(), nullptr);
+}
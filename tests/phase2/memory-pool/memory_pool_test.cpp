@@ -10,6 +10,8 @@
 #include <vector>
 #include <thread>
 #include <chrono>
+#include <cstring>
+#include <algorithm>
 
 // Test fixture for FixedBlockAllocator tests
 class FixedBlockAllocatorTest : public ::testing::Test {
@@ -128,6 +130,83 @@ TEST_F(FixedBlockAllocatorTest, HandlesInvalidDeallocations) {
     EXPECT_NO_THROW(allocator.Deallocate(block));
 }
 
+// Test that double frees are detected when the bitmap is enabled
+TEST_F(FixedBlockAllocatorTest, DetectsDoubleFreeWithBitmap) {
+    memory_pool::FixedBlockAllocator allocator(64, 10, /*check_double_free=*/true);
+    ASSERT_TRUE(allocator.ChecksDoubleFree());
+
+    void* block = allocator.Allocate();
+    void* other = allocator.Allocate();
+    ASSERT_NE(block, nullptr);
+    ASSERT_NE(other, nullptr);
+
+    allocator.Deallocate(block);
+    allocator.Deallocate(block);
+    EXPECT_EQ(allocator.GetNumFreeBlocks(), 9u);
+
+    // The block is handed out only once more
+    EXPECT_EQ(allocator.Allocate(), block);
+    EXPECT_EQ(allocator.GetNumFreeBlocks(), 8u);
+    allocator.Deallocate(other);
+    allocator.Deallocate(block);
+    EXPECT_EQ(allocator.GetNumFreeBlocks(), 10u);
+}
+
+// Test the intrusive free list: LIFO reuse, and blocks smaller than a pointer
+TEST_F(FixedBlockAllocatorTest, ReusesFreedBlocksLastInFirstOut) {
+    memory_pool::FixedBlockAllocator allocator(4, 8, /*check_double_free=*/false);
+    EXPECT_FALSE(allocator.ChecksDoubleFree());
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; ++i) {
+        blocks.push_back(allocator.Allocate());
+        ASSERT_NE(blocks.back(), nullptr);
+        *static_cast<int*>(blocks.back()) = i;
+    }
+    EXPECT_EQ(allocator.Allocate(), nullptr);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(*static_cast<int*>(blocks[i]), i);
+    }
+
+    allocator.Deallocate(blocks[2]);
+    allocator.Deallocate(blocks[5]);
+    EXPECT_EQ(allocator.Allocate(), blocks[5]);
+    EXPECT_EQ(allocator.Allocate(), blocks[2]);
+    EXPECT_EQ(allocator.Allocate(), nullptr);
+}
+
+// Test that block sizes which are not a power of two work
+TEST_F(FixedBlockAllocatorTest, SupportsNonPowerOfTwoBlockSizes) {
+    for (size_t block_size : {12, 20, 24, 40, 48, 100}) {
+        memory_pool::FixedBlockAllocator allocator(block_size, 10, false);
+        // Blocks are spaced so that the free-list link is pointer-aligned
+        size_t expected_alignment = std::max<size_t>(
+            std::min<size_t>(block_size & (~block_size + 1), alignof(std::max_align_t)), alignof(void*));
+        EXPECT_EQ(allocator.GetBlockAlignment() % expected_alignment, 0u);
+        std::vector<void*> blocks;
+        for (size_t i = 0; i < 10; ++i) {
+            void* block = allocator.Allocate();
+            ASSERT_NE(block, nullptr);
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % allocator.GetBlockAlignment(), 0u);
+            std::memset(block, 0xab, block_size);
+            blocks.push_back(block);
+        }
+        EXPECT_EQ(allocator.Allocate(), nullptr);
+
+        // Freed blocks go through the intrusive free list and come back intact
+        for (void* block : blocks) {
+            allocator.Deallocate(block);
+        }
+        EXPECT_EQ(allocator.GetNumFreeBlocks(), 10u);
+        for (size_t i = 0; i < 10; ++i) {
+            void* block = allocator.Allocate();
+            ASSERT_NE(block, nullptr);
+            EXPECT_NE(std::find(blocks.begin(), blocks.end(), block), blocks.end());
+        }
+        EXPECT_EQ(allocator.Allocate(), nullptr);
+    }
+}
+
 // Test fixture for MemoryPool tests
 class MemoryPoolTest : public ::testing::Test {
 protected:
@@ -242,4 +321,117 @@ TEST_F(MemoryPoolTest, CanCoalesceBlocks) {
 
     // Clean up
     pool.Deallocate(large_block, 400);
-}
\ No newline at end of file
+}
+
+// Test that small requests are packed into shared size-class slabs
+TEST_F(MemoryPoolTest, PacksSmallBlocksIntoSlabs) {
+    memory_pool::MemoryPool pool(1 << 20);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 100; ++i) {
+        blocks.push_back(pool.Allocate(24));
+        ASSERT_NE(blocks.back(), nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(blocks.back()) % 16, 0u);
+    }
+    EXPECT_EQ(pool.GetNumSlabs(), 1u);
+    EXPECT_EQ(pool.GetUsedSize(), 2400u);
+
+    // Sizes in another class get their own slab
+    void* other = pool.Allocate(300);
+    ASSERT_NE(other, nullptr);
+    EXPECT_EQ(pool.GetNumSlabs(), 2u);
+
+    pool.Deallocate(other, 300);
+    for (void* block : blocks) {
+        pool.Deallocate(block, 24);
+    }
+    EXPECT_EQ(pool.GetUsedSize(), 0u);
+}
+
+// Test that a cached empty slab is released when another slab of its class
+// rejoins the partial list, so a large request can still reclaim it
+TEST_F(MemoryPoolTest, ReleasesEmptySlabBehindPartialSlab) {
+    memory_pool::MemoryPool pool(2 * 8208 + 16);
+
+    // Fifteen 512-byte blocks fill the first slab; the sixteenth opens a second
+    std::vector<void*> blocks;
+    for (int i = 0; i < 16; ++i) {
+        blocks.push_back(pool.Allocate(512));
+        ASSERT_NE(blocks.back(), nullptr);
+    }
+    EXPECT_EQ(pool.GetNumSlabs(), 2u);
+
+    // The second slab empties and is cached, then the full one becomes partial
+    pool.Deallocate(blocks[15], 512);
+    pool.Deallocate(blocks[0], 512);
+    EXPECT_EQ(pool.GetNumSlabs(), 1u);
+
+    void* large = pool.Allocate(8000);
+    EXPECT_NE(large, nullptr);
+    pool.Deallocate(large, 8000);
+    EXPECT_GE(pool.GetLargestFreeBlock(), 8000u);
+
+    for (int i = 1; i < 15; ++i) {
+        pool.Deallocate(blocks[i], 512);
+    }
+    EXPECT_EQ(pool.GetUsedSize(), 0u);
+}
+
+// Stress test: random mixed-size allocations and frees must never overlap,
+// and once everything is freed the pool must coalesce back into one block
+TEST_F(MemoryPoolTest, StressRandomAllocationsCoalesceFully) {
+    const size_t pool_size = 1 << 20;
+    memory_pool::MemoryPool pool(pool_size);
+
+    struct Live {
+        unsigned char* ptr;
+        size_t size;
+        unsigned char fill;
+    };
+    std::vector<Live> live;
+    size_t used = 0;
+    uint32_t seed = 12345;
+    auto next_random = [&seed] {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+
+    for (int op = 0; op < 50000; ++op) {
+        if (live.empty() || next_random() % 100 < 55) {
+            // Mostly small sizes, with a tail of large ones
+            size_t size = next_random() % 8 == 0 ? 513 + next_random() % 8192 : 1 + next_random() % 512;
+            auto* ptr = static_cast<unsigned char*>(pool.Allocate(size));
+            if (!ptr) {
+                continue;
+            }
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % 16, 0u);
+            unsigned char fill = static_cast<unsigned char>(op);
+            std::memset(ptr, fill, size);
+            live.push_back({ptr, size, fill});
+            used += size;
+        } else {
+            size_t index = next_random() % live.size();
+            Live block = live[index];
+            live[index] = live.back();
+            live.pop_back();
+            for (size_t i = 0; i < block.size; ++i) {
+                ASSERT_EQ(block.ptr[i], block.fill) << "block of " << block.size << " bytes was overwritten";
+            }
+            pool.Deallocate(block.ptr, block.size);
+            used -= block.size;
+        }
+        ASSERT_EQ(pool.GetUsedSize(), used);
+    }
+
+    for (const Live& block : live) {
+        pool.Deallocate(block.ptr, block.size);
+    }
+    EXPECT_EQ(pool.GetUsedSize(), 0u);
+
+    // Only cached empty slabs may remain, and they give way to a large request
+    void* whole = pool.Allocate(pool_size - 64);
+    EXPECT_NE(whole, nullptr);
+    EXPECT_EQ(pool.GetNumSlabs(), 0u);
+    pool.Deallocate(whole, pool_size - 64);
+    EXPECT_EQ(pool.GetLargestFreeBlock(), pool_size - 32);
+}
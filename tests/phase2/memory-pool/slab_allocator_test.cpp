@@ -0,0 +1,105 @@
+/**
+ * @file slab_allocator_test.cpp
+ * @brief Unit tests for the growable slab allocator using Google Test.
+ */
+
+#include "slab_allocator.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using memory_pool::SlabAllocator;
+using memory_pool::SlabStats;
+
+// Test that arbitrary block sizes get correctly aligned, distinct blocks
+TEST(SlabAllocatorTest, AlignsArbitraryBlockSizes) {
+    for (size_t block_size : {1, 24, 40, 100, 1000, 5000}) {
+        for (size_t alignment : {8, 16, 64}) {
+            SlabAllocator allocator(block_size, alignment);
+            EXPECT_GE(allocator.GetStride(), block_size);
+            EXPECT_EQ(allocator.GetStride() % alignment, 0u);
+            EXPECT_GE(allocator.GetBlocksPerSlab(), 8u);
+
+            std::set<void*> blocks;
+            for (size_t i = 0; i < 2 * allocator.GetBlocksPerSlab() + 1; ++i) {
+                void* block = allocator.Allocate();
+                ASSERT_NE(block, nullptr);
+                EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % alignment, 0u);
+                std::memset(block, 0xab, block_size);
+                blocks.insert(block);
+            }
+            EXPECT_EQ(blocks.size(), 2 * allocator.GetBlocksPerSlab() + 1);
+            EXPECT_EQ(allocator.GetStats().chunk_count, 3u);
+        }
+    }
+    EXPECT_THROW(SlabAllocator(64, 24), std::invalid_argument);
+}
+
+// Test growth, hysteresis on empty slabs and the high-water marks
+TEST(SlabAllocatorTest, GrowsAndReturnsEmptySlabsAfterThreshold) {
+    SlabAllocator allocator(64, 16, 4096, /*max_empty_slabs=*/2);
+    const size_t per_slab = allocator.GetBlocksPerSlab();
+    EXPECT_EQ(allocator.GetStats().chunk_count, 0u);
+
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < 5 * per_slab; ++i) {
+        blocks.push_back(allocator.Allocate());
+    }
+    SlabStats stats = allocator.GetStats();
+    EXPECT_EQ(stats.chunk_count, 5u);
+    EXPECT_EQ(stats.blocks_in_use, 5 * per_slab);
+    EXPECT_EQ(stats.block_capacity, 5 * per_slab);
+    EXPECT_EQ(stats.high_water_blocks, 5 * per_slab);
+
+    for (void* block : blocks) {
+        allocator.Deallocate(block);
+    }
+    stats = allocator.GetStats();
+    EXPECT_EQ(stats.blocks_in_use, 0u);
+    EXPECT_EQ(stats.chunk_count, 2u);
+    EXPECT_EQ(stats.empty_chunks, 2u);
+    EXPECT_EQ(stats.high_water_blocks, 5 * per_slab);
+    EXPECT_EQ(stats.high_water_chunks, 5u);
+    EXPECT_DOUBLE_EQ(stats.fragmentation, 1.0);
+
+    // Cached slabs are reused before anything new is mapped
+    for (size_t i = 0; i < 2 * per_slab; ++i) {
+        blocks[i] = allocator.Allocate();
+    }
+    stats = allocator.GetStats();
+    EXPECT_EQ(stats.chunk_count, 2u);
+    EXPECT_EQ(stats.empty_chunks, 0u);
+    EXPECT_LT(stats.fragmentation, 1.0);
+
+    for (size_t i = 0; i < 2 * per_slab; ++i) {
+        allocator.Deallocate(blocks[i]);
+    }
+    allocator.ReleaseEmptySlabs();
+    EXPECT_EQ(allocator.GetStats().chunk_count, 0u);
+}
+
+// Test that freed blocks are reused and partially used slabs are filled first
+TEST(SlabAllocatorTest, PrefersPartiallyUsedSlabs) {
+    SlabAllocator allocator(32, 16, 4096, 0);
+    const size_t per_slab = allocator.GetBlocksPerSlab();
+
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < 2 * per_slab; ++i) {
+        blocks.push_back(allocator.Allocate());
+    }
+    // Free one block in each slab, then allocate two: no new slab is needed
+    allocator.Deallocate(blocks[0]);
+    allocator.Deallocate(blocks[per_slab]);
+    std::set<void*> reused = {allocator.Allocate(), allocator.Allocate()};
+    EXPECT_EQ(reused, (std::set<void*>{blocks[0], blocks[per_slab]}));
+    EXPECT_EQ(allocator.GetStats().chunk_count, 2u);
+
+    // With no empty slabs cached, emptying a slab unmaps it immediately
+    for (size_t i = 0; i < per_slab; ++i) {
+        allocator.Deallocate(blocks[i]);
+    }
+    EXPECT_EQ(allocator.GetStats().chunk_count, 1u);
+}